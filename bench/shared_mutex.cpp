@@ -0,0 +1,140 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/shared_mutex.hpp>
+
+#if __cplusplus >= 201703L
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/coroutine.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/yield.hpp>
+#else
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/yield.hpp>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+using namespace BOOST_SAM_NAMESPACE;
+
+using mutex_type = basic_shared_mutex<net::io_context::executor_type>;
+
+struct stats
+{
+  bool                     done = false;
+  std::size_t              reads = 0u, writes = 0u;
+  std::chrono::nanoseconds total_latency{0}, max_latency{0};
+};
+
+// a reader holds the lock across a round trip through the scheduler, so readers overlap.
+struct reader : net::coroutine
+{
+  mutex_type &mtx;
+  stats      &st;
+
+  void operator()(error_code ec = {})
+  {
+    reenter(this)
+    {
+      while (!st.done)
+      {
+        yield mtx.async_lock_shared(std::move(*this));
+        yield net::post(mtx.get_executor(), std::move(*this));
+        mtx.unlock_shared();
+        st.reads++;
+      }
+    }
+  }
+};
+
+// a writer measures how long it takes to get the lock.
+struct writer : net::coroutine
+{
+  mutex_type                           &mtx;
+  stats                                &st;
+  std::chrono::steady_clock::time_point requested;
+
+  void operator()(error_code ec = {})
+  {
+    reenter(this)
+    {
+      while (!st.done)
+      {
+        requested = std::chrono::steady_clock::now();
+        yield mtx.async_lock(std::move(*this));
+        {
+          const auto latency = std::chrono::steady_clock::now() - requested;
+          st.total_latency += latency;
+          st.max_latency = (std::max)(st.max_latency, std::chrono::duration_cast<std::chrono::nanoseconds>(latency));
+          st.writes++;
+        }
+        yield net::post(mtx.get_executor(), std::move(*this));
+        mtx.unlock();
+        yield net::post(mtx.get_executor(), std::move(*this));
+      }
+    }
+  }
+};
+
+void run_benchmark(const char *name, shared_mutex_policy policy, std::size_t readers,
+                   std::chrono::milliseconds duration)
+{
+  net::io_context ctx{1};
+  mutex_type      mtx{ctx.get_executor(), policy};
+  stats           st;
+
+  for (std::size_t i = 0u; i < readers; i++)
+    net::post(ctx, reader{{}, mtx, st});
+  net::post(ctx, writer{{}, mtx, st, {}});
+
+  net::steady_timer tim{ctx, duration};
+  tim.async_wait([&](error_code) { st.done = true; });
+  ctx.run();
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  printf("Benchmark  %-18s: %8ld reads/ms, %6zu writes, writer latency avg %8ld us, max %8ld us\n", name,
+         static_cast<long>(st.reads / static_cast<std::size_t>(duration.count())), st.writes,
+         static_cast<long>(st.writes == 0u ? 0 : duration_cast<microseconds>(st.total_latency).count() /
+                                                     static_cast<long>(st.writes)),
+         static_cast<long>(duration_cast<microseconds>(st.max_latency).count()));
+}
+
+int main(int argc, char *argv[])
+{
+  const std::chrono::milliseconds duration{500};
+  const std::size_t               readers = 16u;
+
+  run_benchmark("reader_preferring", shared_mutex_policy::reader_preferring, readers, duration);
+  run_benchmark("writer_preferring", shared_mutex_policy::writer_preferring, readers, duration);
+  run_benchmark("phase_fair", shared_mutex_policy::phase_fair, readers, duration);
+  return 0;
+}
+
+#else
+
+#include <cstdio>
+
+int main(int argc, char * argv[])
+{
+  std::fprintf(stderr, "Shared mutex benchmark needs C++17\n");
+  return 1;
+}
+
+#endif
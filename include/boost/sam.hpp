@@ -5,12 +5,30 @@
 #ifndef BOOST_SAM_HPP
 #define BOOST_SAM_HPP
 
+#include <boost/sam/adaptive_limiter.hpp>
 #include <boost/sam/barrier.hpp>
+#include <boost/sam/biased_shared_mutex.hpp>
 #include <boost/sam/condition_variable.hpp>
+#include <boost/sam/distributed_semaphore.hpp>
+#include <boost/sam/fair_semaphore.hpp>
+#include <boost/sam/hierarchical_semaphore.hpp>
+#include <boost/sam/keyed_mutex.hpp>
+#include <boost/sam/keyed_rate_limiter.hpp>
+#include <boost/sam/lock_all.hpp>
+#include <boost/sam/lock_hierarchy.hpp>
 #include <boost/sam/lock_guard.hpp>
 #include <boost/sam/mutex.hpp>
+#include <boost/sam/rate_limiter.hpp>
+#include <boost/sam/range_lock.hpp>
+#include <boost/sam/range_lock_guard.hpp>
+#include <boost/sam/rcu.hpp>
+#include <boost/sam/recursive_mutex.hpp>
 #include <boost/sam/semaphore.hpp>
+#include <boost/sam/semaphore_lease.hpp>
+#include <boost/sam/seqlock.hpp>
 #include <boost/sam/shared_mutex.hpp>
 #include <boost/sam/shared_lock_guard.hpp>
+#include <boost/sam/striped_mutex.hpp>
+#include <boost/sam/upgrade_lock_guard.hpp>
 
 #endif // BOOST_SAM_HPP
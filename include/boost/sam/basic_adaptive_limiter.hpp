@@ -0,0 +1,173 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_ADAPTIVE_LIMITER_HPP
+#define BOOST_SAM_BASIC_ADAPTIVE_LIMITER_HPP
+
+#include <boost/sam/detail/adaptive_limiter_impl.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+
+#include <chrono>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** An asio based concurrency limiter, that adjusts its limit to the latency of the operations it guards.
+ *
+ * It works like a semaphore, but every release can carry the latency & outcome of the operation
+ * the permit was held for. The limit grows while the latency stays flat, and shrinks when it rises
+ * or operations fail. Permits already held are never revoked by a shrinking limit.
+ *
+ * It's meant to be used with `guarded`, which measures the operations.
+ *
+ * @tparam Executor The executor to use as default completion.
+ */
+template <typename Executor = net::any_io_executor>
+struct basic_adaptive_limiter
+{
+  /// The executor type.
+  using executor_type = Executor;
+  /// The clock used for the latencies.
+  using clock_type = std::chrono::steady_clock;
+
+  /** A constructor.
+   *
+   * @param exec The executor to be used by the limiter.
+   * @param initial_limit The limit to start out with.
+   * @param min_limit The lowest the limit can shrink to.
+   * @param max_limit The highest the limit can grow to.
+   */
+  basic_adaptive_limiter(executor_type exec, int initial_limit = 20, int min_limit = 1, int max_limit = 1000,
+                         int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)),
+        impl_{net::query(exec_, net::execution::context), initial_limit, min_limit, max_limit, concurrency_hint}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the limiter.
+  template <typename ExecutionContext>
+  explicit basic_adaptive_limiter(
+      ExecutionContext &ctx, int initial_limit = 20, int min_limit = 1, int max_limit = 1000,
+      typename std::enable_if<std::is_convertible<ExecutionContext &, net::execution_context &>::value, int>::type
+          concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(ctx.get_executor()), impl_(ctx, initial_limit, min_limit, max_limit, concurrency_hint)
+  {
+  }
+
+  /// @brief Rebind a limiter to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_adaptive_limiter(basic_adaptive_limiter<Executor_> &&sem,
+                         typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /** Wait for a permit.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_acquire(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_acquire_op{this}, token);
+  }
+
+  /// Move assign a limiter.
+  basic_adaptive_limiter &operator=(basic_adaptive_limiter &&lhs) noexcept
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  /// Move assign a limiter with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_adaptive_limiter<Executor_> &&lhs)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value, basic_adaptive_limiter>::type &
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  basic_adaptive_limiter &operator=(const basic_adaptive_limiter &) = delete;
+
+  /** Acquire synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if no permit is available.
+   *
+   * If the implementation is `mt` this function will block until another thread releases one.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void acquire(error_code &ec) { impl_.acquire(ec); }
+
+  /// Throwing @overload acquire(error_code &);
+  void acquire()
+  {
+    error_code ec;
+    acquire(ec);
+    if (ec)
+      detail::throw_error(ec, "acquire");
+  }
+
+  /// Take a permit if one is available.
+  bool try_acquire() { return impl_.try_acquire(); }
+
+  /// Release a permit without a sample, e.g. because the operation got cancelled.
+  void release() { impl_.release(); }
+
+  /** Release a permit & update the limit.
+   *
+   * @param latency The time the operation the permit was held for took.
+   * @param dropped Whether the operation failed, e.g. timed out, which backs off the limit.
+   */
+  template <typename Rep, typename Period>
+  void release(const std::chrono::duration<Rep, Period> &latency, bool dropped = false)
+  {
+    impl_.release(std::chrono::duration_cast<clock_type::duration>(latency), dropped);
+  }
+
+  /// The current limit, e.g. for metrics.
+  BOOST_SAM_NODISCARD int limit() const noexcept { return impl_.limit(); }
+
+  /// The number of permits held. Can exceed the limit right after it shrank.
+  BOOST_SAM_NODISCARD int in_flight() const noexcept { return impl_.in_flight(); }
+
+  /// Rebinds the limiter type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The limiter type when rebound to the specified executor.
+    typedef basic_adaptive_limiter<Executor1> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename>
+  friend struct basic_adaptive_limiter;
+
+  Executor                      exec_;
+  detail::adaptive_limiter_impl impl_;
+  struct async_acquire_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_adaptive_limiter.hpp>
+
+#endif // BOOST_SAM_BASIC_ADAPTIVE_LIMITER_HPP
@@ -9,6 +9,9 @@
 #include <boost/sam/detail/barrier_impl.hpp>
 #include <boost/sam/detail/exception.hpp>
 #include <boost/sam/detail/service.hpp>
+#include <boost/sam/detail/timed_op_model.hpp>
+
+#include <chrono>
 
 #if defined(BOOST_SAM_STANDALONE)
 #include <asio/any_io_executor.hpp>
@@ -74,6 +77,46 @@ struct basic_barrier
     return net::async_initiate<CompletionToken, void(std::error_code)>(async_arrive_op{this}, token);
   }
 
+  /** Arrive at a barrier and wait for all other strands to arrive, unless the deadline passes first.
+   *
+   * If the deadline passes first, the arrival gets withdrawn and the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param deadline The point in time the operation times out at.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Clock, typename Duration,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_arrive_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                     CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_arrive_until_op{this, detail::to_steady_time(deadline)}, token);
+  }
+
+  /** Arrive at a barrier and wait for all other strands to arrive, unless the timeout expires first.
+   *
+   * If the timeout expires first, the arrival gets withdrawn and the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param timeout The time to wait at most.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Rep, typename Period,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_arrive_for(const std::chrono::duration<Rep, Period> &timeout,
+                   CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_arrive_until_op{this, detail::deadline_after(timeout)}, token);
+  }
+
   /// Move assign a barrier.
   basic_barrier &operator=(basic_barrier &&) noexcept = default;
 
@@ -134,6 +177,7 @@ private:
   Executor             exec_;
   detail::barrier_impl impl_;
   struct async_arrive_op;
+  struct async_arrive_until_op;
 };
 
 BOOST_SAM_END_NAMESPACE
@@ -0,0 +1,188 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_BIASED_SHARED_MUTEX_HPP
+#define BOOST_SAM_BASIC_BIASED_SHARED_MUTEX_HPP
+
+#include <boost/sam/detail/biased_shared_mutex_impl.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** An asio based shared mutex optimized for read-mostly data.
+ *
+ * While no writer is around, readers only increment a per-thread counter, without locking anything.
+ * A writer revokes that fast path and waits asynchronously for the readers to drain,
+ * which makes writes more expensive than with `basic_shared_mutex`.
+ *
+ * @tparam Executor The executor to use as default completion.
+ */
+template <typename Executor = net::any_io_executor>
+struct basic_biased_shared_mutex
+{
+  /// The executor type.
+  using executor_type = Executor;
+
+  /// A constructor. @param exec The executor to be used by the mutex.
+  explicit basic_biased_shared_mutex(executor_type exec, int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)), impl_{net::query(exec_, net::execution::context), concurrency_hint}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the mutex.
+  template <typename ExecutionContext>
+  explicit basic_biased_shared_mutex(
+      ExecutionContext &ctx,
+      typename std::enable_if<std::is_convertible<ExecutionContext &, net::execution_context &>::value, int>::type
+          concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(ctx.get_executor()), impl_(ctx, concurrency_hint)
+  {
+  }
+
+  /// @brief Rebind a mutex to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_biased_shared_mutex(
+      basic_biased_shared_mutex<Executor_> &&sem,
+      typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /** Wait for the mutex to become lockable & lock it.
+   *
+   * This waits for all readers to unlock, including those that took the fast path.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_op{this}, token);
+  }
+
+  /** Wait for the mutex to become lockable in shared mode & lock it.
+   *
+   * If no writer holds or waits for the lock, this completes without locking anything.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_shared(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_shared_op{this}, token);
+  }
+
+  /// Move assign a mutex.
+  basic_biased_shared_mutex &operator=(basic_biased_shared_mutex &&) noexcept = default;
+
+  /// Move assign a mutex with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_biased_shared_mutex<Executor_> &&sem)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value,
+                                 basic_biased_shared_mutex>::type &
+  {
+    exec_ = std::move(sem.exec_);
+    impl_ = std::move(sem.impl_);
+    return *this;
+  }
+
+  basic_biased_shared_mutex &operator=(const basic_biased_shared_mutex &) = delete;
+
+  /** Lock synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the mutex
+   * is already locked.
+   *
+   * If the implementation is `mt` this function will block until another thread releases
+   * the lock. Note that this may lead to deadlocks.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void lock(error_code &ec) { impl_.lock(ec); }
+
+  /// Throwing @overload lock(error_code &);
+  void lock()
+  {
+    error_code ec;
+    lock(ec);
+    if (ec)
+      detail::throw_error(ec, "lock");
+  }
+
+  /// Unlock the mutex, and complete the pending locks the next phase consists of.
+  void unlock() { impl_.unlock(); }
+
+  ///  Try to lock the mutex.
+  bool try_lock() { return impl_.try_lock(); }
+
+  /** Lock shared synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the mutex
+   * is locked exclusively.
+   *
+   * If the implementation is `mt` this function will block until another thread releases
+   * the lock. Note that this may lead to deadlocks.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void lock_shared(error_code &ec) { impl_.lock_shared(ec); }
+
+  /// Throwing @overload lock_shared(error_code &);
+  void lock_shared()
+  {
+    error_code ec;
+    lock_shared(ec);
+    if (ec)
+      detail::throw_error(ec, "lock_shared");
+  }
+
+  /// Unlock the shared mutex, and hand the lock to a waiting writer if this was the last reader.
+  void unlock_shared() { impl_.unlock_shared(); }
+
+  ///  Try to lock the mutex in shared mode.
+  bool try_lock_shared() { return impl_.try_lock_shared(); }
+
+  /// Rebinds the mutex type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The mutex type when rebound to the specified executor.
+    typedef basic_biased_shared_mutex<Executor1> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename>
+  friend struct basic_biased_shared_mutex;
+
+  Executor                         exec_;
+  detail::biased_shared_mutex_impl impl_;
+  struct async_lock_op;
+  struct async_lock_shared_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_biased_shared_mutex.hpp>
+
+#endif // BOOST_SAM_BASIC_BIASED_SHARED_MUTEX_HPP
@@ -7,6 +7,9 @@
 
 #include <boost/sam/detail/config.hpp>
 #include <boost/sam/detail/condition_variable_impl.hpp>
+#include <boost/sam/detail/timed_op_model.hpp>
+
+#include <chrono>
 
 #if defined(BOOST_SAM_STANDALONE)
 #include <asio/any_io_executor.hpp>
@@ -86,6 +89,104 @@ struct basic_condition_variable
         async_predicate_wait_op<typename std::decay<Predicate>::type>{this, std::forward<Predicate>(predicate)}, token);
   }
 
+  /** Wait for the condition_variable to become notified, unless the deadline passes first.
+   *
+   * If the deadline passes first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param deadline The point in time the operation times out at.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Clock, typename Duration,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_wait_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                   CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(error_code)>(
+        async_predicate_wait_until_op<typename async_wait_op::true_predicate>{
+            this, typename async_wait_op::true_predicate{}, detail::to_steady_time(deadline)},
+        token);
+  }
+
+  /** Wait for the condition_variable to become notified & the predicate to return true, unless the deadline passes
+   * first.
+   *
+   * The async_wait_until will always invoke the predicate from the executor.
+   * If the deadline passes first, the operation completes with `net::error::timed_out`,
+   * regardless of what the predicate would return.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param deadline The point in time the operation times out at.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Clock, typename Duration, typename Predicate,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_wait_until(
+      const std::chrono::time_point<Clock, Duration> &deadline, Predicate &&predicate,
+      CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type),
+      typename std::enable_if<std::is_same<decltype(std::declval<Predicate>()()), bool>::value>::type * = nullptr)
+  {
+    return net::async_initiate<CompletionToken, void(error_code)>(
+        async_predicate_wait_until_op<typename std::decay<Predicate>::type>{
+            this, std::forward<Predicate>(predicate), detail::to_steady_time(deadline)},
+        token);
+  }
+
+  /** Wait for the condition_variable to become notified, unless the timeout expires first.
+   *
+   * If the timeout expires first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param timeout The time to wait at most.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Rep, typename Period,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_wait_for(const std::chrono::duration<Rep, Period> &timeout,
+                 CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(error_code)>(
+        async_predicate_wait_until_op<typename async_wait_op::true_predicate>{
+            this, typename async_wait_op::true_predicate{}, detail::deadline_after(timeout)},
+        token);
+  }
+
+  /** Wait for the condition_variable to become notified & the predicate to return true, unless the timeout expires
+   * first.
+   *
+   * The async_wait_for will always invoke the predicate from the executor.
+   * If the timeout expires first, the operation completes with `net::error::timed_out`,
+   * regardless of what the predicate would return.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param timeout The time to wait at most.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Rep, typename Period, typename Predicate,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_wait_for(
+      const std::chrono::duration<Rep, Period> &timeout, Predicate &&predicate,
+      CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type),
+      typename std::enable_if<std::is_same<decltype(std::declval<Predicate>()()), bool>::value>::type * = nullptr)
+  {
+    return net::async_initiate<CompletionToken, void(error_code)>(
+        async_predicate_wait_until_op<typename std::decay<Predicate>::type>{
+            this, std::forward<Predicate>(predicate), detail::deadline_after(timeout)},
+        token);
+  }
+
   /// Move assign a condition_variable.
   basic_condition_variable &operator=(basic_condition_variable &&) noexcept = default;
 
@@ -128,6 +229,8 @@ private:
   template <typename Predicate>
   struct async_predicate_wait_op;
   struct async_wait_op;
+  template <typename Predicate>
+  struct async_predicate_wait_until_op;
 };
 
 BOOST_SAM_END_NAMESPACE
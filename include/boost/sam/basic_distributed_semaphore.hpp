@@ -0,0 +1,161 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_DISTRIBUTED_SEMAPHORE_HPP
+#define BOOST_SAM_BASIC_DISTRIBUTED_SEMAPHORE_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/distributed_semaphore_impl.hpp>
+#include <boost/sam/detail/exception.hpp>
+
+#include <vector>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** An asio based semaphore for many threads, that caches its permits per thread.
+ *
+ * Acquires & releases take from & give back to a cache of the calling thread without locking,
+ * so threads don't contend on a shared count. The caches rebalance in batches through a global pool,
+ * when one runs dry or holds too many permits, and all of them get drained once anyone has to wait.
+ *
+ * The count is exact, i.e. no more than `initial_count` permits are ever handed out,
+ * but the waiters are only woken up in order among themselves.
+ *
+ * @tparam Executor The executor to use as default completion.
+ */
+template <typename Executor = net::any_io_executor>
+struct basic_distributed_semaphore
+{
+  /// The executor type.
+  using executor_type = Executor;
+
+  /// A constructor. @param exec The executor to be used by the semaphore
+  explicit basic_distributed_semaphore(executor_type exec, int initial_count = 1,
+                                       int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)), impl_{net::query(exec_, net::execution::context), initial_count, concurrency_hint}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the semaphore.
+  template <typename ExecutionContext>
+  explicit basic_distributed_semaphore(ExecutionContext &ctx, int initial_count = 1,
+                                       typename std::enable_if<std::is_convertible<ExecutionContext &,
+                                                                                   net::execution_context &>::value,
+                                                               int>::type concurrency_hint =
+                                           BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(ctx.get_executor()), impl_(ctx, initial_count, concurrency_hint)
+  {
+  }
+
+  /// @brief Rebind a semaphore to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_distributed_semaphore(
+      basic_distributed_semaphore<Executor_> &&sem,
+      typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /** Wait for a permit.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_acquire(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_acquire_op{this}, token);
+  }
+
+  /// Move assign a semaphore.
+  basic_distributed_semaphore &operator=(basic_distributed_semaphore &&lhs) noexcept
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  /// Move assign a semaphore with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_distributed_semaphore<Executor_> &&lhs)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value,
+                                 basic_distributed_semaphore>::type &
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  basic_distributed_semaphore &operator=(const basic_distributed_semaphore &) = delete;
+
+  /** Acquire synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the semaphore
+   * cannot be acquired immediately.
+   *
+   * If the implementation is `mt` this function will block until a permit is available.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void acquire(error_code &ec) { impl_.acquire(ec); }
+
+  /// Throwing @overload acquire(error_code &);
+  void acquire()
+  {
+    error_code ec;
+    acquire(ec);
+    if (ec)
+      detail::throw_error(ec, "acquire");
+  }
+
+  /// Take a permit if one is available & nobody waits.
+  bool try_acquire() { return impl_.try_acquire(); }
+
+  /// Release a permit into the cache of the calling thread, or to a waiter.
+  void release() { impl_.release(); }
+
+  /// The current value of the semaphore, minus the number of waiters.
+  BOOST_SAM_NODISCARD int value() const { return impl_.value(); }
+
+  /// The permits in the global pool, i.e. not cached by any thread.
+  BOOST_SAM_NODISCARD int pooled() const { return impl_.pooled(); }
+
+  /// The permits cached by each of the per-thread slots.
+  BOOST_SAM_NODISCARD std::vector<int> distribution() const { return impl_.distribution(); }
+
+  /// Rebinds the semaphore type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The semaphore type when rebound to the specified executor.
+    typedef basic_distributed_semaphore<Executor1> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename>
+  friend struct basic_distributed_semaphore;
+
+  Executor                           exec_;
+  detail::distributed_semaphore_impl impl_;
+  struct async_acquire_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_distributed_semaphore.hpp>
+
+#endif // BOOST_SAM_BASIC_DISTRIBUTED_SEMAPHORE_HPP
@@ -0,0 +1,178 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_FAIR_SEMAPHORE_HPP
+#define BOOST_SAM_BASIC_FAIR_SEMAPHORE_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+#include <boost/sam/detail/fair_semaphore_impl.hpp>
+
+#include <functional>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** An asio based semaphore shared fairly between tenants.
+ *
+ * Waiters queue up per tenant, and releases pick the next waiter by deficit round robin,
+ * so a tenant with many waiters can't starve the others. A tenant with weight `n`
+ * gets `n` permits per round, i.e. `n` times the share of a tenant with weight 1.
+ * The weights are set per tenant with `set_weight` & default to 1.
+ *
+ * A tenant only takes up memory while it has waiters or a weight other than 1.
+ *
+ * @tparam Tenant The tenant id type, which must be copyable.
+ * @tparam Executor The executor to use as default completion.
+ * @tparam Hash The hash function for the tenant ids.
+ * @tparam KeyEqual The equality comparison for the tenant ids.
+ */
+template <typename Tenant, typename Executor = net::any_io_executor, typename Hash = std::hash<Tenant>,
+          typename KeyEqual = std::equal_to<Tenant>>
+struct basic_fair_semaphore
+{
+  /// The tenant id type.
+  using tenant_type = Tenant;
+  /// The executor type.
+  using executor_type = Executor;
+
+  /// A constructor. @param exec The executor to be used by the semaphore
+  explicit basic_fair_semaphore(executor_type exec, int initial_count = 1,
+                                int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT,
+                                const Hash &hash = Hash(), const KeyEqual &eq = KeyEqual())
+      : exec_(std::move(exec)),
+        impl_{net::query(exec_, net::execution::context), initial_count, concurrency_hint, hash, eq}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the semaphore.
+  template <typename ExecutionContext>
+  explicit basic_fair_semaphore(ExecutionContext &ctx, int initial_count = 1,
+                                typename std::enable_if<std::is_convertible<ExecutionContext &,
+                                                                            net::execution_context &>::value,
+                                                        int>::type concurrency_hint =
+                                    BOOST_SAM_CONCURRENCY_HINT_DEFAULT,
+                                const Hash &hash = Hash(), const KeyEqual &eq = KeyEqual())
+      : exec_(ctx.get_executor()), impl_(ctx, initial_count, concurrency_hint, hash, eq)
+  {
+  }
+
+  /// @brief Rebind a semaphore to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_fair_semaphore(basic_fair_semaphore<Tenant, Executor_, Hash, KeyEqual> &&sem,
+                       typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /** Wait for a permit on behalf of a tenant.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param tenant The tenant to queue up with.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_acquire(const Tenant &tenant, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_acquire_op{this, tenant}, token);
+  }
+
+  /** Set the share of a tenant.
+   *
+   * A tenant with weight `n` gets `n` permits per round. This applies to the waiters already queued, too.
+   *
+   * @param tenant The tenant to configure.
+   * @param weight The permits per round, which must be positive. 1 is the default & takes up no memory.
+   */
+  void set_weight(const Tenant &tenant, int weight) { impl_.set_weight(tenant, weight); }
+
+  /// The share of a tenant.
+  BOOST_SAM_NODISCARD int weight(const Tenant &tenant) const { return impl_.weight(tenant); }
+
+  /// Move assign a semaphore.
+  basic_fair_semaphore &operator=(basic_fair_semaphore &&lhs) noexcept
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  /// Move assign a semaphore with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_fair_semaphore<Tenant, Executor_, Hash, KeyEqual> &&lhs)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value, basic_fair_semaphore>::type &
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  basic_fair_semaphore &operator=(const basic_fair_semaphore &) = delete;
+
+  /** Acquire synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the semaphore
+   * cannot be acquired immediately.
+   *
+   * If the implementation is `mt` this function will block until it's the tenant's turn.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void acquire(const Tenant &tenant, error_code &ec) { impl_.acquire(tenant, ec); }
+
+  /// Throwing @overload acquire(const Tenant &, error_code &);
+  void acquire(const Tenant &tenant)
+  {
+    error_code ec;
+    acquire(tenant, ec);
+    if (ec)
+      detail::throw_error(ec, "acquire");
+  }
+
+  /// Take a permit if one is available & nobody waits.
+  bool try_acquire() { return impl_.try_acquire(); }
+
+  /// Release a permit, which goes to the next tenant in turn.
+  void release() { impl_.release(); }
+
+  /// The current value of the semaphore, minus the number of waiters.
+  BOOST_SAM_NODISCARD int value() const { return impl_.value(); }
+
+  /// The number of tenants with waiters.
+  BOOST_SAM_NODISCARD std::size_t tenants() const { return impl_.tenants(); }
+
+  /// Rebinds the semaphore type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The semaphore type when rebound to the specified executor.
+    typedef basic_fair_semaphore<Tenant, Executor1, Hash, KeyEqual> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename, typename, typename, typename>
+  friend struct basic_fair_semaphore;
+
+  Executor                                              exec_;
+  detail::fair_semaphore_impl<Tenant, Hash, KeyEqual> impl_;
+  struct async_acquire_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_fair_semaphore.hpp>
+
+#endif // BOOST_SAM_BASIC_FAIR_SEMAPHORE_HPP
@@ -0,0 +1,162 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_HIERARCHICAL_SEMAPHORE_HPP
+#define BOOST_SAM_BASIC_HIERARCHICAL_SEMAPHORE_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+#include <boost/sam/detail/hierarchical_semaphore_impl.hpp>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** An asio based semaphore made up of nested quotas.
+ *
+ * The semaphore is a tree of nodes, each with its own count, e.g. a global limit at the root
+ * and a sub-limit per tenant below it. Acquiring at a node takes a permit at the node and every one of its
+ * ancestors at once, or waits without holding any of them.
+ *
+ * A release wakes the oldest waiter that can get a permit at every level,
+ * so a waiter held back by its own quota doesn't block the others.
+ *
+ * @tparam Executor The executor to use as default completion.
+ */
+template <typename Executor = net::any_io_executor>
+struct basic_hierarchical_semaphore
+{
+  /// The executor type.
+  using executor_type = Executor;
+  /// The id of a node, which stands for the path from the root to it.
+  using node_id = std::size_t;
+
+  /// A constructor. @param exec The executor to be used by the semaphore
+  explicit basic_hierarchical_semaphore(executor_type exec, int initial_count = 1,
+                                        int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)), impl_{net::query(exec_, net::execution::context), initial_count, concurrency_hint}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the semaphore.
+  template <typename ExecutionContext>
+  explicit basic_hierarchical_semaphore(ExecutionContext &ctx, int initial_count = 1,
+                                        typename std::enable_if<std::is_convertible<ExecutionContext &,
+                                                                                    net::execution_context &>::value,
+                                                                int>::type concurrency_hint =
+                                            BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(ctx.get_executor()), impl_(ctx, initial_count, concurrency_hint)
+  {
+  }
+
+  /// @brief Rebind a semaphore to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_hierarchical_semaphore(
+      basic_hierarchical_semaphore<Executor_> &&sem,
+      typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /// The root node, which holds the initial count.
+  constexpr static node_id root() noexcept { return 0u; }
+
+  /// Add a node with its own count below `parent` & return its id.
+  node_id add_node(node_id parent, int initial_count) { return impl_.add_node(parent, initial_count); }
+
+  /** Wait for a permit at a node and all its ancestors.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param node The node to acquire at.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_acquire(node_id node, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_acquire_op{this, node}, token);
+  }
+
+  /// Move assign a semaphore.
+  basic_hierarchical_semaphore &operator=(basic_hierarchical_semaphore &&lhs) noexcept
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  /// Move assign a semaphore with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_hierarchical_semaphore<Executor_> &&lhs)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value,
+                                 basic_hierarchical_semaphore>::type &
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  basic_hierarchical_semaphore &operator=(const basic_hierarchical_semaphore &) = delete;
+
+  /** Acquire synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the semaphore
+   * cannot be acquired immediately.
+   *
+   * If the implementation is `mt` this function will block until a permit is available at every level.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void acquire(node_id node, error_code &ec) { impl_.acquire(node, ec); }
+
+  /// Throwing @overload acquire(node_id, error_code &);
+  void acquire(node_id node)
+  {
+    error_code ec;
+    acquire(node, ec);
+    if (ec)
+      detail::throw_error(ec, "acquire");
+  }
+
+  /// Take a permit at the node and all its ancestors, if every one of them has one.
+  bool try_acquire(node_id node) { return impl_.try_acquire(node); }
+
+  /// Give back a permit at the node and all its ancestors.
+  void release(node_id node) { impl_.release(node); }
+
+  /// The permits left at a node.
+  BOOST_SAM_NODISCARD int value(node_id node) const { return impl_.value(node); }
+
+  /// Rebinds the semaphore type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The semaphore type when rebound to the specified executor.
+    typedef basic_hierarchical_semaphore<Executor1> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename>
+  friend struct basic_hierarchical_semaphore;
+
+  Executor                            exec_;
+  detail::hierarchical_semaphore_impl impl_;
+  struct async_acquire_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_hierarchical_semaphore.hpp>
+
+#endif // BOOST_SAM_BASIC_HIERARCHICAL_SEMAPHORE_HPP
@@ -0,0 +1,193 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_KEYED_MUTEX_HPP
+#define BOOST_SAM_BASIC_KEYED_MUTEX_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+#include <boost/sam/detail/keyed_mutex_impl.hpp>
+
+#include <functional>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** An asio based shared mutex per key, e.g. to serialize work per user or object.
+ *
+ * A key only takes up memory while it's locked or waited on, so idle keys are free.
+ * Keys are spread over shards with a mutex each, so unrelated keys rarely contend.
+ *
+ * Per key, the mutex behaves like a `basic_shared_mutex`, with waiters served in order,
+ * i.e. shared locks queue up behind a waiting exclusive lock.
+ *
+ * @tparam Key The key type, which must be copyable.
+ * @tparam Executor The executor to use as default completion.
+ * @tparam Hash The hash function for the keys.
+ * @tparam KeyEqual The equality comparison for the keys.
+ */
+template <typename Key, typename Executor = net::any_io_executor, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+struct basic_keyed_mutex
+{
+  /// The key type.
+  using key_type = Key;
+  /// The executor type.
+  using executor_type = Executor;
+
+  /// A constructor. @param exec The executor to be used by the keyed mutex
+  explicit basic_keyed_mutex(executor_type exec, int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT,
+                             const Hash &hash = Hash(), const KeyEqual &eq = KeyEqual())
+      : exec_(std::move(exec)), impl_{net::query(exec_, net::execution::context), concurrency_hint, hash, eq}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the keyed mutex.
+  template <typename ExecutionContext>
+  explicit basic_keyed_mutex(ExecutionContext &ctx,
+                             typename std::enable_if<std::is_convertible<ExecutionContext &,
+                                                                         net::execution_context &>::value,
+                                                     int>::type concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT,
+                             const Hash &hash = Hash(), const KeyEqual &eq = KeyEqual())
+      : exec_(ctx.get_executor()), impl_(ctx, concurrency_hint, hash, eq)
+  {
+  }
+
+  /// @brief Rebind a keyed mutex to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_keyed_mutex(basic_keyed_mutex<Key, Executor_, Hash, KeyEqual> &&sem,
+                    typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /** Wait for the key to be lockable exclusively & lock it.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param key The key to lock.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock(const Key &key, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_op{this, key, false}, token);
+  }
+
+  /** Wait for the key to be lockable shared & lock it.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param key The key to lock.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_shared(const Key &key, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_op{this, key, true}, token);
+  }
+
+  /// Move assign a keyed mutex.
+  basic_keyed_mutex &operator=(basic_keyed_mutex &&lhs) noexcept
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  /// Move assign a keyed mutex with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_keyed_mutex<Key, Executor_, Hash, KeyEqual> &&lhs)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value, basic_keyed_mutex>::type &
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  basic_keyed_mutex &operator=(const basic_keyed_mutex &) = delete;
+
+  /** Lock synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the key
+   * is already locked.
+   *
+   * If the implementation is `mt` this function will block until another thread releases
+   * the key. Note that this may lead to deadlocks.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void lock(const Key &key, error_code &ec) { impl_.lock(key, false, ec); }
+
+  /// Throwing @overload lock(const Key &, error_code &);
+  void lock(const Key &key)
+  {
+    error_code ec;
+    lock(key, ec);
+    if (ec)
+      detail::throw_error(ec, "lock");
+  }
+
+  /// Unlock an exclusively locked key, and complete pending locks if pending.
+  void unlock(const Key &key) { impl_.unlock(key, false); }
+
+  /// Try to lock the key exclusively.
+  bool try_lock(const Key &key) { return impl_.try_lock(key, false); }
+
+  /// Lock the key shared synchronously, see `lock`.
+  void lock_shared(const Key &key, error_code &ec) { impl_.lock(key, true, ec); }
+
+  /// Throwing @overload lock_shared(const Key &, error_code &);
+  void lock_shared(const Key &key)
+  {
+    error_code ec;
+    lock_shared(key, ec);
+    if (ec)
+      detail::throw_error(ec, "lock_shared");
+  }
+
+  /// Unlock a key locked shared, and complete pending locks if pending.
+  void unlock_shared(const Key &key) { impl_.unlock(key, true); }
+
+  /// Try to lock the key shared.
+  bool try_lock_shared(const Key &key) { return impl_.try_lock(key, true); }
+
+  /// The number of keys that are currently locked or waited on.
+  std::size_t size() const { return impl_.size(); }
+
+  /// Rebinds the keyed mutex type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The keyed mutex type when rebound to the specified executor.
+    typedef basic_keyed_mutex<Key, Executor1, Hash, KeyEqual> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename, typename, typename, typename>
+  friend struct basic_keyed_mutex;
+
+  Executor                                         exec_;
+  detail::keyed_mutex_impl<Key, Hash, KeyEqual> impl_;
+  struct async_lock_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_keyed_mutex.hpp>
+
+#endif // BOOST_SAM_BASIC_KEYED_MUTEX_HPP
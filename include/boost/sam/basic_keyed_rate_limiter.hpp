@@ -0,0 +1,180 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_KEYED_RATE_LIMITER_HPP
+#define BOOST_SAM_BASIC_KEYED_RATE_LIMITER_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+#include <boost/sam/detail/keyed_rate_limiter_impl.hpp>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** An asio based rate limiter per key, e.g. per client or API key.
+ *
+ * Every key may do `burst` requests at once and `rate` requests every `interval` after that.
+ * It uses the generic cell rate algorithm, so a key only takes up a single timestamp,
+ * and a key that's idle long enough to have its full burst again gets erased.
+ *
+ * @tparam Key The key type, which must be copyable.
+ * @tparam Executor The executor to use as default completion.
+ * @tparam Hash The hash function for the keys.
+ * @tparam KeyEqual The equality comparison for the keys.
+ */
+template <typename Key, typename Executor = net::any_io_executor, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+struct basic_keyed_rate_limiter
+{
+  /// The key type.
+  using key_type = Key;
+  /// The executor type.
+  using executor_type = Executor;
+  /// The clock used for the arrival times.
+  using clock_type = std::chrono::steady_clock;
+
+  /** A constructor.
+   *
+   * @param exec The executor to be used by the rate limiter.
+   * @param rate The number of requests per key every interval.
+   * @param interval The interval.
+   * @param burst The number of requests a key may do at once.
+   */
+  basic_keyed_rate_limiter(executor_type exec, int rate, clock_type::duration interval, int burst,
+                           int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT, const Hash &hash = Hash(),
+                           const KeyEqual &eq = KeyEqual())
+      : exec_(std::move(exec)),
+        impl_{net::query(exec_, net::execution::context), rate, interval, burst, concurrency_hint, hash, eq}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the rate limiter.
+  template <typename ExecutionContext>
+  basic_keyed_rate_limiter(ExecutionContext &ctx, int rate, clock_type::duration interval, int burst,
+                           typename std::enable_if<std::is_convertible<ExecutionContext &,
+                                                                       net::execution_context &>::value,
+                                                   int>::type concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT,
+                           const Hash &hash = Hash(), const KeyEqual &eq = KeyEqual())
+      : exec_(ctx.get_executor()), impl_(ctx, rate, interval, burst, concurrency_hint, hash, eq)
+  {
+  }
+
+  /// @brief Rebind a rate limiter to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_keyed_rate_limiter(basic_keyed_rate_limiter<Key, Executor_, Hash, KeyEqual> &&sem,
+                           typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * =
+                               nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /** Wait until a request for the key conforms.
+   *
+   * The request reserves its slot right away, so requests of the same key complete in order.
+   * A cancelled request doesn't give its slot back.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param key The key of the request.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_acquire(const Key &key, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_acquire_op{this, key}, token);
+  }
+
+  /// Move assign a rate limiter.
+  basic_keyed_rate_limiter &operator=(basic_keyed_rate_limiter &&lhs) noexcept
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  /// Move assign a rate limiter with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_keyed_rate_limiter<Key, Executor_, Hash, KeyEqual> &&lhs)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value,
+                                 basic_keyed_rate_limiter>::type &
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  basic_keyed_rate_limiter &operator=(const basic_keyed_rate_limiter &) = delete;
+
+  /** Acquire synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the request
+   * doesn't conform right away.
+   *
+   * If the implementation is `mt` this function will reserve a slot & sleep until it's due.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void acquire(const Key &key, error_code &ec)
+  {
+    if (!impl_.mtx_.enabled())
+    {
+      if (!impl_.try_acquire(key))
+        BOOST_SAM_ASSIGN_EC(ec, net::error::in_progress);
+      return;
+    }
+    std::this_thread::sleep_until(impl_.reserve(key));
+  }
+
+  /// Throwing @overload acquire(const Key &, error_code &);
+  void acquire(const Key &key)
+  {
+    error_code ec;
+    acquire(key, ec);
+    if (ec)
+      detail::throw_error(ec, "acquire");
+  }
+
+  /// Admit a request for the key if it conforms right now.
+  bool try_acquire(const Key &key) { return impl_.try_acquire(key); }
+
+  /// The number of keys currently tracked.
+  std::size_t size() const { return impl_.size(); }
+
+  /// Rebinds the rate limiter type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The rate limiter type when rebound to the specified executor.
+    typedef basic_keyed_rate_limiter<Key, Executor1, Hash, KeyEqual> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename, typename, typename, typename>
+  friend struct basic_keyed_rate_limiter;
+
+  Executor                                                exec_;
+  detail::keyed_rate_limiter_impl<Key, Hash, KeyEqual> impl_;
+  struct async_acquire_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_keyed_rate_limiter.hpp>
+
+#endif // BOOST_SAM_BASIC_KEYED_RATE_LIMITER_HPP
@@ -0,0 +1,217 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_LOCK_HIERARCHY_HPP
+#define BOOST_SAM_BASIC_LOCK_HIERARCHY_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+#include <boost/sam/detail/lock_hierarchy_impl.hpp>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** An asio based lock manager for tree structured resources, e.g. database, table & row.
+ *
+ * Every node can be locked in one of the modes of `lock_mode`. Locking a node implicitly
+ * locks all its ancestors in the matching intention mode, so a whole subtree can be locked with one lock,
+ * while locks on disjoint subtrees don't block each other.
+ *
+ * Locks aren't owned by a thread or coroutine, i.e. locking a node twice can deadlock.
+ * To lock nodes below one that is held already, e.g. rows of a table held in `shared_intention_exclusive` mode,
+ * use the `_within` functions, which only take the intention locks below the held ancestor.
+ *
+ * @tparam Executor The executor to use as default completion.
+ */
+template <typename Executor = net::any_io_executor>
+struct basic_lock_hierarchy
+{
+  /// The executor type.
+  using executor_type = Executor;
+  /// The handle of a node.
+  using node_type = std::size_t;
+
+  /// A constructor. @param exec The executor to be used by the lock hierarchy
+  explicit basic_lock_hierarchy(executor_type exec, int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)), impl_{net::query(exec_, net::execution::context), concurrency_hint}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the lock hierarchy.
+  template <typename ExecutionContext>
+  explicit basic_lock_hierarchy(ExecutionContext &ctx,
+                                typename std::enable_if<std::is_convertible<ExecutionContext &,
+                                                                            net::execution_context &>::value,
+                                                        int>::type concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(ctx.get_executor()), impl_(ctx, concurrency_hint)
+  {
+  }
+
+  /// @brief Rebind a lock hierarchy to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_lock_hierarchy(basic_lock_hierarchy<Executor_> &&sem,
+                       typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /// The root node, which exists from the start.
+  node_type root() const noexcept { return 0u; }
+
+  /// Add a child node to `parent`.
+  node_type add_node(node_type parent) { return impl_.add_node(parent); }
+
+  /// The number of nodes, including the root.
+  std::size_t size() const { return impl_.size(); }
+
+  /** Wait for the node to be lockable in `mode` & lock it, along with its ancestors.
+   *
+   * Waiters are served in order per node, so a waiting `exclusive` lock is not overtaken
+   * by later intention locks passing through the same node.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param node The node to lock.
+   * @param mode The mode to lock the node in.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock(node_type node, lock_mode mode, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_op{this, node, mode, detail::lock_hierarchy_impl::no_ancestor}, token);
+  }
+
+  /** Wait for the node to be lockable in `mode` & lock it, along with its ancestors below `ancestor`.
+   *
+   * The caller must hold `ancestor` in a mode that covers `mode` already,
+   * i.e. `exclusive`, or `shared_intention_exclusive` or `shared` for the shared modes.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param ancestor An ancestor of `node` that the caller holds.
+   * @param node The node to lock.
+   * @param mode The mode to lock the node in.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_within(node_type ancestor, node_type node, lock_mode mode,
+                    CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_op{this, node, mode, ancestor},
+                                                                       token);
+  }
+
+  /// Move assign a lock hierarchy.
+  basic_lock_hierarchy &operator=(basic_lock_hierarchy &&lhs) noexcept
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  /// Move assign a lock hierarchy with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_lock_hierarchy<Executor_> &&lhs)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value, basic_lock_hierarchy>::type &
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  basic_lock_hierarchy &operator=(const basic_lock_hierarchy &) = delete;
+
+  /** Lock synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the node
+   * can't be locked right away.
+   *
+   * If the implementation is `mt` this function will block until another thread releases
+   * the conflicting locks. Note that this may lead to deadlocks.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void lock(node_type node, lock_mode mode, error_code &ec)
+  {
+    impl_.lock(node, mode, detail::lock_hierarchy_impl::no_ancestor, ec);
+  }
+
+  /// Throwing @overload lock(node_type, lock_mode, error_code &);
+  void lock(node_type node, lock_mode mode)
+  {
+    error_code ec;
+    lock(node, mode, ec);
+    if (ec)
+      detail::throw_error(ec, "lock");
+  }
+
+  /// Unlock a node locked in `mode`, along with the intention locks on its ancestors.
+  void unlock(node_type node, lock_mode mode) { impl_.unlock(node, mode, detail::lock_hierarchy_impl::no_ancestor); }
+
+  /// Try to lock the node in `mode`.
+  bool try_lock(node_type node, lock_mode mode)
+  {
+    return impl_.try_lock(node, mode, detail::lock_hierarchy_impl::no_ancestor);
+  }
+
+  /// Lock synchronously below a held ancestor, see `lock` & `async_lock_within`.
+  void lock_within(node_type ancestor, node_type node, lock_mode mode, error_code &ec)
+  {
+    impl_.lock(node, mode, ancestor, ec);
+  }
+
+  /// Throwing @overload lock_within(node_type, node_type, lock_mode, error_code &);
+  void lock_within(node_type ancestor, node_type node, lock_mode mode)
+  {
+    error_code ec;
+    lock_within(ancestor, node, mode, ec);
+    if (ec)
+      detail::throw_error(ec, "lock_within");
+  }
+
+  /// Unlock a node locked with one of the `_within` functions.
+  void unlock_within(node_type ancestor, node_type node, lock_mode mode) { impl_.unlock(node, mode, ancestor); }
+
+  /// Try to lock the node in `mode` below a held ancestor.
+  bool try_lock_within(node_type ancestor, node_type node, lock_mode mode)
+  {
+    return impl_.try_lock(node, mode, ancestor);
+  }
+
+  /// Rebinds the lock hierarchy type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The lock hierarchy type when rebound to the specified executor.
+    typedef basic_lock_hierarchy<Executor1> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename>
+  friend struct basic_lock_hierarchy;
+
+  Executor                    exec_;
+  detail::lock_hierarchy_impl impl_;
+  struct async_lock_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_lock_hierarchy.hpp>
+
+#endif // BOOST_SAM_BASIC_LOCK_HIERARCHY_HPP
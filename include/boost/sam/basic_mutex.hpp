@@ -8,6 +8,9 @@
 #include <boost/sam/detail/config.hpp>
 #include <boost/sam/detail/exception.hpp>
 #include <boost/sam/detail/mutex_impl.hpp>
+#include <boost/sam/detail/timed_op_model.hpp>
+
+#include <chrono>
 
 #if defined(BOOST_SAM_STANDALONE)
 #include <asio/any_io_executor.hpp>
@@ -63,9 +66,89 @@ struct basic_mutex
   template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
                 CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
   BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
-  async_lock(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  async_lock(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type),
+             typename std::enable_if<!std::is_integral<typename std::decay<CompletionToken>::type>::value>::type * =
+                 nullptr)
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_op{this, 0u}, token);
+  }
+
+  /** Wait for the mutex to become lockable & lock it, ahead of lower priority waiters.
+   *
+   * When the mutex gets unlocked, the first waiter with the highest priority acquires it.
+   * Waiters of the same priority are served in FIFO order.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param priority The priority of this waiter, from 0 (the default) to 7. Larger values get clamped.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock(std::size_t priority, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_op{this, priority}, token);
+  }
+
+  /** Wait for the mutex to become lockable & lock it, unless the deadline passes first.
+   *
+   * If the deadline passes first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param deadline The point in time the operation times out at.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Clock, typename Duration,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                   CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_until_op{this, detail::to_steady_time(deadline)}, token);
+  }
+
+  /** Wait for the mutex to become lockable & lock it, unless the timeout expires first.
+   *
+   * If the timeout expires first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param timeout The time to wait at most.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Rep, typename Period,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_for(const std::chrono::duration<Rep, Period> &timeout,
+                 CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_until_op{this, detail::deadline_after(timeout)}, token);
+  }
+
+  /** Let pending operations take the mutex & requeue for it, without unlocking in between.
+   *
+   * This must only be called while holding the lock.
+   * If other operations are waiting, ownership is handed to the first of them and this operation
+   * completes once the lock has been passed back to it. Otherwise it completes immediately, still holding the lock.
+   *
+   * If the operation completes with an error, the lock is no longer held.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_yield(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
   {
-    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_op{this}, token);
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_yield_op{this}, token);
   }
 
   /// Move assign a mutex.
@@ -110,6 +193,15 @@ struct basic_mutex
   ///  Try to lock the mutex.
   bool try_lock() { return impl_.try_lock(); }
 
+  /** Enable aging of waiters, so low priority waiters can't starve.
+   *
+   * Every `wakeups` times the mutex gets handed to a waiter,
+   * the first waiter of every priority gets moved up by one priority.
+   *
+   * @param wakeups The number of wakeups between agings, 0 disables aging (the default).
+   */
+  void set_aging(std::size_t wakeups) { impl_.set_aging(wakeups); }
+
   /// Rebinds the mutex type to another executor.
   template <typename Executor1>
   struct rebind_executor
@@ -129,6 +221,8 @@ private:
   Executor           exec_;
   detail::mutex_impl impl_;
   struct async_lock_op;
+  struct async_lock_until_op;
+  struct async_yield_op;
 };
 
 BOOST_SAM_END_NAMESPACE
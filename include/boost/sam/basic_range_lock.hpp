@@ -0,0 +1,284 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_RANGE_LOCK_HPP
+#define BOOST_SAM_BASIC_RANGE_LOCK_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+#include <boost/sam/detail/range_lock_impl.hpp>
+#include <boost/sam/detail/timed_op_model.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+struct range_lock_guard;
+
+/** An asio based byte-range lock, e.g. for regions of a shared file or buffer.
+ *
+ * Each lock covers the range `[offset, offset + length)`. Shared locks only conflict with overlapping exclusive
+ * locks, exclusive locks with any overlapping lock; locks on disjoint ranges never wait on each other.
+ *
+ * A waiter only gets woken up when a lock overlapping its range gets released.
+ * Overlapping waiters are served in order, so exclusive locks don't starve.
+ *
+ * @tparam Executor The executor to use as default completion.
+ */
+template <typename Executor = net::any_io_executor>
+struct basic_range_lock
+{
+  /// The executor type.
+  using executor_type = Executor;
+
+  /// A constructor. @param exec The executor to be used by the range lock
+  explicit basic_range_lock(executor_type exec, int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)), impl_{net::query(exec_, net::execution::context), concurrency_hint}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the range lock.
+  template <typename ExecutionContext>
+  explicit basic_range_lock(ExecutionContext &ctx,
+                            typename std::enable_if<std::is_convertible<ExecutionContext &,
+                                                                        net::execution_context &>::value,
+                                                    int>::type concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(ctx.get_executor()), impl_(ctx, concurrency_hint)
+  {
+  }
+
+  /// @brief Rebind a range lock to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_range_lock(basic_range_lock<Executor_> &&sem,
+                   typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /** Wait for the range to be lockable exclusively & lock it.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param offset The start of the range.
+   * @param length The length of the range.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock(std::uint64_t offset, std::uint64_t length,
+             CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_op{this, offset, end_of(offset, length), false}, token);
+  }
+
+  /** Wait for the range to be lockable exclusively & lock it, unless the deadline passes first.
+   *
+   * If the deadline passes first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param offset The start of the range.
+   * @param length The length of the range.
+   * @param deadline The point in time the operation times out at.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Clock, typename Duration,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_until(std::uint64_t offset, std::uint64_t length, const std::chrono::time_point<Clock, Duration> &deadline,
+                   CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_until_op{this, offset, end_of(offset, length), false, detail::to_steady_time(deadline)}, token);
+  }
+
+  /** Wait for the range to be lockable exclusively & lock it, unless the timeout expires first.
+   *
+   * If the timeout expires first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param offset The start of the range.
+   * @param length The length of the range.
+   * @param timeout The time to wait at most.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Rep, typename Period,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_for(std::uint64_t offset, std::uint64_t length, const std::chrono::duration<Rep, Period> &timeout,
+                 CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_until_op{this, offset, end_of(offset, length), false, detail::deadline_after(timeout)}, token);
+  }
+
+  /** Wait for the range to be lockable shared & lock it.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param offset The start of the range.
+   * @param length The length of the range.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_shared(std::uint64_t offset, std::uint64_t length,
+                    CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_op{this, offset, end_of(offset, length), true}, token);
+  }
+
+  /// Shared version of @ref async_lock_until.
+  template <typename Clock, typename Duration,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_shared_until(std::uint64_t offset, std::uint64_t length,
+                          const std::chrono::time_point<Clock, Duration> &deadline,
+                          CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_until_op{this, offset, end_of(offset, length), true, detail::to_steady_time(deadline)}, token);
+  }
+
+  /// Shared version of @ref async_lock_for.
+  template <typename Rep, typename Period,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_shared_for(std::uint64_t offset, std::uint64_t length, const std::chrono::duration<Rep, Period> &timeout,
+                        CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_until_op{this, offset, end_of(offset, length), true, detail::deadline_after(timeout)}, token);
+  }
+
+  /// Move assign a range lock.
+  basic_range_lock &operator=(basic_range_lock &&lhs) noexcept
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  /// Move assign a range lock with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_range_lock<Executor_> &&lhs)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value, basic_range_lock>::type &
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  basic_range_lock &operator=(const basic_range_lock &) = delete;
+
+  /** Lock synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the range
+   * can't be locked right away.
+   *
+   * If the implementation is `mt` this function will block until another thread releases
+   * the overlapping locks. Note that this may lead to deadlocks.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void lock(std::uint64_t offset, std::uint64_t length, error_code &ec)
+  {
+    impl_.lock(offset, end_of(offset, length), false, ec);
+  }
+
+  /// Throwing @overload lock(std::uint64_t, std::uint64_t, error_code &);
+  void lock(std::uint64_t offset, std::uint64_t length)
+  {
+    error_code ec;
+    lock(offset, length, ec);
+    if (ec)
+      detail::throw_error(ec, "lock");
+  }
+
+  /// Unlock an exclusively locked range, which must match the locked one exactly.
+  void unlock(std::uint64_t offset, std::uint64_t length) { impl_.unlock(offset, end_of(offset, length), false); }
+
+  /// Try to lock the range exclusively.
+  bool try_lock(std::uint64_t offset, std::uint64_t length)
+  {
+    return impl_.try_lock(offset, end_of(offset, length), false);
+  }
+
+  /// Lock the range shared synchronously, see `lock`.
+  void lock_shared(std::uint64_t offset, std::uint64_t length, error_code &ec)
+  {
+    impl_.lock(offset, end_of(offset, length), true, ec);
+  }
+
+  /// Throwing @overload lock_shared(std::uint64_t, std::uint64_t, error_code &);
+  void lock_shared(std::uint64_t offset, std::uint64_t length)
+  {
+    error_code ec;
+    lock_shared(offset, length, ec);
+    if (ec)
+      detail::throw_error(ec, "lock_shared");
+  }
+
+  /// Unlock a range locked shared, which must match the locked one exactly.
+  void unlock_shared(std::uint64_t offset, std::uint64_t length)
+  {
+    impl_.unlock(offset, end_of(offset, length), true);
+  }
+
+  /// Try to lock the range shared.
+  bool try_lock_shared(std::uint64_t offset, std::uint64_t length)
+  {
+    return impl_.try_lock(offset, end_of(offset, length), true);
+  }
+
+  /// Rebinds the range lock type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The range lock type when rebound to the specified executor.
+    typedef basic_range_lock<Executor1> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename>
+  friend struct basic_range_lock;
+  friend struct range_lock_guard;
+
+  static std::uint64_t end_of(std::uint64_t offset, std::uint64_t length) noexcept
+  {
+    BOOST_SAM_ASSERT(length <= static_cast<std::uint64_t>(-1) - offset);
+    return offset + length;
+  }
+
+  Executor                exec_;
+  detail::range_lock_impl impl_;
+  struct async_lock_op;
+  struct async_lock_until_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_range_lock.hpp>
+
+#endif // BOOST_SAM_BASIC_RANGE_LOCK_HPP
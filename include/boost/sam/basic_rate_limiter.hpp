@@ -0,0 +1,181 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_RATE_LIMITER_HPP
+#define BOOST_SAM_BASIC_RATE_LIMITER_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+#include <boost/sam/detail/rate_limiter_impl.hpp>
+
+#include <chrono>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** An asio based token bucket, to limit how often something happens.
+ *
+ * The bucket holds up to `burst` tokens and gets refilled by `rate` tokens every `interval`.
+ * Acquiring tokens waits until they're there, waiters are served in FIFO order.
+ *
+ * There's no periodic timer: the tokens get refilled from timestamps whenever they're looked at,
+ * and only the first waiter arms a timer for the time its tokens will be there.
+ * Note that this timer needs the execution context to run, even for the synchronous functions.
+ *
+ * @tparam Executor The executor to use as default completion.
+ */
+template <typename Executor = net::any_io_executor>
+struct basic_rate_limiter
+{
+  /// The executor type.
+  using executor_type = Executor;
+
+  /// The clock used for refills.
+  using clock_type = std::chrono::steady_clock;
+
+  /** A constructor.
+   *
+   * @param exec The executor to be used by the rate limiter.
+   * @param rate The number of tokens refilled every interval.
+   * @param interval The interval.
+   * @param burst The capacity of the bucket, it starts out full.
+   */
+  basic_rate_limiter(executor_type exec, int rate, clock_type::duration interval, int burst,
+                     int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)),
+        impl_{net::query(exec_, net::execution::context), rate, interval, burst, concurrency_hint}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the rate limiter.
+  template <typename ExecutionContext>
+  basic_rate_limiter(ExecutionContext &ctx, int rate, clock_type::duration interval, int burst,
+                     typename std::enable_if<std::is_convertible<ExecutionContext &, net::execution_context &>::value,
+                                             int>::type concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(ctx.get_executor()), impl_(ctx, rate, interval, burst, concurrency_hint)
+  {
+  }
+
+  /// @brief Rebind a rate limiter to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_rate_limiter(basic_rate_limiter<Executor_> &&sem,
+                     typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /** Wait for a token & take it.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_acquire(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type),
+                typename std::enable_if<!std::is_integral<typename std::decay<CompletionToken>::type>::value>::type * =
+                    nullptr)
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_acquire_op{this, 1}, token);
+  }
+
+  /** Wait for `tokens` tokens & take them at once.
+   *
+   * If more tokens than the burst are requested, this completes with `net::error::invalid_argument`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param tokens The number of tokens.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_acquire(int tokens, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_acquire_op{this, tokens}, token);
+  }
+
+  /// Move assign a rate limiter.
+  basic_rate_limiter &operator=(basic_rate_limiter &&lhs) noexcept
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  /// Move assign a rate limiter with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_rate_limiter<Executor_> &&lhs)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value, basic_rate_limiter>::type &
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  basic_rate_limiter &operator=(const basic_rate_limiter &) = delete;
+
+  /** Acquire synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the tokens
+   * aren't there right away.
+   *
+   * If the implementation is `mt` this function will block until the tokens got refilled,
+   * which requires the execution context to be run by another thread.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void acquire(int tokens, error_code &ec) { impl_.acquire(tokens, ec, exec_); }
+
+  /// Throwing @overload acquire(int, error_code &);
+  void acquire(int tokens = 1)
+  {
+    error_code ec;
+    acquire(tokens, ec);
+    if (ec)
+      detail::throw_error(ec, "acquire");
+  }
+
+  /// Take `tokens` tokens if they're there and nobody is waiting.
+  bool try_acquire(int tokens = 1) { return impl_.try_acquire(tokens); }
+
+  /// The number of tokens available right now.
+  int available() const { return impl_.available(); }
+
+  /// The capacity of the bucket.
+  int burst() const noexcept { return impl_.burst(); }
+
+  /// Rebinds the rate limiter type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The rate limiter type when rebound to the specified executor.
+    typedef basic_rate_limiter<Executor1> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename>
+  friend struct basic_rate_limiter;
+
+  Executor                  exec_;
+  detail::rate_limiter_impl impl_;
+  struct async_acquire_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_rate_limiter.hpp>
+
+#endif // BOOST_SAM_BASIC_RATE_LIMITER_HPP
@@ -0,0 +1,211 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_RCU_HPP
+#define BOOST_SAM_BASIC_RCU_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+#include <boost/sam/detail/rcu_impl.hpp>
+
+#include <atomic>
+#include <utility>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** A read section of a `basic_rcu`, giving access to the snapshot that was current when it began.
+ *
+ * The snapshot stays alive until the guard is destroyed.
+ */
+template <typename T>
+struct rcu_read_guard
+{
+  /// Construct an empty rcu_read_guard.
+  rcu_read_guard() = default;
+  rcu_read_guard(const rcu_read_guard &) = delete;
+  rcu_read_guard(rcu_read_guard &&lhs) noexcept : impl_(lhs.impl_), counter_(lhs.counter_), value_(lhs.value_)
+  {
+    lhs.impl_ = nullptr;
+  }
+
+  rcu_read_guard &operator=(const rcu_read_guard &) = delete;
+  rcu_read_guard &operator=(rcu_read_guard &&lhs) noexcept
+  {
+    std::swap(impl_, lhs.impl_);
+    std::swap(counter_, lhs.counter_);
+    std::swap(value_, lhs.value_);
+    return *this;
+  }
+
+  /// Leave the read section.
+  ~rcu_read_guard()
+  {
+    if (impl_ != nullptr)
+      impl_->read_unlock(*counter_);
+  }
+
+  /// The snapshot.
+  const T &operator*() const noexcept { return *value_; }
+  const T *operator->() const noexcept { return value_; }
+  const T *get() const noexcept { return value_; }
+
+private:
+  template <typename, typename>
+  friend struct basic_rcu;
+
+  rcu_read_guard(detail::rcu_impl *impl, detail::rcu_impl::reader_counter *counter, const T *value)
+      : impl_(impl), counter_(counter), value_(value)
+  {
+  }
+
+  detail::rcu_impl                 *impl_    = nullptr;
+  detail::rcu_impl::reader_counter *counter_ = nullptr;
+  const T                          *value_   = nullptr;
+};
+
+/** An asio based read-copy-update cell, for large values that are read far more often than replaced.
+ *
+ * Readers get lock-free access to the current snapshot, without any shared reference count.
+ * A writer publishes a new snapshot, and the replaced one gets deleted once all readers that
+ * might still see it are done, which `async_synchronize` waits for.
+ *
+ * @tparam T The value type.
+ * @tparam Executor The executor to use as default completion.
+ */
+template <typename T, typename Executor = net::any_io_executor>
+struct basic_rcu
+{
+  /// The value type.
+  using value_type = T;
+  /// The executor type.
+  using executor_type = Executor;
+
+  /// A constructor. @param exec The executor to be used by the rcu. @param value The initial snapshot.
+  explicit basic_rcu(executor_type exec, T value = T(), int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)), impl_{net::query(exec_, net::execution::context), concurrency_hint},
+        current_(new detail::rcu_snapshot<T>(std::move(value)))
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the rcu. @param value The initial snapshot.
+  template <typename ExecutionContext>
+  explicit basic_rcu(ExecutionContext &ctx, T value = T(),
+                     typename std::enable_if<std::is_convertible<ExecutionContext &, net::execution_context &>::value,
+                                             int>::type concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(ctx.get_executor()), impl_(ctx, concurrency_hint), current_(new detail::rcu_snapshot<T>(std::move(value)))
+  {
+  }
+
+  /// @brief Rebind an rcu to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_rcu(basic_rcu<T, Executor_> &&sem,
+            typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_)), current_(sem.current_.exchange(nullptr))
+  {
+  }
+
+  basic_rcu(const basic_rcu &) = delete;
+  basic_rcu &operator=(const basic_rcu &) = delete;
+
+  /// Destroy the rcu. No read section may be active anymore.
+  ~basic_rcu() { delete current_.load(); }
+
+  /** Begin a read section.
+   *
+   * This is lock-free, and doesn't touch a reference count shared with other threads.
+   * It only retries if a grace period starts meanwhile, and leaving only takes a lock
+   * if it's the last read section a grace period waited for.
+   *
+   * @return A guard keeping the current snapshot alive.
+   */
+  rcu_read_guard<T> read() noexcept
+  {
+    auto &counter = impl_.read_lock();
+    return rcu_read_guard<T>(&impl_, &counter, &current_.load(std::memory_order_seq_cst)->value);
+  }
+
+  /** Replace the current snapshot.
+   *
+   * New read sections see the new snapshot right away.
+   * The replaced one is deleted after the next grace period, see `async_synchronize`,
+   * which gets started if none is running. Without any readers, that happens right away.
+   *
+   * @param value The new snapshot.
+   */
+  void publish(T value)
+  {
+    auto node = new detail::rcu_snapshot<T>(std::move(value));
+    impl_.retire(current_.exchange(node, std::memory_order_seq_cst));
+  }
+
+  /** Wait for a grace period, i.e. for all read sections that began before to end.
+   *
+   * Snapshots replaced before the call are deleted before it completes.
+   * This does not prevent new read sections from starting.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_synchronize(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_synchronize_op{this}, token);
+  }
+
+  /** Wait for a grace period synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if a read section is active.
+   *
+   * If the implementation is `mt` this function will block until the read sections have ended.
+   * Note that this deadlocks if the calling thread is in a read section itself.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void synchronize(error_code &ec) { impl_.synchronize(ec); }
+
+  /// Throwing @overload synchronize(error_code &);
+  void synchronize()
+  {
+    error_code ec;
+    synchronize(ec);
+    if (ec)
+      detail::throw_error(ec, "synchronize");
+  }
+
+  /// Rebinds the rcu type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The rcu type when rebound to the specified executor.
+    typedef basic_rcu<T, Executor1> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename, typename>
+  friend struct basic_rcu;
+
+  Executor                                  exec_;
+  detail::rcu_impl                          impl_;
+  std::atomic<detail::rcu_snapshot<T> *>    current_;
+  struct async_synchronize_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_rcu.hpp>
+
+#endif // BOOST_SAM_BASIC_RCU_HPP
@@ -0,0 +1,145 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_RECURSIVE_MUTEX_HPP
+#define BOOST_SAM_BASIC_RECURSIVE_MUTEX_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+#include <boost/sam/detail/recursive_mutex_impl.hpp>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** An asio based mutex modeled on `std::recursive_mutex`.
+ *
+ * Since asynchronous code has no thread identity to go by, the owner needs to be passed in explicitly.
+ * Any address that is unique to the owner can be used, e.g. the strand, the coroutine frame or a session object.
+ *
+ * @tparam Executor The executor to use as default completion.
+ */
+template <typename Executor = net::any_io_executor>
+struct basic_recursive_mutex
+{
+  /// The executor type.
+  using executor_type = Executor;
+
+  /// The type identifying the owner of the lock.
+  using owner_type = const void *;
+
+  /// A constructor. @param exec The executor to be used by the mutex.
+  explicit basic_recursive_mutex(executor_type exec, int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)), impl_{net::query(exec_, net::execution::context), concurrency_hint}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the mutex.
+  template <typename ExecutionContext>
+  explicit basic_recursive_mutex(
+      ExecutionContext &ctx,
+      typename std::enable_if<std::is_convertible<ExecutionContext &, net::execution_context &>::value, int>::type
+          concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(ctx.get_executor()), impl_(ctx, concurrency_hint)
+  {
+  }
+
+  /// @brief Rebind a mutex to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_recursive_mutex(basic_recursive_mutex<Executor_> &&sem,
+                        typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /** Wait for the mutex to become lockable by `owner` & lock it.
+   *
+   * If `owner` holds the lock already, this completes immediately and increases the lock depth.
+   * Every successful lock needs to be matched by an `unlock`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param owner The identity of the owner.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock(owner_type owner, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_op{this, owner}, token);
+  }
+
+  /// Move assign a mutex.
+  basic_recursive_mutex &operator=(basic_recursive_mutex &&) noexcept = default;
+
+  /// Move assign a mutex with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_recursive_mutex<Executor_> &&sem)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value, basic_recursive_mutex>::type &
+  {
+    exec_ = std::move(sem.exec_);
+    impl_ = std::move(sem.impl_);
+    return *this;
+  }
+
+  basic_recursive_mutex &operator=(const basic_recursive_mutex &) = delete;
+
+  /** Lock synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the mutex
+   * is locked by another owner.
+   *
+   * If the implementation is `mt` this function will block until the lock
+   * gets handed to `owner`. Note that this may lead to deadlocks.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void lock(owner_type owner, error_code &ec) { impl_.lock(owner, ec); }
+
+  /// Throwing @overload lock(owner_type, error_code &);
+  void lock(owner_type owner)
+  {
+    error_code ec;
+    lock(owner, ec);
+    if (ec)
+      detail::throw_error(ec, "lock");
+  }
+
+  /// Decrease the lock depth, and unlock & complete one pending lock when it drops to zero.
+  void unlock() { impl_.unlock(); }
+
+  /// Try to lock the mutex or re-enter it, if `owner` holds it already.
+  bool try_lock(owner_type owner) { return impl_.try_lock(owner); }
+
+  /// Rebinds the mutex type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The mutex type when rebound to the specified executor.
+    typedef basic_recursive_mutex<Executor1> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename>
+  friend struct basic_recursive_mutex;
+
+  Executor                     exec_;
+  detail::recursive_mutex_impl impl_;
+  struct async_lock_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_recursive_mutex.hpp>
+
+#endif // BOOST_SAM_BASIC_RECURSIVE_MUTEX_HPP
@@ -10,6 +10,10 @@
 #include <boost/sam/detail/bilist_node.hpp>
 #include <boost/sam/detail/exception.hpp>
 #include <boost/sam/detail/semaphore_impl.hpp>
+#include <boost/sam/detail/timed_op_model.hpp>
+#include <boost/sam/semaphore_lease.hpp>
+
+#include <chrono>
 
 #if defined(BOOST_SAM_STANDALONE)
 #include <asio/any_io_executor.hpp>
@@ -113,7 +117,87 @@ struct basic_semaphore
   template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
                 CompletionHandler BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
   BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code))
-  async_acquire(CompletionHandler &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type));
+  async_acquire(CompletionHandler &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type),
+                typename std::enable_if<!std::is_integral<typename std::decay<CompletionHandler>::type>::value>::type * =
+                    nullptr);
+
+  /// @brief Initiate an asynchronous acquire of the semaphore, ahead of lower priority waiters.
+  /// @details Works like the overload without a priority, but when the
+  /// semaphore gets released, the first waiter with the highest priority
+  /// acquires it. Waiters of the same priority are served in FIFO order.
+  /// @param priority The priority of this waiter, from 0 (the default) to 7.
+  /// Larger values get clamped.
+  /// @param token is a completion token or handler matching the signature
+  /// void(error_code)
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionHandler BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code))
+  async_acquire(std::size_t priority, CompletionHandler &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type));
+
+  /// @brief Initiate an asynchronous acquire of `n` permits at once.
+  /// @details Works like async_acquire, but completes once all `n` permits
+  /// could be taken together. By default, a release hands permits to every
+  /// waiter that fits in one pass, so smaller waiters can overtake a larger
+  /// one. Use set_strict_fifo to prevent that.
+  /// It's not an overload of async_acquire, since that one takes a priority.
+  /// @param n The number of permits, which must be positive.
+  /// @param token is a completion token or handler matching the signature
+  /// void(error_code)
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionHandler BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code))
+  async_acquire_n(int n, CompletionHandler &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type));
+
+  /// @brief Initiate an asynchronous acquire of whatever is available, up to `n` permits.
+  /// @details Waits for at least one permit, and then takes as many more as
+  /// are available right away, up to `n` in total.
+  /// @param n The maximum number of permits, which must be positive.
+  /// @param token is a completion token or handler matching the signature
+  /// void(error_code, int), which receives the number of permits taken.
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code, int))
+                CompletionHandler BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code, int))
+  async_acquire_up_to(int n, CompletionHandler &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type));
+
+  /// @brief Initiate an asynchronous acquire of the semaphore, that gives up at a deadline.
+  /// @details Works like the overload without a deadline, but if the
+  /// semaphore could not be acquired before the deadline, the completion
+  /// handler will be invoked with error::timed_out.
+  /// @param deadline The point in time the operation times out at.
+  /// @param token is a completion token or handler matching the signature
+  /// void(error_code)
+  template <typename Clock, typename Duration,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionHandler BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code))
+  async_acquire_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                      CompletionHandler &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type));
+
+  /// @brief Initiate an asynchronous acquire of the semaphore, that gives up after a timeout.
+  /// @details Works like async_acquire_until with a deadline of now + timeout.
+  /// @param timeout The time to wait at most.
+  /// @param token is a completion token or handler matching the signature
+  /// void(error_code)
+  template <typename Rep, typename Period,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionHandler BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code))
+  async_acquire_for(const std::chrono::duration<Rep, Period> &timeout,
+                    CompletionHandler &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type));
+
+  /// @brief Initiate an asynchronous acquire of a lease on a permit.
+  /// @details Works like async_acquire, but the permit gets reclaimed & handed to the next waiter
+  /// if the lease isn't renewed or released within `ttl`, so a stuck holder can't keep it forever.
+  /// Releasing the lease after it expired does nothing.
+  /// @param ttl The time the lease is valid for, starting when the permit gets acquired.
+  /// @param token is a completion token or handler matching the signature
+  /// void(error_code, semaphore_lease)
+  template <typename Rep, typename Period,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code, semaphore_lease))
+                CompletionHandler BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code, semaphore_lease))
+  async_acquire_lease(const std::chrono::duration<Rep, Period> &ttl,
+                      CompletionHandler &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type));
 
   /** Acquire synchronously. This may fail depending on the implementation.
    *
@@ -137,21 +221,98 @@ struct basic_semaphore
       detail::throw_error(ec, "acquire");
   }
 
+  /// Acquire `n` permits synchronously, see acquire(error_code &).
+  void acquire(int n, error_code &ec) { impl_.acquire(ec, n); }
+
+  /// Throwing @overload acquire(int, error_code &);
+  void acquire(int n)
+  {
+    error_code ec;
+    acquire(n, ec);
+    if (ec)
+      detail::throw_error(ec, "acquire");
+  }
+
+  /// Acquire a lease on a permit synchronously, see acquire(error_code &) & async_acquire_lease.
+  template <typename Rep, typename Period>
+  semaphore_lease acquire_lease(const std::chrono::duration<Rep, Period> &ttl, error_code &ec)
+  {
+    impl_.acquire(ec);
+    if (ec)
+      return semaphore_lease();
+    return semaphore_lease(
+        impl_, impl_.add_lease(std::chrono::duration_cast<std::chrono::steady_clock::duration>(ttl), exec_));
+  }
+
+  /// Throwing @overload acquire_lease(const std::chrono::duration<Rep, Period> &, error_code &);
+  template <typename Rep, typename Period>
+  semaphore_lease acquire_lease(const std::chrono::duration<Rep, Period> &ttl)
+  {
+    error_code ec;
+    auto       l = acquire_lease(ttl, ec);
+    if (ec)
+      detail::throw_error(ec, "acquire_lease");
+    return l;
+  }
+
   /// @brief Attempt to immediately acquire the semaphore.
   /// @details This function attempts to acquire the semaphore without
   /// blocking or initiating an asynchronous operation.
   /// @returns true if the semaphore was acquired, false otherwise
   BOOST_SAM_DECL bool try_acquire() { return impl_.try_acquire(); }
 
+  /// @brief Attempt to immediately acquire `n` permits at once.
+  /// @returns true if the permits were acquired, false otherwise
+  bool try_acquire(int n) { return impl_.try_acquire(n); }
+
   /// @brief Release the sempahore.
   /// @details This function immediately releases the semaphore. If there are
   /// pending async_acquire operations, then the least recent operation will
   /// commence completion.
   BOOST_SAM_DECL void release() { impl_.release(); }
 
+  /// @brief Release `n` permits.
+  /// @details Hands the permits to as many pending waiters as fit, in one pass.
+  void release(int n) { impl_.release(n); }
+
+  /// @brief Keep the waiters in strict FIFO order.
+  /// @details By default, permits go to every waiter that fits, so a waiter for many
+  /// permits can be overtaken by smaller ones. If strict, a waiter that doesn't fit
+  /// blocks everyone behind it, and new acquires queue up behind any waiter.
+  void set_strict_fifo(bool strict) { impl_.set_strict_fifo(strict); }
+
+  /// @brief Reject acquires that would have to wait behind `n` waiters already.
+  /// @details They complete with error::try_again right away, without allocating an op.
+  /// @param n The maximum number of waiters, unlimited by default.
+  void set_max_queue_length(std::size_t n) { impl_.set_max_queue_length(n); }
+
+  /// @brief Shed waiters once the queue delay stays above `target`, like CoDel does.
+  /// @details Once the time waiters spend in the queue stayed above `target` for `interval`,
+  /// waiters get dropped from the head with error::try_again instead of getting their permits,
+  /// at an increasing rate until the delay gets below the target again.
+  /// Additionally, async_acquire_until & async_acquire_for fail right away with error::try_again
+  /// if their deadline is closer than the current queue delay, and queued ones fail with error::try_again
+  /// once the queue delay grew beyond the time between their enqueueing & their deadline.
+  /// @param target The acceptable queue delay, zero disables shedding (the default).
+  /// @param interval The time the delay may stay above the target, roughly a worst case round trip.
+  void set_queue_delay_target(std::chrono::steady_clock::duration target,
+                              std::chrono::steady_clock::duration interval = std::chrono::milliseconds(100))
+  {
+    impl_.set_queue_delay_target(target, interval);
+  }
+
+  /// @brief Enable aging of waiters, so low priority waiters can't starve.
+  /// @details Every `wakeups` times the semaphore gets handed to a waiter,
+  /// the first waiter of every priority gets moved up by one priority.
+  /// @param wakeups The number of wakeups between agings, 0 disables aging (the default).
+  void set_aging(std::size_t wakeups) { impl_.set_aging(wakeups); }
+
   /// The current value of the semaphore
   BOOST_SAM_NODISCARD BOOST_SAM_DECL int value() const noexcept { return impl_.value(); }
 
+  /// The number of leases that neither expired nor got released yet.
+  BOOST_SAM_NODISCARD std::size_t leases() const { return impl_.leases(); }
+
 private:
   template <typename>
   friend struct basic_semaphore;
@@ -159,6 +320,9 @@ private:
   executor_type       exec_;
   implementation_type impl_;
   struct async_aquire_op;
+  struct async_aquire_up_to_op;
+  struct async_aquire_until_op;
+  struct async_aquire_lease_op;
 };
 
 BOOST_SAM_END_NAMESPACE
@@ -0,0 +1,298 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_SEQLOCK_HPP
+#define BOOST_SAM_BASIC_SEQLOCK_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+#include <boost/sam/detail/seqlock_impl.hpp>
+#include <boost/sam/detail/timed_op_model.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** A sequence lock, holding a small value that is read far more often than written.
+ *
+ * Readers copy the value optimistically & retry if a write happened in between,
+ * so they never write to shared memory and never wait on writers.
+ * Writers are serialized through a mutex, with the same interface as `basic_mutex`.
+ *
+ * @tparam T The value type, which must be trivially copyable.
+ * @tparam Executor The executor to use as default completion.
+ */
+template <typename T, typename Executor = net::any_io_executor>
+struct basic_seqlock
+{
+  static_assert(std::is_trivially_copyable<T>::value, "basic_seqlock requires a trivially copyable value type");
+  static_assert(std::is_default_constructible<T>::value, "basic_seqlock requires a default constructible value type");
+
+  /// The value type.
+  using value_type = T;
+  /// The executor type.
+  using executor_type = Executor;
+
+  /// A constructor. @param exec The executor to be used by the seqlock. @param value The initial value.
+  explicit basic_seqlock(executor_type exec, const T &value = T(),
+                         int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)), impl_{net::query(exec_, net::execution::context), concurrency_hint}
+  {
+    write_value(value);
+  }
+
+  /// A constructor. @param ctx The execution context used by the seqlock. @param value The initial value.
+  template <typename ExecutionContext>
+  explicit basic_seqlock(ExecutionContext &ctx, const T &value = T(),
+                         typename std::enable_if<std::is_convertible<ExecutionContext &, net::execution_context &>::value,
+                                                 int>::type concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(ctx.get_executor()), impl_(ctx, concurrency_hint)
+  {
+    write_value(value);
+  }
+
+  /// @brief Rebind a seqlock to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_seqlock(basic_seqlock<T, Executor_> &&sem,
+                typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+    write_value(sem.read_value());
+  }
+
+  /** Wait for the write lock & lock it.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_op{this, 0u}, token);
+  }
+
+  /** Wait for the write lock & lock it, ahead of waiters with a lower priority.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param priority The priority, see `basic_mutex::async_lock`.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock(std::size_t priority, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_op{this, priority}, token);
+  }
+
+  /** Wait for the write lock & lock it, unless the deadline passes first.
+   *
+   * If the deadline passes first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param deadline The point in time the operation times out at.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Clock, typename Duration,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                   CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_until_op{this, detail::to_steady_time(deadline)}, token);
+  }
+
+  /** Wait for the write lock & lock it, unless the timeout expires first.
+   *
+   * If the timeout expires first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param timeout The time to wait at most.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Rep, typename Period,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_for(const std::chrono::duration<Rep, Period> &timeout,
+                 CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_until_op{this, detail::deadline_after(timeout)}, token);
+  }
+
+  /** Wait for the version to move past `version`.
+   *
+   * Completes immediately if a newer version has been stored already.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param version The version to wait past, usually the one last read.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_wait_for_version(std::uint64_t version,
+                         CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_wait_for_version_op{this, version},
+                                                                       token);
+  }
+
+  /// Move assign a seqlock.
+  basic_seqlock &operator=(basic_seqlock &&sem) noexcept
+  {
+    exec_ = std::move(sem.exec_);
+    impl_ = std::move(sem.impl_);
+    write_value(sem.read_value());
+    return *this;
+  }
+
+  /// Move assign a seqlock with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_seqlock<T, Executor_> &&sem)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value, basic_seqlock>::type &
+  {
+    exec_ = std::move(sem.exec_);
+    impl_ = std::move(sem.impl_);
+    write_value(sem.read_value());
+    return *this;
+  }
+
+  basic_seqlock &operator=(const basic_seqlock &) = delete;
+
+  /** Lock synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the seqlock
+   * is already locked.
+   *
+   * If the implementation is `mt` this function will block until another thread releases
+   * the lock. Note that this may lead to deadlocks.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void lock(error_code &ec) { impl_.lock(ec); }
+
+  /// Throwing @overload lock(error_code &);
+  void lock()
+  {
+    error_code ec;
+    lock(ec);
+    if (ec)
+      detail::throw_error(ec, "lock");
+  }
+  /// Unlock the write lock, and complete one pending lock if pending.
+  void unlock() { impl_.unlock(); }
+
+  ///  Try to lock the write lock.
+  bool try_lock() { return impl_.try_lock(); }
+
+  /** Store a new value & bump the version.
+   *
+   * This must only be called while holding the write lock.
+   * Waiters for an older version are completed.
+   */
+  void store(const T &value)
+  {
+    impl_.write_begin();
+    write_value(value);
+    impl_.write_end();
+  }
+
+  /// Read the current value. This never waits on the write lock.
+  T load() const
+  {
+    std::uint64_t version;
+    return load(version);
+  }
+
+  /// Read the current value along with its version. This never waits on the write lock.
+  T load(std::uint64_t &version) const
+  {
+    for (;;)
+    {
+      const auto seq   = impl_.read_begin();
+      T          value = read_value();
+      if (!impl_.read_retry(seq))
+      {
+        version = seq >> 1u;
+        return value;
+      }
+    }
+  }
+
+  /// The version of the value, i.e. the number of stores so far.
+  std::uint64_t version() const noexcept { return impl_.version(); }
+
+  /// Rebinds the seqlock type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The seqlock type when rebound to the specified executor.
+    typedef basic_seqlock<T, Executor1> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <typename, typename>
+  friend struct basic_seqlock;
+  friend struct lock_guard;
+
+  // the value is copied word by word with relaxed atomics, so a torn read is not a data race.
+  using word_type                    = std::uintptr_t;
+  constexpr static std::size_t words = (sizeof(T) + sizeof(word_type) - 1u) / sizeof(word_type);
+
+  T read_value() const noexcept
+  {
+    word_type buf[words];
+    for (std::size_t i = 0u; i < words; i++)
+      buf[i] = data_[i].load(std::memory_order_relaxed);
+    T value;
+    std::memcpy(&value, buf, sizeof(T));
+    return value;
+  }
+
+  void write_value(const T &value) noexcept
+  {
+    word_type buf[words] = {};
+    std::memcpy(buf, &value, sizeof(T));
+    for (std::size_t i = 0u; i < words; i++)
+      data_[i].store(buf[i], std::memory_order_relaxed);
+  }
+
+  Executor                 exec_;
+  detail::seqlock_impl     impl_;
+  std::atomic<word_type>   data_[words];
+  struct async_lock_op;
+  struct async_lock_until_op;
+  struct async_wait_for_version_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_seqlock.hpp>
+
+#endif // BOOST_SAM_BASIC_SEQLOCK_HPP
@@ -11,6 +11,9 @@
 #include <boost/sam/detail/config.hpp>
 #include <boost/sam/detail/exception.hpp>
 #include <boost/sam/detail/shared_mutex_impl.hpp>
+#include <boost/sam/detail/timed_op_model.hpp>
+
+#include <chrono>
 
 #if defined(BOOST_SAM_STANDALONE)
 #include <asio/any_io_executor.hpp>
@@ -22,6 +25,8 @@
 
 BOOST_SAM_BEGIN_NAMESPACE
 
+struct lock_guard;
+struct shared_lock_guard;
 
 /** An asio based mutex modeled on `std::mutex`.
  *
@@ -50,6 +55,31 @@ struct basic_shared_mutex
   {
   }
 
+  /** A constructor selecting the fairness policy.
+   *
+   * @param exec The executor to be used by the mutex.
+   * @param policy Decides whether waiting readers or writers get the lock first.
+   */
+  basic_shared_mutex(executor_type exec, shared_mutex_policy policy,
+                     int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)), impl_{net::query(exec_, net::execution::context), concurrency_hint, policy}
+  {
+  }
+
+  /** A constructor selecting the fairness policy.
+   *
+   * @param ctx The execution context used by the mutex.
+   * @param policy Decides whether waiting readers or writers get the lock first.
+   */
+  template <typename ExecutionContext>
+  basic_shared_mutex(ExecutionContext &ctx, shared_mutex_policy policy,
+                     int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT,
+                     typename std::enable_if<std::is_convertible<ExecutionContext &, net::execution_context &>::value>::type
+                         * = nullptr)
+      : exec_(ctx.get_executor()), impl_(ctx, concurrency_hint, policy)
+  {
+  }
+
   /// @brief Rebind a mutex to a new executor - this cancels all outstanding operations.
   template <typename Executor_>
   basic_shared_mutex(basic_shared_mutex<Executor_> &&sem,
@@ -80,6 +110,163 @@ struct basic_shared_mutex
     return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_shared_op{this}, token);
   }
 
+  /** Wait for the mutex to become lockable & lock it, unless the deadline passes first.
+   *
+   * If the deadline passes first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param deadline The point in time the operation times out at.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Clock, typename Duration,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                   CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_until_op{this, detail::to_steady_time(deadline)}, token);
+  }
+
+  /** Wait for the mutex to become lockable & lock it, unless the timeout expires first.
+   *
+   * If the timeout expires first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param timeout The time to wait at most.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Rep, typename Period,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_for(const std::chrono::duration<Rep, Period> &timeout,
+                 CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_until_op{this, detail::deadline_after(timeout)}, token);
+  }
+
+  /** Wait for the mutex to become lockable in shared mode & lock it, unless the deadline passes first.
+   *
+   * If the deadline passes first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param deadline The point in time the operation times out at.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Clock, typename Duration,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_shared_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                          CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_shared_until_op{this, detail::to_steady_time(deadline)}, token);
+  }
+
+  /** Wait for the mutex to become lockable in shared mode & lock it, unless the timeout expires first.
+   *
+   * If the timeout expires first, the operation completes with `net::error::timed_out`.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param timeout The time to wait at most.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <typename Rep, typename Period,
+            BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_shared_for(const std::chrono::duration<Rep, Period> &timeout,
+                        CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(
+        async_lock_shared_until_op{this, detail::deadline_after(timeout)}, token);
+  }
+
+  /** Let pending operations take the mutex & requeue for an exclusive lock, without unlocking in between.
+   *
+   * This must only be called while holding an exclusive lock.
+   * If other operations are waiting, the lock is handed to them and this operation
+   * completes once an exclusive lock has been passed back to it.
+   * Otherwise it completes immediately, still holding the lock.
+   *
+   * If the operation completes with an error, the lock is no longer held.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_yield(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_yield_op{this}, token);
+  }
+
+  /** Let pending exclusive operations take the mutex & requeue for a shared lock.
+   *
+   * This must only be called while holding a shared lock.
+   * If exclusive operations are waiting, the shared lock is released in their favour and this operation
+   * completes once a shared lock has been reacquired. Otherwise it completes immediately, still holding the shared lock.
+   *
+   * If the operation completes with an error, the shared lock is no longer held.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_relock_shared(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_relock_shared_op{this}, token);
+  }
+
+  /** Wait for the mutex to become lockable in upgrade mode & lock it.
+   *
+   * The upgrade lock is shared with readers, but not with writers or other upgraders,
+   * so that it can be turned into an exclusive lock with `async_upgrade` without unlocking in between.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_upgrade(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_upgrade_op{this}, token);
+  }
+
+  /** Turn the upgrade lock into an exclusive lock, once the readers have unlocked.
+   *
+   * This must only be called while holding the upgrade lock.
+   * New readers & writers are held back while the upgrade is pending.
+   *
+   * If the operation completes with an error, the upgrade lock is still held.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_upgrade(CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_upgrade_op{this}, token);
+  }
+
   /// Move assign a mutex.
   basic_shared_mutex &operator=(basic_shared_mutex &&) noexcept = default;
 
@@ -139,6 +326,43 @@ struct basic_shared_mutex
   ///  Try to lock the mutex.
   bool try_lock_shared() { return impl_.try_lock_shared(); }
 
+  /** Turn the exclusive lock into a shared lock, without unlocking in between.
+   *
+   * This must only be called while holding the exclusive lock.
+   * All pending shared locks are admitted along with it, while pending exclusive locks keep waiting.
+   */
+  void downgrade() { impl_.downgrade(); }
+
+  /** Lock in upgrade mode synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the mutex
+   * is locked exclusively or for upgrade.
+   *
+   * If the implementation is `mt` this function will block until another thread releases
+   * the lock. Note that this may lead to deadlocks.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void lock_upgrade(error_code &ec) { impl_.lock_upgrade(ec); }
+
+  /// Throwing @overload lock_upgrade(error_code &);
+  void lock_upgrade()
+  {
+    error_code ec;
+    lock_upgrade(ec);
+    if (ec)
+      detail::throw_error(ec, "lock_upgrade");
+  }
+  /// Unlock the upgrade lock, and complete pending locks it held back.
+  void unlock_upgrade() { impl_.unlock_upgrade(); }
+
+  ///  Try to lock the mutex in upgrade mode.
+  bool try_lock_upgrade() { return impl_.try_lock_upgrade(); }
+
+  /// Try to turn the upgrade lock into an exclusive lock, which succeeds if no reader holds the mutex.
+  bool try_upgrade() { return impl_.try_upgrade(); }
+
   /// Rebinds the mutex type to another executor.
   template <typename Executor1>
   struct rebind_executor
@@ -154,11 +378,21 @@ private:
   template <typename>
   friend struct basic_shared_mutex;
   friend struct lock_guard;
+  friend struct shared_lock_guard;
+  friend struct upgrade_lock_guard;
+  template <typename Executor_>
+  friend shared_lock_guard downgrade(basic_shared_mutex<Executor_> &mtx, lock_guard &&lock);
 
   Executor           exec_;
   detail::shared_mutex_impl impl_;
   struct async_lock_op;
+  struct async_lock_until_op;
+  struct async_lock_shared_until_op;
   struct async_lock_shared_op;
+  struct async_yield_op;
+  struct async_relock_shared_op;
+  struct async_lock_upgrade_op;
+  struct async_upgrade_op;
 };
 
 BOOST_SAM_END_NAMESPACE
@@ -0,0 +1,191 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_BASIC_STRIPED_MUTEX_HPP
+#define BOOST_SAM_BASIC_STRIPED_MUTEX_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/exception.hpp>
+#include <boost/sam/detail/striped_mutex_impl.hpp>
+
+#include <array>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#include <asio/compose.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/compose.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** A fixed table of asio based mutexes, selected by hash.
+ *
+ * This allows locking per object in key spaces too large for a mutex each,
+ * at the cost of unrelated objects sometimes sharing a stripe.
+ *
+ * @tparam Stripes The number of mutexes.
+ * @tparam Executor The executor to use as default completion.
+ */
+template <std::size_t Stripes, typename Executor = net::any_io_executor>
+struct basic_striped_mutex
+{
+  static_assert(Stripes > 0u, "a striped mutex needs at least one stripe");
+
+  /// The executor type.
+  using executor_type = Executor;
+
+  /// The number of stripes.
+  constexpr static std::size_t stripes = Stripes;
+
+  /// The stripe a hash maps to.
+  static std::size_t stripe_of(std::size_t hash) noexcept { return detail::striped_mutex_impl::index_of(hash, Stripes); }
+
+  /// A constructor. @param exec The executor to be used by the striped mutex.
+  explicit basic_striped_mutex(executor_type exec, int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(std::move(exec)), impl_{net::query(exec_, net::execution::context), Stripes, concurrency_hint}
+  {
+  }
+
+  /// A constructor. @param ctx The execution context used by the striped mutex.
+  template <typename ExecutionContext>
+  explicit basic_striped_mutex(ExecutionContext &ctx,
+                               typename std::enable_if<std::is_convertible<ExecutionContext &,
+                                                                           net::execution_context &>::value,
+                                                       int>::type concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : exec_(ctx.get_executor()), impl_(ctx, Stripes, concurrency_hint)
+  {
+  }
+
+  /// @brief Rebind a striped mutex to a new executor - this cancels all outstanding operations.
+  template <typename Executor_>
+  basic_striped_mutex(basic_striped_mutex<Stripes, Executor_> &&sem,
+                      typename std::enable_if<std::is_convertible<Executor_, executor_type>::value>::type * = nullptr)
+      : exec_(sem.get_executor()), impl_(std::move(sem.impl_))
+  {
+  }
+
+  /** Wait for the stripe of `hash` to become lockable & lock it.
+   *
+   * @tparam CompletionToken The completion token type.
+   * @param hash The hash of the object to lock.
+   * @param token The token for completion.
+   * @return Deduced from the token.
+   */
+  template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code))
+                CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock(std::size_t hash, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return net::async_initiate<CompletionToken, void(std::error_code)>(async_lock_op{this, stripe_of(hash)}, token);
+  }
+
+  /** Lock the stripes of multiple hashes.
+   *
+   * The stripes get locked one after another in stripe order, so two of these can't deadlock.
+   * Hashes mapping to the same stripe lock it only once.
+   *
+   * On success, all stripes are held, on error none are.
+   * Release them with `unlock_all` passing the same hashes.
+   *
+   * @param token The token for completion.
+   * @param hash The hashes of the objects to lock.
+   * @return Deduced from the token.
+   */
+  template <typename CompletionToken, typename... Hashes>
+  BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+  async_lock_all(CompletionToken &&token, std::size_t hash, Hashes... hashes)
+  {
+    using op_type = async_lock_all_op<sizeof...(Hashes) + 1u>;
+    return net::async_compose<CompletionToken, void(error_code)>(
+        op_type{this, {{stripe_of(hash), stripe_of(static_cast<std::size_t>(hashes))...}}}, token, exec_);
+  }
+
+  /// Move assign a striped mutex.
+  basic_striped_mutex &operator=(basic_striped_mutex &&lhs) noexcept
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  /// Move assign a striped mutex with a different executor.
+  template <typename Executor_>
+  auto operator=(basic_striped_mutex<Stripes, Executor_> &&lhs)
+      -> typename std::enable_if<std::is_convertible<Executor_, executor_type>::value, basic_striped_mutex>::type &
+  {
+    exec_ = std::move(lhs.exec_);
+    impl_ = std::move(lhs.impl_);
+    return *this;
+  }
+
+  basic_striped_mutex &operator=(const basic_striped_mutex &) = delete;
+
+  /** Lock synchronously. This may fail depending on the implementation.
+   *
+   * If the implementation is `st` this will generate an error if the stripe
+   * is already locked.
+   *
+   * If the implementation is `mt` this function will block until another thread releases
+   * the stripe. Note that this may lead to deadlocks.
+   *
+   * You should never use the synchronous functions from within an asio event-queue.
+   *
+   */
+  void lock(std::size_t hash, error_code &ec) { impl_.lock(stripe_of(hash), ec); }
+
+  /// Throwing @overload lock(std::size_t, error_code &);
+  void lock(std::size_t hash)
+  {
+    error_code ec;
+    lock(hash, ec);
+    if (ec)
+      detail::throw_error(ec, "lock");
+  }
+
+  /// Unlock the stripe of `hash`, and complete pending locks if pending.
+  void unlock(std::size_t hash) { impl_.unlock(stripe_of(hash)); }
+
+  /// Try to lock the stripe of `hash`.
+  bool try_lock(std::size_t hash) { return impl_.try_lock(stripe_of(hash)); }
+
+  /// Unlock the stripes locked by `async_lock_all`.
+  template <typename... Hashes>
+  void unlock_all(std::size_t hash, Hashes... hashes)
+  {
+    std::array<std::size_t, sizeof...(Hashes) + 1u> s{{stripe_of(hash), stripe_of(static_cast<std::size_t>(hashes))...}};
+    const auto n = detail::order_stripes(s);
+    for (std::size_t i = n; i-- > 0u;)
+      impl_.unlock(s[i]);
+  }
+
+  /// Rebinds the striped mutex type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The striped mutex type when rebound to the specified executor.
+    typedef basic_striped_mutex<Stripes, Executor1> other;
+  };
+
+  /// @brief return the default executor.
+  executor_type get_executor() const noexcept { return exec_; }
+
+private:
+  template <std::size_t, typename>
+  friend struct basic_striped_mutex;
+
+  Executor                   exec_;
+  detail::striped_mutex_impl impl_;
+
+  struct async_lock_op;
+  template <std::size_t Size>
+  struct async_lock_all_op;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#include <boost/sam/impl/basic_striped_mutex.hpp>
+
+#endif // BOOST_SAM_BASIC_STRIPED_MUTEX_HPP
@@ -0,0 +1,81 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_ADAPTIVE_LIMITER_IMPL_HPP
+#define BOOST_SAM_DETAIL_ADAPTIVE_LIMITER_IMPL_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/semaphore_impl.hpp>
+
+#include <atomic>
+#include <chrono>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A semaphore whose count is the limit minus the permits in flight. The limit follows
+// the gradient of the latency (like Netflix's Gradient2): while the latency stays close to
+// its long term average the limit grows by about the square root of itself, and it shrinks
+// as the latency rises. Failed operations back off multiplicatively.
+// Shrinking the limit can drive the count below zero, so permits held are never revoked,
+// instead acquires block until enough of them got released.
+struct adaptive_limiter_impl : semaphore_impl
+{
+  using clock_type = std::chrono::steady_clock;
+
+  BOOST_SAM_DECL adaptive_limiter_impl(net::execution_context &ctx, int initial_limit, int min_limit, int max_limit,
+                                       int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT);
+
+  adaptive_limiter_impl(const adaptive_limiter_impl &) = delete;
+  adaptive_limiter_impl(adaptive_limiter_impl &&mi)
+      : semaphore_impl(std::move(mi)), limit_(mi.limit_.load()), min_(mi.min_), max_(mi.max_),
+        estimate_(mi.estimate_), long_rtt_(mi.long_rtt_), samples_(mi.samples_)
+  {
+  }
+
+  adaptive_limiter_impl &operator=(const adaptive_limiter_impl &) = delete;
+  adaptive_limiter_impl &operator=(adaptive_limiter_impl &&lhs) noexcept
+  {
+    semaphore_impl::operator=(std::move(lhs));
+    limit_    = lhs.limit_.load();
+    min_      = lhs.min_;
+    max_      = lhs.max_;
+    estimate_ = lhs.estimate_;
+    long_rtt_ = lhs.long_rtt_;
+    samples_  = lhs.samples_;
+    return *this;
+  }
+
+  using semaphore_impl::release;
+
+  // Release a permit & update the limit with the latency & outcome of the operation it guarded.
+  BOOST_SAM_DECL void release(clock_type::duration rtt, bool dropped);
+
+  BOOST_SAM_NODISCARD int limit() const noexcept { return limit_.load(); }
+  // Can exceed the limit right after it shrank.
+  BOOST_SAM_NODISCARD int in_flight() const noexcept { return limit_.load() - count(); }
+
+private:
+  // The new estimate of the limit. Requires mtx_ to be held.
+  BOOST_SAM_DECL double next_estimate(double rtt, bool dropped, int in_flight);
+
+  std::atomic<int> limit_;
+  int              min_, max_;
+  double           estimate_;
+  // the average latency in nanoseconds over about the last long_window samples.
+  double           long_rtt_ = 0.;
+  int              samples_  = 0;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/adaptive_limiter_impl.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_ADAPTIVE_LIMITER_IMPL_HPP
@@ -0,0 +1,97 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_ALIGNED_ARRAY_HPP
+#define BOOST_SAM_DETAIL_ALIGNED_ARRAY_HPP
+
+#include <boost/sam/detail/config.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A fixed size array, that keeps the alignment of T even if it's over-aligned.
+// operator new & std::allocator don't have to honor that before C++17, so the storage gets aligned by hand.
+template <typename T>
+struct aligned_array
+{
+  aligned_array() noexcept = default;
+
+  // Construct every element from the same arguments.
+  template <typename... Args>
+  explicit aligned_array(std::size_t size, const Args &...args)
+  {
+    std::size_t space = sizeof(T) * size + alignof(T);
+    storage_          = ::operator new(space);
+    void *p           = storage_;
+    data_             = static_cast<T *>(std::align(alignof(T), sizeof(T) * size, p, space));
+    try
+    {
+      for (; size_ < size; size_++)
+        new (data_ + size_) T(args...);
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+  }
+
+  aligned_array(const aligned_array &)            = delete;
+  aligned_array &operator=(const aligned_array &) = delete;
+
+  aligned_array(aligned_array &&lhs) noexcept : storage_(lhs.storage_), data_(lhs.data_), size_(lhs.size_)
+  {
+    lhs.storage_ = nullptr;
+    lhs.data_    = nullptr;
+    lhs.size_    = 0u;
+  }
+
+  aligned_array &operator=(aligned_array &&lhs) noexcept
+  {
+    clear();
+    std::swap(storage_, lhs.storage_);
+    std::swap(data_, lhs.data_);
+    std::swap(size_, lhs.size_);
+    return *this;
+  }
+
+  ~aligned_array() { clear(); }
+
+  std::size_t size() const noexcept { return size_; }
+
+  T       &operator[](std::size_t idx) noexcept { return data_[idx]; }
+  const T &operator[](std::size_t idx) const noexcept { return data_[idx]; }
+
+  T       *begin() noexcept { return data_; }
+  T       *end() noexcept { return data_ + size_; }
+  const T *begin() const noexcept { return data_; }
+  const T *end() const noexcept { return data_ + size_; }
+
+private:
+  void clear() noexcept
+  {
+    while (size_ > 0u)
+      data_[--size_].~T();
+    ::operator delete(storage_);
+    storage_ = nullptr;
+    data_    = nullptr;
+  }
+
+  void       *storage_ = nullptr;
+  T          *data_    = nullptr;
+  std::size_t size_    = 0u;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_ALIGNED_ARRAY_HPP
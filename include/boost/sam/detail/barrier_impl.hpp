@@ -11,12 +11,19 @@
 #include <boost/sam/detail/service.hpp>
 
 #include <mutex>
+#include <utility>
 
 BOOST_SAM_BEGIN_NAMESPACE
 
 namespace detail
 {
 
+// A timed arrival, which withdraws itself from the count of its barrier_impl when it expires.
+struct barrier_timed_wait_op : wait_op
+{
+  BOOST_SAM_DECL void on_expire(service_member *owner);
+};
+
 struct barrier_impl : detail::service_member
 {
   barrier_impl(net::execution_context &ctx, std::ptrdiff_t init,
@@ -30,14 +37,20 @@ struct barrier_impl : detail::service_member
       : detail::service_member(std::move(rhs)), init_(rhs.init_), counter_(rhs.counter_),
         waiters_(std::move(rhs.waiters_))
   {
+    lock_type _{rhs.mtx_};
+    adopt_timers<wait_op>(waiters_);
   }
 
   barrier_impl &operator=(barrier_impl &&rhs) noexcept
   {
     detail::service_member::operator=(std::move(rhs));
+    lock_type _{mtx_};
+    lock_type l{rhs.mtx_};
     init_    = rhs.init_;
-    waiters_ = std::move(rhs.waiters_);
-    counter_ = rhs.counter_;
+    std::swap(waiters_, rhs.waiters_);
+    std::swap(counter_, rhs.counter_);
+    adopt_timers<wait_op>(waiters_);
+    rhs.adopt_timers<wait_op>(rhs.waiters_);
     return *this;
   }
 
@@ -17,6 +17,9 @@ BOOST_SAM_BEGIN_NAMESPACE
 
 namespace detail
 {
+struct service_member;
+struct timer_entry;
+
 template <typename Signature>
 struct basic_op;
 
@@ -25,6 +28,12 @@ struct basic_op<void(Ts...)> : detail::bilist_node
 {
   virtual void shutdown()      = 0;
   virtual void complete(Ts...) = 0;
+
+  // Called by timed_op with the owner's mutex held, right before it completes with net::error::timed_out.
+  // An op can hide it to update the bookkeeping of its owner.
+  void on_expire(service_member *) {}
+  // The timer entry of a timed op, so an owner that gets moved can take its timed waiters along.
+  virtual timer_entry *timer() noexcept { return nullptr; }
 };
 
 using wait_op = basic_op<void(error_code)>;
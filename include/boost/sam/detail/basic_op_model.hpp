@@ -28,11 +28,12 @@ BOOST_SAM_BEGIN_NAMESPACE
 
 namespace detail
 {
-template <class Executor, class Handler, class Signature>
+// Base can be used to attach extra state to the op, it needs to derive from basic_op<Signature>.
+template <class Executor, class Handler, class Signature, class Base = basic_op<Signature>>
 struct basic_op_model;
 
-template <class Executor, class Handler, class... Ts>
-struct basic_op_model<Executor, Handler, void(Ts...)> final : basic_op<void(Ts...)>
+template <class Executor, class Handler, class Base, class... Ts>
+struct basic_op_model<Executor, Handler, void(Ts...), Base> final : Base
 {
   using executor_type          = Executor;
   using cancellation_slot_type = net::associated_cancellation_slot_t<Handler>;
@@ -0,0 +1,129 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_BIASED_SHARED_MUTEX_IMPL_HPP
+#define BOOST_SAM_DETAIL_BIASED_SHARED_MUTEX_IMPL_HPP
+
+#include <boost/sam/detail/aligned_array.hpp>
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/service.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A shared mutex, where readers only touch a per-thread counter while no writer is around, in the spirit of BRAVO.
+//
+// Every shared lock is counted in one of the slots, whichever path it took, so the number of readers is the sum over all
+// slots. A writer revokes the bias, which sends new readers through mtx_, and waits for the slots to drain;
+// the reader bringing the sum down to zero hands over the lock.
+struct biased_shared_mutex_impl : detail::service_member
+{
+  BOOST_SAM_DECL biased_shared_mutex_impl(net::execution_context &ctx,
+                                          int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT);
+
+  BOOST_SAM_DECL void lock(error_code &ec);
+  BOOST_SAM_DECL bool try_lock();
+  BOOST_SAM_DECL void unlock();
+
+  BOOST_SAM_DECL void lock_shared(error_code &ec);
+  BOOST_SAM_DECL bool try_lock_shared();
+  BOOST_SAM_DECL void unlock_shared();
+
+  // Lock shared without touching mtx_, if the bias is in place.
+  BOOST_SAM_DECL bool try_lock_shared_fast() noexcept;
+
+  // Take the lock or enqueue the waiter. Returns false if the waiter got enqueued. Requires mtx_ to be held.
+  BOOST_SAM_DECL bool lock_or_add_waiter(detail::wait_op *waiter) noexcept;
+  BOOST_SAM_DECL bool lock_shared_or_add_waiter(detail::wait_op *waiter) noexcept;
+
+  // Let the readers back in, if the cancelled writer was the last one. Requires mtx_ to be held.
+  BOOST_SAM_DECL void on_writer_cancelled() noexcept;
+
+  void shutdown() override
+  {
+    lock_type l{mtx_};
+    auto w = std::move(waiters_);
+    auto s = std::move(shared_waiters_);
+    l.unlock();
+    w.shutdown();
+    s.shutdown();
+  }
+
+  // One cache line per slot, so readers on different threads don't contend.
+  struct alignas(64) reader_slot
+  {
+    std::atomic<std::ptrdiff_t> count{0};
+  };
+
+  // the bias, i.e. whether readers may bypass mtx_. Only gets set while holding mtx_.
+  std::atomic<bool>          bias_{true};
+  std::size_t                slot_count_;
+  aligned_array<reader_slot> slots_;
+
+  // a writer holds the lock or waits for the readers to drain.
+  bool locked_   = false;
+  bool draining_ = false;
+
+  detail::basic_bilist_holder<void(error_code)> waiters_;
+  detail::basic_bilist_holder<void(error_code)> shared_waiters_;
+
+  biased_shared_mutex_impl()                                 = delete;
+  biased_shared_mutex_impl(const biased_shared_mutex_impl &) = delete;
+  biased_shared_mutex_impl(biased_shared_mutex_impl &&mi)
+      : detail::service_member(std::move(mi)), bias_(mi.bias_.load()), slot_count_(mi.slot_count_),
+        slots_(std::move(mi.slots_)), locked_(mi.locked_), draining_(mi.draining_),
+        waiters_(std::move(mi.waiters_)), shared_waiters_(std::move(mi.shared_waiters_))
+  {
+    mi.locked_   = false;
+    mi.draining_ = false;
+  }
+
+  biased_shared_mutex_impl &operator=(const biased_shared_mutex_impl &lhs) = delete;
+  biased_shared_mutex_impl &operator=(biased_shared_mutex_impl &&lhs) noexcept
+  {
+    detail::service_member::operator=(std::move(lhs));
+    lock_type _{lhs.mtx_};
+    bias_.store(lhs.bias_.load());
+    slot_count_      = lhs.slot_count_;
+    slots_           = std::move(lhs.slots_);
+    locked_          = lhs.locked_;
+    draining_        = lhs.draining_;
+    lhs.locked_      = false;
+    lhs.draining_    = false;
+    waiters_         = std::move(lhs.waiters_);
+    shared_waiters_  = std::move(lhs.shared_waiters_);
+    return *this;
+  }
+
+  BOOST_SAM_DECL ~biased_shared_mutex_impl();
+
+  struct lock_op_t;
+
+private:
+  // The slot of the calling thread.
+  BOOST_SAM_DECL reader_slot &slot() noexcept;
+  // The number of shared locks held.
+  BOOST_SAM_DECL std::ptrdiff_t readers() const noexcept;
+  // Hand the lock to the first writer if the readers are gone. Requires mtx_ to be held.
+  BOOST_SAM_DECL void check_drained() noexcept;
+  // Undo a shared lock & check if a writer is waiting for it.
+  BOOST_SAM_DECL void release_slot(reader_slot &s);
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/biased_shared_mutex_impl.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_BIASED_SHARED_MUTEX_IMPL_HPP
@@ -66,21 +66,35 @@ struct bilist_node
       prev_->next_ = this;
   }
 
-  bilist_node &operator=(bilist_node &&lhs)
+  // for an empty root node
+  bilist_node &operator=(bilist_node &&lhs) noexcept
   {
     if (lhs.next_ == &lhs)
-      next_ = this;
-    else
-      next_->prev_ = this;
-
-    if (lhs.prev_ == &lhs)
-      prev_ = this;
-    else
-      prev_->next_ = this;
+    {
+      next_ = prev_ = this;
+      return *this;
+    }
+    next_        = lhs.next_;
+    prev_        = lhs.prev_;
+    next_->prev_ = this;
+    prev_->next_ = this;
+    lhs.next_ = lhs.prev_ = &lhs;
     return *this;
   }
 };
 
+// Move the ring of `from` into the empty `to`.
+inline void take_ring(bilist_node &to, bilist_node &from) noexcept
+{
+  if (from.next_ == &from)
+    return;
+  to.next_        = from.next_;
+  to.prev_        = from.prev_;
+  to.next_->prev_ = &to;
+  to.prev_->next_ = &to;
+  from.next_ = from.prev_ = &from;
+}
+
 } // namespace detail
 BOOST_SAM_END_NAMESPACE
 
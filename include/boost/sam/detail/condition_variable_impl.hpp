@@ -24,6 +24,8 @@ struct condition_variable_impl : detail::service_member
   condition_variable_impl(condition_variable_impl &&lhs) noexcept
       : detail::service_member(std::move(lhs)), waiters_(std::move(lhs.waiters_))
   {
+    lock_type _{lhs.mtx_};
+    adopt_timers<predicate_wait_op>(waiters_);
   }
 
   condition_variable_impl &operator=(condition_variable_impl const &) = delete;
@@ -31,7 +33,11 @@ struct condition_variable_impl : detail::service_member
   condition_variable_impl &operator=(condition_variable_impl &&lhs) noexcept
   {
     detail::service_member::operator=(std::move(lhs));
+    lock_type _{mtx_};
+    lock_type l{lhs.mtx_};
     std::swap(lhs.waiters_, waiters_);
+    adopt_timers<predicate_wait_op>(waiters_);
+    lhs.adopt_timers<predicate_wait_op>(lhs.waiters_);
     return *this;
   }
 
@@ -23,6 +23,14 @@ struct conditionally_enabled_mutex
     locked_ = true;
   }
 
+  bool try_lock()
+  {
+    if (enabled_ && !mtx_.try_lock())
+      return false;
+    locked_ = true;
+    return true;
+  }
+
   void unlock()
   {
     locked_ = false;
@@ -0,0 +1,127 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_DISTRIBUTED_SEMAPHORE_IMPL_HPP
+#define BOOST_SAM_DETAIL_DISTRIBUTED_SEMAPHORE_IMPL_HPP
+
+#include <boost/sam/detail/aligned_array.hpp>
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/service.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A semaphore that keeps most of its permits in per-thread caches, so acquires & releases only touch
+// the cache line of their own thread.
+//
+// Every permit is either in use, in one of the slots or in the global pool_, which only gets touched with mtx_ held.
+// A slot that runs dry refills a batch from the pool, & a slot that holds more than two batches gives one back.
+// If the pool is empty too, the slots get drained into it before anyone waits.
+//
+// Waiters announce themselves in waiting_ before draining the slots, and releases check waiting_ after
+// filling their slot, so either the waiter gets the permit or the release sees the waiter & drains the slots again.
+struct distributed_semaphore_impl : detail::service_member
+{
+  BOOST_SAM_DECL distributed_semaphore_impl(net::execution_context &ctx, int initial_count = 1,
+                                            int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT);
+
+  // Take a permit from the slot of this thread, without locking. Fails if anyone waits.
+  BOOST_SAM_DECL bool try_acquire_uncontended() noexcept;
+  // Take a permit from the slot or the pool. Requires mtx_ to be held.
+  BOOST_SAM_DECL bool try_acquire_locked();
+  BOOST_SAM_DECL bool try_acquire();
+
+  // Enqueue a waiter, that failed to acquire. It might get completed right away. Requires mtx_ to be held.
+  BOOST_SAM_DECL void add_waiter(detail::wait_op *waiter);
+  // Dequeue a waiter & complete it with `ec`. Requires mtx_ to be held.
+  BOOST_SAM_DECL void cancel_waiter(detail::wait_op *waiter, error_code ec);
+
+  BOOST_SAM_DECL void release();
+  BOOST_SAM_DECL void acquire(error_code &ec);
+
+  // The available permits, minus the number of waiters.
+  BOOST_SAM_DECL int value() const;
+  // The permits in the global pool.
+  BOOST_SAM_DECL int pooled() const;
+  // The permits cached in each slot.
+  BOOST_SAM_DECL std::vector<int> distribution() const;
+
+  void shutdown() override
+  {
+    lock_type l{mtx_};
+    auto w = std::move(waiters_);
+    waiting_ = 0;
+    l.unlock();
+    w.shutdown();
+  }
+
+  // One cache line per slot, so threads don't contend.
+  struct alignas(64) permit_slot
+  {
+    std::atomic<int> count{0};
+  };
+
+  distributed_semaphore_impl()                                   = delete;
+  distributed_semaphore_impl(const distributed_semaphore_impl &) = delete;
+  distributed_semaphore_impl(distributed_semaphore_impl &&mi)
+      : detail::service_member(std::move(mi)), batch_(mi.batch_), slot_count_(mi.slot_count_),
+        slots_(std::move(mi.slots_)), pool_(mi.pool_), waiting_(mi.waiting_.load()), waiters_(std::move(mi.waiters_))
+  {
+    mi.pool_    = 0;
+    mi.waiting_ = 0;
+  }
+
+  distributed_semaphore_impl &operator=(const distributed_semaphore_impl &lhs) = delete;
+  distributed_semaphore_impl &operator=(distributed_semaphore_impl &&lhs) noexcept
+  {
+    detail::service_member::operator=(std::move(lhs));
+    lock_type _{lhs.mtx_};
+    batch_      = lhs.batch_;
+    slot_count_ = lhs.slot_count_;
+    slots_      = std::move(lhs.slots_);
+    pool_       = lhs.pool_;
+    waiting_.store(lhs.waiting_.load());
+    waiters_    = std::move(lhs.waiters_);
+    lhs.pool_   = 0;
+    lhs.waiting_ = 0;
+    return *this;
+  }
+
+  BOOST_SAM_DECL ~distributed_semaphore_impl();
+
+private:
+  // The slot of the calling thread.
+  BOOST_SAM_DECL permit_slot &slot() noexcept;
+  // Move the permits of all slots into the pool. Requires mtx_ to be held.
+  BOOST_SAM_DECL void drain() noexcept;
+  // Hand out permits from the pool to the waiters. Requires mtx_ to be held.
+  BOOST_SAM_DECL void wake_waiters();
+
+  // the permits a slot takes from or gives back to the pool at once.
+  int                            batch_;
+  std::size_t                    slot_count_;
+  aligned_array<permit_slot>     slots_;
+  int                            pool_;
+  std::atomic<int>               waiting_{0};
+
+  detail::basic_bilist_holder<void(error_code)> waiters_;
+  struct acquire_op_t;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/distributed_semaphore_impl.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_DISTRIBUTED_SEMAPHORE_IMPL_HPP
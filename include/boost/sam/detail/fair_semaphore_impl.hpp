@@ -0,0 +1,280 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_FAIR_SEMAPHORE_IMPL_HPP
+#define BOOST_SAM_DETAIL_FAIR_SEMAPHORE_IMPL_HPP
+
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/service.hpp>
+
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A waiter of a tenant. The queue points to the tenant's queue, which lives at least as long as it's queued.
+struct fair_wait_op : wait_op
+{
+  bilist_node *queue = nullptr;
+};
+
+// A semaphore that queues its waiters per tenant & picks the next waiter by deficit round robin.
+//
+// The tenants with waiters form a ring. The tenant at the front of the ring gets `weight` permits
+// per round, one per waiter, & moves to the back once it used them up.
+// A tenant's queue gets created with its first waiter & erased with its last one,
+// so every release & acquire is O(1). The weights are configured per tenant & kept apart from the queues,
+// only the ones other than 1 get stored.
+template <typename Tenant, typename Hash, typename KeyEqual>
+struct fair_semaphore_impl : detail::service_member
+{
+  struct tenant_queue : bilist_node
+  {
+    const Tenant                                 *tenant  = nullptr;
+    int                                           weight  = 1;
+    // the permits left in the tenant's current round.
+    int                                           deficit = 0;
+    detail::basic_bilist_holder<void(error_code)> waiters;
+
+    bool empty() const noexcept { return waiters.next_ == &waiters; }
+  };
+
+  using map_type = std::unordered_map<Tenant, tenant_queue, Hash, KeyEqual>;
+
+  fair_semaphore_impl(net::execution_context &ctx, int initial_count = 1,
+                      int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT, const Hash &hash = Hash(),
+                      const KeyEqual &eq = KeyEqual())
+      : detail::service_member(ctx, concurrency_hint), count_(initial_count), tenants_(0u, hash, eq),
+        weights_(0u, hash, eq)
+  {
+  }
+
+  // Set the permits the tenant gets per round.
+  void set_weight(const Tenant &tenant, int weight)
+  {
+    BOOST_SAM_ASSERT(weight > 0);
+    lock_type _{mtx_};
+    if (weight == 1)
+      weights_.erase(tenant);
+    else
+      weights_[tenant] = weight;
+
+    auto itr = tenants_.find(tenant);
+    if (itr != tenants_.end())
+      itr->second.weight = weight;
+  }
+
+  int weight(const Tenant &tenant) const
+  {
+    lock_type _{mtx_};
+    auto itr = weights_.find(tenant);
+    return itr == weights_.end() ? 1 : itr->second;
+  }
+
+  // Take a permit if nobody waits. Requires mtx_ to be held.
+  bool try_acquire_locked()
+  {
+    if (count_ <= 0 || active_.next_ != &active_)
+      return false;
+    count_--;
+    return true;
+  }
+
+  bool try_acquire()
+  {
+    lock_type _{mtx_};
+    return try_acquire_locked();
+  }
+
+  // Enqueue a waiter of the tenant, that failed to acquire. Requires mtx_ to be held.
+  void add_waiter(fair_wait_op *waiter, const Tenant &tenant)
+  {
+    auto itr = tenants_.find(tenant);
+    if (itr == tenants_.end())
+    {
+      itr                = tenants_.emplace(std::piecewise_construct, std::forward_as_tuple(tenant),
+                                            std::forward_as_tuple()).first;
+      itr->second.tenant = &itr->first;
+      auto w             = weights_.find(tenant);
+      if (w != weights_.end())
+        itr->second.weight = w->second;
+      itr->second.link_before(&active_);
+    }
+    waiter->queue = &itr->second;
+    waiter->link_before(&itr->second.waiters);
+    waiting_++;
+  }
+
+  // Dequeue a waiter & complete it with `ec`. Requires mtx_ to be held.
+  void cancel_waiter(fair_wait_op *waiter, error_code ec)
+  {
+    auto q = static_cast<tenant_queue *>(waiter->queue);
+    waiting_--;
+    waiter->complete(ec);
+    if (q->empty())
+      erase(q);
+  }
+
+  void release()
+  {
+    lock_type _{mtx_};
+    count_++;
+    wake_waiters();
+  }
+
+  struct acquire_op_t final : fair_wait_op
+  {
+    error_code                         &ec;
+    bool                                done = false;
+    detail::internal_condition_variable var;
+    acquire_op_t(error_code &ec) : ec(ec) {}
+
+    void complete(error_code ec) override
+    {
+      done     = true;
+      this->ec = ec;
+      this->unlink();
+      var.notify_all();
+    }
+
+    void shutdown() override
+    {
+      done = true;
+      BOOST_SAM_ASSIGN_EC(this->ec, net::error::shut_down);
+      this->unlink();
+      var.notify_all();
+    }
+
+    void wait(lock_type &lock)
+    {
+      var.wait(lock, [this] { return done; });
+    }
+  };
+
+  void acquire(const Tenant &tenant, error_code &ec)
+  {
+    if (!this->mtx_.enabled())
+    {
+      if (try_acquire())
+        return;
+      BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+      return;
+    }
+
+    lock_type lock{mtx_};
+    if (try_acquire_locked())
+      return;
+    acquire_op_t op{ec};
+    add_waiter(&op, tenant);
+    op.wait(lock);
+  }
+
+  // The count minus the number of waiters.
+  int value() const
+  {
+    lock_type _{mtx_};
+    return count_ - waiting_;
+  }
+
+  // The number of tenants with waiters.
+  std::size_t tenants() const
+  {
+    lock_type _{mtx_};
+    return tenants_.size();
+  }
+
+  void shutdown() override
+  {
+    detail::basic_bilist_holder<void(error_code)> w;
+    {
+      lock_type _{mtx_};
+      for (auto &t : tenants_)
+        while (!t.second.empty())
+        {
+          auto op = t.second.waiters.next_;
+          op->unlink();
+          op->link_before(&w);
+        }
+      tenants_.clear();
+      active_.next_ = active_.prev_ = &active_;
+      waiting_      = 0;
+    }
+    w.shutdown();
+  }
+
+  fair_semaphore_impl()                            = delete;
+  fair_semaphore_impl(const fair_semaphore_impl &) = delete;
+  fair_semaphore_impl(fair_semaphore_impl &&mi)
+      : detail::service_member(std::move(mi)), count_(mi.count_), waiting_(mi.waiting_),
+        tenants_(std::move(mi.tenants_)), weights_(std::move(mi.weights_)), active_(std::move(mi.active_))
+  {
+    mi.waiting_ = 0;
+  }
+
+  fair_semaphore_impl &operator=(const fair_semaphore_impl &lhs) = delete;
+  fair_semaphore_impl &operator=(fair_semaphore_impl &&lhs) noexcept
+  {
+    detail::service_member::operator=(std::move(lhs));
+    lock_type _{mtx_};
+    count_   = lhs.count_;
+    std::swap(waiting_, lhs.waiting_);
+    std::swap(tenants_, lhs.tenants_);
+    std::swap(weights_, lhs.weights_);
+    bilist_node tmp;
+    take_ring(tmp, active_);
+    take_ring(active_, lhs.active_);
+    take_ring(lhs.active_, tmp);
+    return *this;
+  }
+
+private:
+  // Hand out the permits one by one to the tenant at the front of the ring. Requires mtx_ to be held.
+  void wake_waiters()
+  {
+    while (count_ > 0 && active_.next_ != &active_)
+    {
+      auto q = static_cast<tenant_queue *>(active_.next_);
+      // a new round for the tenant.
+      if (q->deficit == 0)
+        q->deficit = q->weight;
+      q->deficit--;
+      count_--;
+      waiting_--;
+      static_cast<fair_wait_op *>(q->waiters.next_)->complete(error_code());
+
+      if (q->empty())
+        erase(q);
+      else if (q->deficit == 0)
+      {
+        q->unlink();
+        q->link_before(&active_);
+      }
+    }
+  }
+
+  void erase(tenant_queue *q)
+  {
+    q->unlink();
+    tenants_.erase(*q->tenant);
+  }
+
+  int         count_;
+  int         waiting_ = 0;
+  map_type    tenants_;
+  // the weights other than 1.
+  std::unordered_map<Tenant, int, Hash, KeyEqual> weights_;
+  // the ring of tenants with waiters, the front is the one to be served next.
+  bilist_node active_;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_FAIR_SEMAPHORE_IMPL_HPP
@@ -7,6 +7,8 @@
 
 #include <boost/sam/detail/config.hpp>
 
+#include <chrono>
+
 #if defined(BOOST_SAM_STANDALONE)
 #include <asio/cancellation_type.hpp>
 #include <asio/compose.hpp>
@@ -23,6 +25,8 @@ template <typename>
 struct basic_semaphore;
 template <typename>
 struct basic_mutex;
+template <typename>
+struct basic_adaptive_limiter;
 
 struct lock_guard;
 
@@ -143,6 +147,75 @@ struct guard_by_mutex_op<Executor, Op, void(Err, Args...)>
   }
 };
 
+template <typename Executor, typename Op, typename Signature>
+struct guard_by_adaptive_limiter_op;
+
+// Like guard_by_semaphore_op, but the release carries the latency & outcome of the op.
+template <typename Executor, typename Op, typename Err, typename... Args>
+struct guard_by_adaptive_limiter_op<Executor, Op, void(Err, Args...)>
+{
+  basic_adaptive_limiter<Executor>     &sm;
+  Op                                    op;
+  std::chrono::steady_clock::time_point start;
+
+  struct semaphore_tag
+  {
+  };
+  struct op_tag
+  {
+  };
+
+  static error_code         make_error_impl(error_code ec, error_code *) { return ec; }
+  static std::exception_ptr make_error_impl(error_code ec, std::exception_ptr *)
+  {
+    return std::make_exception_ptr(system_error(ec));
+  }
+
+  static Err make_error(error_code ec) { return make_error_impl(ec, static_cast<Err *>(nullptr)); }
+
+  // a cancelled op says nothing about the latency.
+  static bool cancelled(const error_code &ec) { return ec == net::error::operation_aborted; }
+  static bool cancelled(const std::exception_ptr &) { return false; }
+
+  template <typename Self>
+  void run(Self &&self)
+  {
+    start   = std::chrono::steady_clock::now();
+    auto oo = std::move(op);
+    std::move(oo)(net::prepend(std::move(self), op_tag{}));
+  }
+
+  template <typename Self>
+  void operator()(Self &&self) // init
+  {
+    if (self.get_cancellation_state().cancelled() != net::cancellation_type::none)
+      std::move(self).complete(make_error(net::error::operation_aborted), Args{}...);
+    else if (sm.try_acquire())
+      run(std::move(self));
+    else
+      sm.async_acquire(net::prepend(std::move(self), semaphore_tag{}));
+  }
+
+  template <typename Self>
+  void operator()(Self &&self, semaphore_tag, error_code ec) // semaphore obtained
+  {
+    if (ec)
+      self.complete(make_error(ec), Args{}...);
+    else
+      run(std::move(self));
+  }
+
+  template <typename Self, typename Err_, typename... Args_>
+  void operator()(Self &&self, op_tag, Err_ &&err, Args_ &&...args) // op done
+  {
+    if (cancelled(err))
+      sm.release();
+    else
+      sm.release(std::chrono::steady_clock::now() - start, static_cast<bool>(err));
+    std::move(self).complete(std::forward<Err_>(err), std::forward<Args_>(args)...);
+  }
+};
+
 } // namespace detail
 
 BOOST_SAM_END_NAMESPACE
@@ -0,0 +1,120 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_HIERARCHICAL_SEMAPHORE_IMPL_HPP
+#define BOOST_SAM_DETAIL_HIERARCHICAL_SEMAPHORE_IMPL_HPP
+
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/service.hpp>
+
+#include <cstdint>
+#include <deque>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A waiter for a permit at a node & all its ancestors.
+struct hierarchical_wait_op : wait_op
+{
+  std::size_t   node = 0u;
+  // the position in the arrival order, lower is older.
+  std::uint64_t seq  = 0u;
+};
+
+// A tree of quotas. Every node has its own count, and a permit at a node is a permit at each node on its path to the root.
+//
+// Waiters queue up at the node they acquire for. The nodes with waiters form a ring, and a wake-up picks the oldest
+// front waiter whose path has a permit left at every level, so nothing is held while waiting
+// & a waiter stuck at its own quota doesn't block the others.
+struct hierarchical_semaphore_impl : detail::service_member
+{
+  struct node_type : bilist_node
+  {
+    std::size_t                                   parent;
+    int                                           count;
+    detail::basic_bilist_holder<void(error_code)> waiters;
+
+    node_type(std::size_t parent, int count) : parent(parent), count(count) {}
+    bool empty() const noexcept { return waiters.next_ == &waiters; }
+  };
+
+  // the root is the first node, and its own parent.
+  constexpr static std::size_t root = 0u;
+
+  BOOST_SAM_DECL hierarchical_semaphore_impl(net::execution_context &ctx, int initial_count = 1,
+                                             int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT);
+
+  // Add a node below `parent` & return its id.
+  BOOST_SAM_DECL std::size_t add_node(std::size_t parent, int initial_count);
+
+  // Take a permit at every level of the path, if all have one. Requires mtx_ to be held.
+  BOOST_SAM_DECL bool try_acquire_locked(std::size_t node);
+  BOOST_SAM_DECL bool try_acquire(std::size_t node);
+
+  // Enqueue a waiter, that failed to acquire. Requires mtx_ to be held.
+  BOOST_SAM_DECL void add_waiter(hierarchical_wait_op *waiter, std::size_t node);
+  // Dequeue a waiter & complete it with `ec`. Requires mtx_ to be held.
+  BOOST_SAM_DECL void cancel_waiter(hierarchical_wait_op *waiter, error_code ec);
+
+  // Give back a permit at every level of the path.
+  BOOST_SAM_DECL void release(std::size_t node);
+
+  BOOST_SAM_DECL void acquire(std::size_t node, error_code &ec);
+
+  // The permits left at the node.
+  BOOST_SAM_DECL int value(std::size_t node) const;
+
+  BOOST_SAM_DECL void shutdown() override;
+
+  hierarchical_semaphore_impl()                                    = delete;
+  hierarchical_semaphore_impl(const hierarchical_semaphore_impl &) = delete;
+  // the deque steals the nodes, so the waiter lists stay where they are.
+  hierarchical_semaphore_impl(hierarchical_semaphore_impl &&mi)
+      : detail::service_member(std::move(mi)), seq_(mi.seq_), nodes_(std::move(mi.nodes_))
+  {
+    take_ring(active_, mi.active_);
+  }
+
+  hierarchical_semaphore_impl &operator=(const hierarchical_semaphore_impl &lhs) = delete;
+  hierarchical_semaphore_impl &operator=(hierarchical_semaphore_impl &&lhs) noexcept
+  {
+    detail::service_member::operator=(std::move(lhs));
+    lock_type _{mtx_};
+    std::swap(seq_, lhs.seq_);
+    std::swap(nodes_, lhs.nodes_);
+    bilist_node tmp;
+    take_ring(tmp, active_);
+    take_ring(active_, lhs.active_);
+    take_ring(lhs.active_, tmp);
+    return *this;
+  }
+
+private:
+  // Whether every level of the path has a permit. Requires mtx_ to be held.
+  BOOST_SAM_DECL bool available(std::size_t node) const;
+  // Take or give back a permit at every level of the path. Requires mtx_ to be held.
+  BOOST_SAM_DECL void adjust(std::size_t node, int delta);
+  // Hand out permits to the oldest waiters that can get one. Requires mtx_ to be held.
+  BOOST_SAM_DECL void wake_waiters();
+
+  std::uint64_t         seq_ = 0u;
+  // a deque, so adding nodes doesn't move the waiter lists.
+  std::deque<node_type> nodes_;
+  // the ring of nodes with waiters.
+  bilist_node           active_;
+  struct acquire_op_t;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/hierarchical_semaphore_impl.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_HIERARCHICAL_SEMAPHORE_IMPL_HPP
@@ -0,0 +1,77 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_ADAPTIVE_LIMITER_IMPL_IPP
+#define BOOST_SAM_DETAIL_IMPL_ADAPTIVE_LIMITER_IMPL_IPP
+
+#include <boost/sam/detail/adaptive_limiter_impl.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+// how much the latency may rise before the limit shrinks.
+constexpr double adaptive_limiter_rtt_tolerance = 1.5;
+// how far a single sample moves the limit towards its target.
+constexpr double adaptive_limiter_smoothing     = 0.2;
+// the factor applied to the limit when an operation failed.
+constexpr double adaptive_limiter_backoff       = 0.9;
+// the number of samples the long term latency averages over, after a plain average of the first few.
+constexpr int    adaptive_limiter_long_window   = 600;
+constexpr int    adaptive_limiter_warmup        = 10;
+
+adaptive_limiter_impl::adaptive_limiter_impl(net::execution_context &ctx, int initial_limit, int min_limit,
+                                             int max_limit, int concurrency_hint)
+    : semaphore_impl(ctx, initial_limit, concurrency_hint), limit_(initial_limit), min_(min_limit), max_(max_limit),
+      estimate_(initial_limit)
+{
+  BOOST_SAM_ASSERT(0 < min_limit && min_limit <= initial_limit && initial_limit <= max_limit);
+}
+
+double adaptive_limiter_impl::next_estimate(double rtt, bool dropped, int in_flight)
+{
+  if (dropped)
+    return estimate_ * adaptive_limiter_backoff;
+
+  if (samples_ < adaptive_limiter_warmup)
+  {
+    long_rtt_ = (long_rtt_ * samples_ + rtt) / (samples_ + 1);
+    samples_++;
+  }
+  else
+    long_rtt_ += (rtt - long_rtt_) * 2. / (adaptive_limiter_long_window + 1);
+
+  // recover quicker after the latency dropped.
+  if (long_rtt_ > 2. * rtt)
+    long_rtt_ *= 0.95;
+
+  // nothing to learn about the limit if it wasn't what held things back.
+  if (in_flight < estimate_ / 2.)
+    return estimate_;
+
+  const double gradient = (std::max)(0.5, (std::min)(1., adaptive_limiter_rtt_tolerance * long_rtt_ / rtt));
+  const double target   = estimate_ * gradient + std::sqrt(estimate_);
+  return estimate_ * (1. - adaptive_limiter_smoothing) + target * adaptive_limiter_smoothing;
+}
+
+void adaptive_limiter_impl::release(clock_type::duration rtt, bool dropped)
+{
+  lock_type _{mtx_};
+  const double ns = (std::max)(std::chrono::duration<double, std::nano>(rtt).count(), 1.);
+
+  estimate_       = (std::min)((std::max)(next_estimate(ns, dropped, in_flight()), double(min_)), double(max_));
+  const int limit = static_cast<int>(std::lround(estimate_));
+  // the released permit plus the change of the limit.
+  adjust(1 + limit - limit_.load());
+  limit_ = limit;
+  wake_waiters();
+}
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_ADAPTIVE_LIMITER_IMPL_IPP
@@ -13,6 +13,12 @@ BOOST_SAM_BEGIN_NAMESPACE
 namespace detail
 {
 
+void barrier_timed_wait_op::on_expire(service_member *owner)
+{
+  // a timed out arrival doesn't count towards the barrier anymore.
+  static_cast<barrier_impl *>(owner)->counter_++;
+}
+
 bool barrier_impl::try_arrive()
 {
   lock_type _{mtx_};
@@ -25,8 +25,8 @@ BOOST_SAM_BEGIN_NAMESPACE
 
 namespace detail
 {
-template <class Executor, class Handler, class... Ts>
-auto basic_op_model<Executor, Handler, void(Ts...)>::construct(Executor e, Handler handler) -> basic_op_model *
+template <class Executor, class Handler, class Base, class... Ts>
+auto basic_op_model<Executor, Handler, void(Ts...), Base>::construct(Executor e, Handler handler) -> basic_op_model *
 {
   auto halloc  = net::get_associated_allocator(handler);
   auto alloc   = typename std::allocator_traits<decltype(halloc)>::template rebind_alloc<basic_op_model>(halloc);
@@ -44,8 +44,8 @@ auto basic_op_model<Executor, Handler, void(Ts...)>::construct(Executor e, Handl
   }
 }
 
-template <class Executor, class Handler, class... Ts>
-auto basic_op_model<Executor, Handler, void(Ts...)>::destroy(basic_op_model                      *self,
+template <class Executor, class Handler, class Base, class... Ts>
+auto basic_op_model<Executor, Handler, void(Ts...), Base>::destroy(basic_op_model                      *self,
                                                              net::associated_allocator_t<Handler> halloc) -> void
 {
   auto alloc = typename std::allocator_traits<decltype(halloc)>::template rebind_alloc<basic_op_model>(halloc);
@@ -54,14 +54,14 @@ auto basic_op_model<Executor, Handler, void(Ts...)>::destroy(basic_op_model
   traits.deallocate(alloc, self, 1);
 }
 
-template <class Executor, class Handler, class... Ts>
-basic_op_model<Executor, Handler, void(Ts...)>::basic_op_model(Executor e, Handler handler)
+template <class Executor, class Handler, class Base, class... Ts>
+basic_op_model<Executor, Handler, void(Ts...), Base>::basic_op_model(Executor e, Handler handler)
     : work_guard_(std::move(e)), handler_(std::move(handler))
 {
 }
 
-template <class Executor, class Handler, class... Ts>
-void basic_op_model<Executor, Handler, void(Ts...)>::complete(Ts... args)
+template <class Executor, class Handler, class Base, class... Ts>
+void basic_op_model<Executor, Handler, void(Ts...), Base>::complete(Ts... args)
 {
   get_cancellation_slot().clear();
   auto g = std::move(work_guard_);
@@ -71,8 +71,8 @@ void basic_op_model<Executor, Handler, void(Ts...)>::complete(Ts... args)
   net::post(g.get_executor(), net::append(std::move(h), std::move(args)...));
 }
 
-template <class Executor, class Handler, class... Ts>
-void basic_op_model<Executor, Handler, void(Ts...)>::shutdown()
+template <class Executor, class Handler, class Base, class... Ts>
+void basic_op_model<Executor, Handler, void(Ts...), Base>::shutdown()
 {
   get_cancellation_slot().clear();
   this->unlink();
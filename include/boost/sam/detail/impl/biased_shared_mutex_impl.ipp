@@ -0,0 +1,255 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_BIASED_SHARED_MUTEX_IMPL_IPP
+#define BOOST_SAM_DETAIL_IMPL_BIASED_SHARED_MUTEX_IMPL_IPP
+
+#include <boost/sam/detail/biased_shared_mutex_impl.hpp>
+#include <boost/sam/detail/thread_slots.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+biased_shared_mutex_impl::biased_shared_mutex_impl(net::execution_context &ctx, int concurrency_hint)
+    : detail::service_member(ctx, concurrency_hint), slot_count_(slot_count(mtx_.enabled())), slots_(slot_count_)
+{
+}
+
+biased_shared_mutex_impl::~biased_shared_mutex_impl() = default;
+
+auto biased_shared_mutex_impl::slot() noexcept -> reader_slot &
+{
+  return slots_[thread_slot(slot_count_)];
+}
+
+std::ptrdiff_t biased_shared_mutex_impl::readers() const noexcept
+{
+  // a reader might lock on one thread & unlock on another, so only the sum is meaningful.
+  std::ptrdiff_t sum = 0;
+  for (std::size_t i = 0u; i < slot_count_; i++)
+    sum += slots_[i].count.load(std::memory_order_seq_cst);
+  return sum;
+}
+
+void biased_shared_mutex_impl::check_drained() noexcept
+{
+  if (!draining_ || readers() != 0)
+    return;
+  draining_ = false;
+  static_cast<detail::wait_op *>(waiters_.next_)->complete(error_code());
+}
+
+void biased_shared_mutex_impl::release_slot(reader_slot &s)
+{
+  // pairs with the store in lock_or_add_waiter: either the writer sees the decrement when summing up,
+  // or this sees the bias revoked.
+  s.count.fetch_sub(1, std::memory_order_seq_cst);
+  if (bias_.load(std::memory_order_seq_cst))
+    return;
+  lock_type l{mtx_};
+  check_drained();
+}
+
+bool biased_shared_mutex_impl::try_lock_shared_fast() noexcept
+{
+  if (!bias_.load(std::memory_order_seq_cst))
+    return false;
+  auto &s = slot();
+  s.count.fetch_add(1, std::memory_order_seq_cst);
+  if (bias_.load(std::memory_order_seq_cst))
+    return true;
+  // a writer revoked the bias in between & might be waiting for this slot.
+  release_slot(s);
+  return false;
+}
+
+bool biased_shared_mutex_impl::lock_or_add_waiter(detail::wait_op *waiter) noexcept
+{
+  if (locked_)
+  {
+    waiter->link_before(&waiters_);
+    return false;
+  }
+
+  locked_ = true;
+  bias_.store(false, std::memory_order_seq_cst);
+  if (readers() == 0)
+    return true;
+
+  draining_ = true;
+  waiter->link_before(&waiters_);
+  return false;
+}
+
+bool biased_shared_mutex_impl::lock_shared_or_add_waiter(detail::wait_op *waiter) noexcept
+{
+  if (!locked_)
+  {
+    slot().count.fetch_add(1, std::memory_order_seq_cst);
+    return true;
+  }
+  waiter->link_before(&shared_waiters_);
+  return false;
+}
+
+void biased_shared_mutex_impl::on_writer_cancelled() noexcept
+{
+  if (!draining_ || waiters_.next_ != &waiters_)
+    return;
+
+  // nobody is left to wait for the readers to drain, so let the queued readers in & restore the bias.
+  draining_ = false;
+  locked_   = false;
+  auto &s   = slot();
+  while (shared_waiters_.next_ != &shared_waiters_)
+  {
+    s.count.fetch_add(1, std::memory_order_seq_cst);
+    static_cast<detail::wait_op *>(shared_waiters_.next_)->complete(error_code());
+  }
+  bias_.store(true, std::memory_order_seq_cst);
+}
+
+struct biased_shared_mutex_impl::lock_op_t final : detail::wait_op
+{
+  error_code   &ec;
+  bool          done = false;
+  detail::internal_condition_variable var;
+  lock_op_t(error_code &ec) : ec(ec) {}
+
+  void complete(error_code ec) override
+  {
+    done     = true;
+    this->ec = ec;
+    this->unlink();
+    var.notify_all();
+  }
+
+  void shutdown() override
+  {
+    done = true;
+    BOOST_SAM_ASSIGN_EC(this->ec, net::error::shut_down);
+    this->unlink();
+    var.notify_all();
+  }
+
+  void wait(lock_type &lock)
+  {
+    var.wait(lock, [this]{return done;});
+  }
+};
+
+void biased_shared_mutex_impl::lock(error_code &ec)
+{
+  if (!this->mtx_.enabled())
+  {
+    if (try_lock())
+      return;
+    else
+    {
+      BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+      return;
+    }
+  }
+
+  lock_type lock{mtx_};
+  lock_op_t op{ec};
+  if (lock_or_add_waiter(&op))
+    return;
+  op.wait(lock);
+}
+
+bool biased_shared_mutex_impl::try_lock()
+{
+  lock_type _{mtx_};
+  if (locked_)
+    return false;
+
+  bias_.store(false, std::memory_order_seq_cst);
+  if (readers() == 0)
+    return locked_ = true;
+
+  // readers that saw the bias revoked in between just took the slow path.
+  bias_.store(true, std::memory_order_seq_cst);
+  return false;
+}
+
+void biased_shared_mutex_impl::unlock()
+{
+  lock_type lock{mtx_};
+  BOOST_SAM_ASSERT(locked_ && !draining_);
+
+  // readers that queued up during the write go first, so neither side can starve.
+  if (shared_waiters_.next_ != &shared_waiters_)
+  {
+    auto &s = slot();
+    while (shared_waiters_.next_ != &shared_waiters_)
+    {
+      s.count.fetch_add(1, std::memory_order_seq_cst);
+      static_cast<detail::wait_op *>(shared_waiters_.next_)->complete(error_code());
+    }
+
+    // the next writer keeps new readers out & waits for these ones.
+    if (waiters_.next_ != &waiters_)
+      draining_ = true;
+    else
+    {
+      locked_ = false;
+      bias_.store(true, std::memory_order_seq_cst);
+    }
+    return;
+  }
+
+  if (waiters_.next_ != &waiters_)
+  {
+    // ownership moves to the next waiter, so locked_ stays set.
+    static_cast<detail::wait_op *>(waiters_.next_)->complete(error_code());
+    return;
+  }
+
+  locked_ = false;
+  bias_.store(true, std::memory_order_seq_cst);
+}
+
+void biased_shared_mutex_impl::lock_shared(error_code &ec)
+{
+  if (try_lock_shared_fast())
+    return;
+
+  if (!this->mtx_.enabled())
+  {
+    if (try_lock_shared())
+      return;
+    else
+    {
+      BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+      return;
+    }
+  }
+
+  lock_type lock{mtx_};
+  lock_op_t op{ec};
+  if (lock_shared_or_add_waiter(&op))
+    return;
+  op.wait(lock);
+}
+
+bool biased_shared_mutex_impl::try_lock_shared()
+{
+  if (try_lock_shared_fast())
+    return true;
+
+  lock_type _{mtx_};
+  if (locked_)
+    return false;
+  slot().count.fetch_add(1, std::memory_order_seq_cst);
+  return true;
+}
+
+void biased_shared_mutex_impl::unlock_shared() { release_slot(slot()); }
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_BIASED_SHARED_MUTEX_IMPL_IPP
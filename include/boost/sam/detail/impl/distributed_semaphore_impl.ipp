@@ -0,0 +1,202 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_DISTRIBUTED_SEMAPHORE_IMPL_IPP
+#define BOOST_SAM_DETAIL_IMPL_DISTRIBUTED_SEMAPHORE_IMPL_IPP
+
+#include <boost/sam/detail/distributed_semaphore_impl.hpp>
+#include <boost/sam/detail/thread_slots.hpp>
+
+#include <algorithm>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+distributed_semaphore_impl::distributed_semaphore_impl(net::execution_context &ctx, int initial_count,
+                                                       int concurrency_hint)
+    : detail::service_member(ctx, concurrency_hint), slot_count_(slot_count(mtx_.enabled())),
+      slots_(slot_count_), pool_(initial_count)
+{
+  // small enough that all slots together only cache a quarter of the permits.
+  batch_ = (std::max)(1, initial_count / static_cast<int>(4u * slot_count_));
+}
+
+distributed_semaphore_impl::~distributed_semaphore_impl() = default;
+
+auto distributed_semaphore_impl::slot() noexcept -> permit_slot &
+{
+  return slots_[thread_slot(slot_count_)];
+}
+
+void distributed_semaphore_impl::drain() noexcept
+{
+  for (std::size_t i = 0u; i < slot_count_; i++)
+    pool_ += slots_[i].count.exchange(0, std::memory_order_seq_cst);
+}
+
+bool distributed_semaphore_impl::try_acquire_uncontended() noexcept
+{
+  if (waiting_.load(std::memory_order_seq_cst) != 0)
+    return false;
+  auto &s = slot();
+  int   c = s.count.load(std::memory_order_relaxed);
+  while (c > 0)
+    if (s.count.compare_exchange_weak(c, c - 1, std::memory_order_seq_cst))
+      return true;
+  return false;
+}
+
+bool distributed_semaphore_impl::try_acquire_locked()
+{
+  if (waiters_.next_ != &waiters_)
+    return false;
+  if (try_acquire_uncontended())
+    return true;
+
+  // take back what the other threads cached, before giving up.
+  if (pool_ == 0)
+    drain();
+  if (pool_ == 0)
+    return false;
+
+  const int n = (std::min)(batch_, pool_);
+  pool_ -= n;
+  slot().count.fetch_add(n - 1, std::memory_order_seq_cst);
+  return true;
+}
+
+bool distributed_semaphore_impl::try_acquire()
+{
+  if (try_acquire_uncontended())
+    return true;
+  lock_type _{mtx_};
+  return try_acquire_locked();
+}
+
+void distributed_semaphore_impl::add_waiter(detail::wait_op *waiter)
+{
+  // pairs with the check in release: either this sees the permit in the slot, or the release sees the waiter.
+  waiting_.fetch_add(1, std::memory_order_seq_cst);
+  waiter->link_before(&waiters_);
+  drain();
+  wake_waiters();
+}
+
+void distributed_semaphore_impl::cancel_waiter(detail::wait_op *waiter, error_code ec)
+{
+  waiting_.fetch_sub(1, std::memory_order_seq_cst);
+  waiter->complete(ec);
+}
+
+void distributed_semaphore_impl::wake_waiters()
+{
+  while (pool_ > 0 && waiters_.next_ != &waiters_)
+  {
+    pool_--;
+    waiting_.fetch_sub(1, std::memory_order_seq_cst);
+    static_cast<detail::wait_op *>(waiters_.next_)->complete(error_code());
+  }
+}
+
+void distributed_semaphore_impl::release()
+{
+  auto     &s = slot();
+  const int c = s.count.fetch_add(1, std::memory_order_seq_cst) + 1;
+  if (waiting_.load(std::memory_order_seq_cst) != 0)
+  {
+    lock_type _{mtx_};
+    drain();
+    wake_waiters();
+  }
+  else if (c > 2 * batch_)
+  {
+    // give a batch back, so the permits don't pile up on one thread.
+    lock_type _{mtx_};
+    int v = s.count.load(std::memory_order_relaxed);
+    while (v > batch_ && !s.count.compare_exchange_weak(v, batch_, std::memory_order_seq_cst))
+      ;
+    if (v > batch_)
+      pool_ += v - batch_;
+  }
+}
+
+struct distributed_semaphore_impl::acquire_op_t final : detail::wait_op
+{
+  error_code   &ec;
+  bool          done = false;
+  detail::internal_condition_variable var;
+  acquire_op_t(error_code &ec) : ec(ec) {}
+
+  void complete(error_code ec) override
+  {
+    done     = true;
+    this->ec = ec;
+    this->unlink();
+    var.notify_all();
+  }
+
+  void shutdown() override
+  {
+    done = true;
+    BOOST_SAM_ASSIGN_EC(this->ec, net::error::shut_down);
+    this->unlink();
+    var.notify_all();
+  }
+
+  void wait(lock_type &lock)
+  {
+    var.wait(lock, [this]{return done;});
+  }
+};
+
+void distributed_semaphore_impl::acquire(error_code &ec)
+{
+  if (!mtx_.enabled())
+  {
+    if (try_acquire())
+      return;
+    BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+    return;
+  }
+
+  if (try_acquire_uncontended())
+    return;
+
+  lock_type lock{mtx_};
+  if (try_acquire_locked())
+    return;
+  acquire_op_t op{ec};
+  add_waiter(&op);
+  op.wait(lock);
+}
+
+int distributed_semaphore_impl::value() const
+{
+  lock_type _{mtx_};
+  int sum = pool_ - waiting_.load();
+  for (std::size_t i = 0u; i < slot_count_; i++)
+    sum += slots_[i].count.load();
+  return sum;
+}
+
+int distributed_semaphore_impl::pooled() const
+{
+  lock_type _{mtx_};
+  return pool_;
+}
+
+std::vector<int> distributed_semaphore_impl::distribution() const
+{
+  std::vector<int> res;
+  res.reserve(slot_count_);
+  for (std::size_t i = 0u; i < slot_count_; i++)
+    res.push_back(slots_[i].count.load());
+  return res;
+}
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_DISTRIBUTED_SEMAPHORE_IMPL_IPP
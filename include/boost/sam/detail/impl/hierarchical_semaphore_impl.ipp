@@ -0,0 +1,200 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_HIERARCHICAL_SEMAPHORE_IMPL_IPP
+#define BOOST_SAM_DETAIL_IMPL_HIERARCHICAL_SEMAPHORE_IMPL_IPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/hierarchical_semaphore_impl.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+hierarchical_semaphore_impl::hierarchical_semaphore_impl(net::execution_context &ctx, int initial_count,
+                                                         int concurrency_hint)
+    : detail::service_member(ctx, concurrency_hint)
+{
+  nodes_.emplace_back(0u, initial_count);
+}
+
+std::size_t hierarchical_semaphore_impl::add_node(std::size_t parent, int initial_count)
+{
+  lock_type _{mtx_};
+  BOOST_SAM_ASSERT(parent < nodes_.size());
+  nodes_.emplace_back(parent, initial_count);
+  return nodes_.size() - 1u;
+}
+
+bool hierarchical_semaphore_impl::available(std::size_t node) const
+{
+  for (;; node = nodes_[node].parent)
+  {
+    if (nodes_[node].count <= 0)
+      return false;
+    if (node == root)
+      return true;
+  }
+}
+
+void hierarchical_semaphore_impl::adjust(std::size_t node, int delta)
+{
+  for (;; node = nodes_[node].parent)
+  {
+    nodes_[node].count += delta;
+    if (node == root)
+      return;
+  }
+}
+
+// A waiter that could get a permit would have gotten it with the last release,
+// so it's safe to skip the queue here.
+bool hierarchical_semaphore_impl::try_acquire_locked(std::size_t node)
+{
+  BOOST_SAM_ASSERT(node < nodes_.size());
+  if (!available(node))
+    return false;
+  adjust(node, -1);
+  return true;
+}
+
+bool hierarchical_semaphore_impl::try_acquire(std::size_t node)
+{
+  lock_type _{mtx_};
+  return try_acquire_locked(node);
+}
+
+void hierarchical_semaphore_impl::add_waiter(hierarchical_wait_op *waiter, std::size_t node)
+{
+  BOOST_SAM_ASSERT(node < nodes_.size());
+  auto &n = nodes_[node];
+  if (n.empty())
+    n.link_before(&active_);
+  waiter->node = node;
+  waiter->seq  = seq_++;
+  waiter->link_before(&n.waiters);
+}
+
+void hierarchical_semaphore_impl::cancel_waiter(hierarchical_wait_op *waiter, error_code ec)
+{
+  auto &n = nodes_[waiter->node];
+  waiter->complete(ec);
+  if (n.empty())
+    n.unlink();
+}
+
+void hierarchical_semaphore_impl::release(std::size_t node)
+{
+  lock_type _{mtx_};
+  BOOST_SAM_ASSERT(node < nodes_.size());
+  adjust(node, 1);
+  wake_waiters();
+}
+
+void hierarchical_semaphore_impl::wake_waiters()
+{
+  // every permit is a permit of the root, so there's nothing to hand out once it's used up.
+  while (nodes_[root].count > 0)
+  {
+    node_type            *best = nullptr;
+    hierarchical_wait_op *op   = nullptr;
+    for (auto itr = active_.next_; itr != &active_; itr = itr->next_)
+    {
+      auto n     = static_cast<node_type *>(itr);
+      auto front = static_cast<hierarchical_wait_op *>(n->waiters.next_);
+      if ((op == nullptr || front->seq < op->seq) && available(front->node))
+      {
+        best = n;
+        op   = front;
+      }
+    }
+    if (op == nullptr)
+      return;
+
+    adjust(op->node, -1);
+    op->complete(error_code());
+    if (best->empty())
+      best->unlink();
+  }
+}
+
+struct hierarchical_semaphore_impl::acquire_op_t final : detail::hierarchical_wait_op
+{
+  error_code   &ec;
+  bool          done = false;
+  detail::internal_condition_variable var;
+  acquire_op_t(error_code &ec) : ec(ec) {}
+
+  void complete(error_code ec) override
+  {
+    done     = true;
+    this->ec = ec;
+    this->unlink();
+    var.notify_all();
+  }
+
+  void shutdown() override
+  {
+    done = true;
+    BOOST_SAM_ASSIGN_EC(this->ec, net::error::shut_down);
+    this->unlink();
+    var.notify_all();
+  }
+
+  void wait(lock_type &lock)
+  {
+    var.wait(lock, [this]{return done;});
+  }
+};
+
+void hierarchical_semaphore_impl::acquire(std::size_t node, error_code &ec)
+{
+  if (!mtx_.enabled())
+  {
+    if (try_acquire(node))
+      return;
+    BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+    return;
+  }
+
+  lock_type lock{mtx_};
+  if (try_acquire_locked(node))
+    return;
+  acquire_op_t op{ec};
+  add_waiter(&op, node);
+  op.wait(lock);
+}
+
+int hierarchical_semaphore_impl::value(std::size_t node) const
+{
+  lock_type _{mtx_};
+  BOOST_SAM_ASSERT(node < nodes_.size());
+  return nodes_[node].count;
+}
+
+void hierarchical_semaphore_impl::shutdown()
+{
+  detail::basic_bilist_holder<void(error_code)> w;
+  {
+    lock_type _{mtx_};
+    while (active_.next_ != &active_)
+    {
+      auto n = static_cast<node_type *>(active_.next_);
+      while (!n->empty())
+      {
+        auto op = n->waiters.next_;
+        op->unlink();
+        op->link_before(&w);
+      }
+      n->unlink();
+    }
+  }
+  w.shutdown();
+}
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_HIERARCHICAL_SEMAPHORE_IMPL_IPP
@@ -0,0 +1,261 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_LOCK_HIERARCHY_IMPL_IPP
+#define BOOST_SAM_DETAIL_IMPL_LOCK_HIERARCHY_IMPL_IPP
+
+#include <boost/sam/detail/lock_hierarchy_impl.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+inline unsigned lock_mode_bit(lock_mode mode) noexcept { return 1u << static_cast<unsigned>(mode); }
+
+// The modes that can be held on a node alongside `mode`.
+inline unsigned lock_mode_compatible(lock_mode mode) noexcept
+{
+  //                               IS     IX     S      SIX    X
+  constexpr static unsigned table[] = {0x0Fu, 0x03u, 0x05u, 0x01u, 0x00u};
+  return table[static_cast<std::size_t>(mode)];
+}
+
+// The mode the ancestors get locked in.
+inline lock_mode lock_mode_intention(lock_mode mode) noexcept
+{
+  return (mode == lock_mode::intention_shared || mode == lock_mode::shared) ? lock_mode::intention_shared
+                                                                            : lock_mode::intention_exclusive;
+}
+
+inline unsigned lock_mode_mask(const std::size_t (&counts)[lock_hierarchy_impl::modes]) noexcept
+{
+  unsigned res = 0u;
+  for (std::size_t m = 0u; m < lock_hierarchy_impl::modes; m++)
+    if (counts[m] != 0u)
+      res |= 1u << m;
+  return res;
+}
+
+inline lock_mode lock_mode_at(const hierarchy_wait_op *waiter, std::size_t node) noexcept
+{
+  return node == waiter->node ? waiter->mode : lock_mode_intention(waiter->mode);
+}
+
+lock_hierarchy_impl::lock_hierarchy_impl(net::execution_context &ctx, int concurrency_hint)
+    : detail::service_member(ctx, concurrency_hint)
+{
+  nodes_.emplace_back(0u);
+}
+
+lock_hierarchy_impl::~lock_hierarchy_impl() = default;
+
+std::size_t lock_hierarchy_impl::add_node(std::size_t parent)
+{
+  lock_type _{mtx_};
+  BOOST_SAM_ASSERT(parent < nodes_.size());
+  nodes_.emplace_back(parent);
+  return nodes_.size() - 1u;
+}
+
+std::size_t lock_hierarchy_impl::blocked_at(std::size_t node, lock_mode mode, std::size_t within,
+                                            std::size_t queued_at, unsigned skipped) const noexcept
+{
+  auto res = nodes_.size();
+  auto m   = mode;
+  for (auto n = node; n != within; n = nodes_[n].parent, m = lock_mode_intention(mode))
+  {
+    auto &nd        = nodes_[n];
+    auto  conflicts = lock_mode_mask(nd.held) | (n == queued_at ? skipped : lock_mode_mask(nd.queued));
+    if ((conflicts & ~lock_mode_compatible(m)) != 0u)
+      res = n;
+    if (n == 0u)
+      break;
+  }
+  return res;
+}
+
+void lock_hierarchy_impl::acquire(std::size_t node, lock_mode mode, std::size_t within) noexcept
+{
+  auto m = mode;
+  for (auto n = node; n != within; n = nodes_[n].parent, m = lock_mode_intention(mode))
+  {
+    nodes_[n].held[static_cast<std::size_t>(m)]++;
+    if (n == 0u)
+      break;
+  }
+}
+
+void lock_hierarchy_impl::enqueue(detail::hierarchy_wait_op *waiter, std::size_t at) noexcept
+{
+  waiter->queued_at = at;
+  waiter->link_before(&nodes_[at].waiters);
+  nodes_[at].queued[static_cast<std::size_t>(lock_mode_at(waiter, at))]++;
+}
+
+void lock_hierarchy_impl::dequeue(detail::hierarchy_wait_op *waiter) noexcept
+{
+  nodes_[waiter->queued_at].queued[static_cast<std::size_t>(lock_mode_at(waiter, waiter->queued_at))]--;
+  waiter->unlink();
+  // the neighbours might change before the op completes & unlinks itself again.
+  waiter->next_ = waiter->prev_ = waiter;
+}
+
+void lock_hierarchy_impl::process(std::size_t node) noexcept
+{
+  unsigned skipped = 0u;
+  auto    &q       = nodes_[node].waiters;
+  auto     nx      = q.next_;
+  while (nx != &q)
+  {
+    auto waiter = static_cast<detail::hierarchy_wait_op *>(nx);
+    nx          = nx->next_;
+
+    const auto at = blocked_at(waiter->node, waiter->mode, waiter->within, node, skipped);
+    if (at == node)
+    {
+      // later waiters can't overtake it here.
+      skipped |= lock_mode_bit(lock_mode_at(waiter, node));
+      continue;
+    }
+
+    dequeue(waiter);
+    if (at == nodes_.size())
+    {
+      acquire(waiter->node, waiter->mode, waiter->within);
+      waiter->complete(error_code());
+    }
+    else
+      enqueue(waiter, at);
+  }
+}
+
+bool lock_hierarchy_impl::try_acquire(std::size_t node, lock_mode mode, std::size_t within) noexcept
+{
+  BOOST_SAM_ASSERT(node < nodes_.size());
+  BOOST_SAM_ASSERT(within == no_ancestor || within < node);
+  if (blocked_at(node, mode, within, nodes_.size(), 0u) != nodes_.size())
+    return false;
+  acquire(node, mode, within);
+  return true;
+}
+
+void lock_hierarchy_impl::add_waiter(detail::hierarchy_wait_op *waiter) noexcept
+{
+  const auto at = blocked_at(waiter->node, waiter->mode, waiter->within, nodes_.size(), 0u);
+  BOOST_SAM_ASSERT(at != nodes_.size());
+  enqueue(waiter, at);
+}
+
+void lock_hierarchy_impl::cancel_waiter(detail::hierarchy_wait_op *waiter, error_code ec) noexcept
+{
+  const auto at = waiter->queued_at;
+  dequeue(waiter);
+  waiter->complete(ec);
+  // the waiters behind it might have been blocked by it only.
+  process(at);
+}
+
+bool lock_hierarchy_impl::try_lock(std::size_t node, lock_mode mode, std::size_t within)
+{
+  lock_type _{mtx_};
+  return try_acquire(node, mode, within);
+}
+
+void lock_hierarchy_impl::unlock(std::size_t node, lock_mode mode, std::size_t within)
+{
+  lock_type _{mtx_};
+  BOOST_SAM_ASSERT(node < nodes_.size());
+  auto m = mode;
+  for (auto n = node; n != within; n = nodes_[n].parent, m = lock_mode_intention(mode))
+  {
+    BOOST_SAM_ASSERT(nodes_[n].held[static_cast<std::size_t>(m)] > 0u);
+    nodes_[n].held[static_cast<std::size_t>(m)]--;
+    if (n == 0u)
+      break;
+  }
+
+  for (auto n = node; n != within; n = nodes_[n].parent)
+  {
+    process(n);
+    if (n == 0u)
+      break;
+  }
+}
+
+struct lock_hierarchy_impl::lock_op_t final : detail::hierarchy_wait_op
+{
+  error_code   &ec;
+  bool          done = false;
+  detail::internal_condition_variable var;
+  lock_op_t(error_code &ec) : ec(ec) {}
+
+  void complete(error_code ec) override
+  {
+    done     = true;
+    this->ec = ec;
+    this->unlink();
+    var.notify_all();
+  }
+
+  void shutdown() override
+  {
+    done = true;
+    BOOST_SAM_ASSIGN_EC(this->ec, net::error::shut_down);
+    this->unlink();
+    var.notify_all();
+  }
+
+  void wait(lock_type &lock)
+  {
+    var.wait(lock, [this]{return done;});
+  }
+};
+
+void lock_hierarchy_impl::lock(std::size_t node, lock_mode mode, std::size_t within, error_code &ec)
+{
+  if (!this->mtx_.enabled())
+  {
+    if (try_lock(node, mode, within))
+      return;
+    else
+    {
+      BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+      return;
+    }
+  }
+
+  lock_type lock{mtx_};
+  if (try_acquire(node, mode, within))
+    return;
+  lock_op_t op{ec};
+  op.node   = node;
+  op.mode   = mode;
+  op.within = within;
+  add_waiter(&op);
+  op.wait(lock);
+}
+
+void lock_hierarchy_impl::shutdown()
+{
+  lock_type                                     l{mtx_};
+  detail::basic_bilist_holder<void(error_code)> w;
+  for (auto &nd : nodes_)
+  {
+    while (nd.waiters.next_ != &nd.waiters)
+    {
+      auto op = nd.waiters.next_;
+      op->unlink();
+      op->link_before(&w);
+    }
+    for (auto &q : nd.queued)
+      q = 0u;
+  }
+  l.unlock();
+  w.shutdown();
+}
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_LOCK_HIERARCHY_IMPL_IPP
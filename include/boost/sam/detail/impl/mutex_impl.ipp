@@ -15,7 +15,19 @@ BOOST_SAM_BEGIN_NAMESPACE
 namespace detail
 {
 
-void mutex_impl::add_waiter(detail::wait_op *waiter) noexcept { waiter->link_before(&waiters_); }
+void mutex_impl::add_waiter(detail::wait_op *waiter, std::size_t priority) noexcept
+{
+  waiters_.push(waiter, priority);
+}
+
+void mutex_impl::yield(detail::wait_op *waiter) noexcept
+{
+  BOOST_SAM_ASSERT(!waiters_.empty());
+  // ownership moves to the next waiter, so locked_ stays set.
+  waiters_.on_wakeup();
+  waiters_.front()->complete(error_code());
+  add_waiter(waiter);
+}
 
 struct mutex_impl::lock_op_t final : detail::wait_op
 {
@@ -75,13 +87,13 @@ void mutex_impl::unlock()
 {
   lock_type lock{mtx_};
   // release a pending operations
-  if (waiters_.next_ == &waiters_)
+  if (waiters_.empty())
   {
     locked_ = false;
     return;
   }
-  assert(waiters_.next_ != nullptr);
-  static_cast<detail::wait_op *>(waiters_.next_)->complete(std::error_code());
+  waiters_.on_wakeup();
+  waiters_.front()->complete(std::error_code());
 }
 
 mutex_impl::mutex_impl(net::execution_context &ctx, int concurrency_hint)
@@ -25,10 +25,10 @@ BOOST_SAM_BEGIN_NAMESPACE
 
 namespace detail
 {
-template <class Executor, class Handler, class Predicate, class... Ts>
-auto predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...)>::construct(Executor  e,
-                                                                                             Handler   handler,
-                                                                                             Predicate predicate)
+template <class Executor, class Handler, class Predicate, class Base, class... Ts>
+auto predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...), Base>::construct(Executor  e,
+                                                                                                   Handler   handler,
+                                                                                                   Predicate predicate)
     -> predicate_op_model *
 {
   auto halloc  = net::get_associated_allocator(handler);
@@ -47,8 +47,8 @@ auto predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...)
   }
 }
 
-template <class Executor, class Handler, class Predicate, class... Ts>
-auto predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...)>::destroy(
+template <class Executor, class Handler, class Predicate, class Base, class... Ts>
+auto predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...), Base>::destroy(
     predicate_op_model *self, net::associated_allocator_t<Handler> halloc) -> void
 {
   auto alloc = typename std::allocator_traits<decltype(halloc)>::template rebind_alloc<predicate_op_model>(halloc);
@@ -57,16 +57,16 @@ auto predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...)
   traits.deallocate(alloc, self, 1);
 }
 
-template <class Executor, class Handler, class Predicate, class... Ts>
-predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...)>::predicate_op_model(Executor  e,
-                                                                                                 Handler   handler,
-                                                                                                 Predicate predicate)
+template <class Executor, class Handler, class Predicate, class Base, class... Ts>
+predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...), Base>::predicate_op_model(
+    Executor e, Handler handler, Predicate predicate)
     : work_guard_(std::move(e)), handler_(std::move(handler)), predicate_(std::move(predicate))
 {
 }
 
-template <class Executor, class Handler, class Predicate, class... Ts>
-void predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...)>::complete(error_code ec, Ts... args)
+template <class Executor, class Handler, class Predicate, class Base, class... Ts>
+void predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...), Base>::complete(error_code ec,
+                                                                                                   Ts... args)
 {
   get_cancellation_slot().clear();
   auto g = std::move(work_guard_);
@@ -76,8 +76,8 @@ void predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...)
   net::post(g.get_executor(), net::append(std::move(h), ec, std::move(args)...));
 }
 
-template <class Executor, class Handler, class Predicate, class... Ts>
-void predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...)>::shutdown()
+template <class Executor, class Handler, class Predicate, class Base, class... Ts>
+void predicate_op_model<Executor, Handler, Predicate, void(error_code ec, Ts...), Base>::shutdown()
 {
   get_cancellation_slot().clear();
   this->unlink();
@@ -0,0 +1,166 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_RANGE_LOCK_IMPL_IPP
+#define BOOST_SAM_DETAIL_IMPL_RANGE_LOCK_IMPL_IPP
+
+#include <boost/sam/detail/range_lock_impl.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+range_lock_impl::range_lock_impl(net::execution_context &ctx, int concurrency_hint)
+    : detail::service_member(ctx, concurrency_hint)
+{
+}
+
+range_lock_impl::~range_lock_impl() = default;
+
+void range_timed_wait_op::on_expire(service_member *owner)
+{
+  static_cast<range_lock_impl *>(owner)->expire_waiter(this);
+}
+
+bool range_lock_impl::conflicts_held(std::uint64_t begin, std::uint64_t end, bool shared) const
+{
+  if (held_.empty() || begin == end)
+    return false;
+
+  const auto longest = *lengths_.rbegin();
+  auto       itr     = begin > longest ? held_.upper_bound(begin - longest) : held_.begin();
+
+  for (; itr != held_.end() && itr->first < end; itr++)
+    if (itr->second.end > begin && !(shared && itr->second.shared))
+      return true;
+  return false;
+}
+
+bool range_lock_impl::conflicts_waiting(const bilist_node *first, const bilist_node *last, std::uint64_t begin,
+                                        std::uint64_t end, bool shared) const noexcept
+{
+  for (auto nx = first; nx != last; nx = nx->next_)
+  {
+    auto w = static_cast<const detail::range_wait_op *>(nx);
+    if (w->begin < end && begin < w->end && !(shared && w->shared))
+      return true;
+  }
+  return false;
+}
+
+void range_lock_impl::acquire(std::uint64_t begin, std::uint64_t end, bool shared)
+{
+  held_.emplace(begin, held_range{end, shared});
+  lengths_.insert(end - begin);
+}
+
+bool range_lock_impl::try_acquire(std::uint64_t begin, std::uint64_t end, bool shared)
+{
+  BOOST_SAM_ASSERT(begin <= end);
+  if (conflicts_held(begin, end, shared) || conflicts_waiting(waiters_.next_, &waiters_, begin, end, shared))
+    return false;
+  acquire(begin, end, shared);
+  return true;
+}
+
+void range_lock_impl::add_waiter(detail::range_wait_op *waiter) noexcept { waiter->link_before(&waiters_); }
+
+void range_lock_impl::process(std::uint64_t begin, std::uint64_t end)
+{
+  auto nx = waiters_.next_;
+  while (nx != &waiters_)
+  {
+    auto w = static_cast<detail::range_wait_op *>(nx);
+    nx     = nx->next_;
+    // waiters that don't overlap are blocked by the same ranges as before.
+    if (!(w->begin < end && begin < w->end))
+      continue;
+    if (conflicts_held(w->begin, w->end, w->shared) ||
+        conflicts_waiting(waiters_.next_, w, w->begin, w->end, w->shared))
+      continue;
+
+    acquire(w->begin, w->end, w->shared);
+    w->complete(error_code());
+  }
+}
+
+void range_lock_impl::unlock(std::uint64_t begin, std::uint64_t end, bool shared)
+{
+  lock_type _{mtx_};
+  auto      rng = held_.equal_range(begin);
+  auto      itr = rng.first;
+  while (itr != rng.second && !(itr->second.end == end && itr->second.shared == shared))
+    itr++;
+
+  BOOST_SAM_ASSERT(itr != rng.second);
+  if (itr == rng.second)
+    return;
+  held_.erase(itr);
+  lengths_.erase(lengths_.find(end - begin));
+  process(begin, end);
+}
+
+bool range_lock_impl::try_lock(std::uint64_t begin, std::uint64_t end, bool shared)
+{
+  lock_type _{mtx_};
+  return try_acquire(begin, end, shared);
+}
+
+struct range_lock_impl::lock_op_t final : detail::range_wait_op
+{
+  error_code   &ec;
+  bool          done = false;
+  detail::internal_condition_variable var;
+  lock_op_t(error_code &ec) : ec(ec) {}
+
+  void complete(error_code ec) override
+  {
+    done     = true;
+    this->ec = ec;
+    this->unlink();
+    var.notify_all();
+  }
+
+  void shutdown() override
+  {
+    done = true;
+    BOOST_SAM_ASSIGN_EC(this->ec, net::error::shut_down);
+    this->unlink();
+    var.notify_all();
+  }
+
+  void wait(lock_type &lock)
+  {
+    var.wait(lock, [this]{return done;});
+  }
+};
+
+void range_lock_impl::lock(std::uint64_t begin, std::uint64_t end, bool shared, error_code &ec)
+{
+  if (!this->mtx_.enabled())
+  {
+    if (try_lock(begin, end, shared))
+      return;
+    else
+    {
+      BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+      return;
+    }
+  }
+
+  lock_type lock{mtx_};
+  if (try_acquire(begin, end, shared))
+    return;
+  lock_op_t op{ec};
+  op.begin  = begin;
+  op.end    = end;
+  op.shared = shared;
+  add_waiter(&op);
+  op.wait(lock);
+}
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_RANGE_LOCK_IMPL_IPP
@@ -0,0 +1,216 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_RATE_LIMITER_IMPL_IPP
+#define BOOST_SAM_DETAIL_IMPL_RATE_LIMITER_IMPL_IPP
+
+#include <boost/sam/detail/rate_limiter_impl.hpp>
+
+#include <algorithm>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+// refilling goes through doubles, so don't let rounding keep a waiter from its last token.
+constexpr double rate_limiter_epsilon = 1e-6;
+
+rate_limiter_impl::rate_limiter_impl(net::execution_context &ctx, int rate, clock_type::duration interval, int burst,
+                                     int concurrency_hint)
+    : detail::service_member(ctx, concurrency_hint),
+      per_token_(std::chrono::duration<double, std::nano>(interval) / rate), burst_(burst),
+      tokens_(static_cast<double>(burst)), last_(clock_type::now())
+{
+  BOOST_SAM_ASSERT(rate > 0);
+  BOOST_SAM_ASSERT(burst > 0);
+}
+
+rate_limiter_impl::rate_limiter_impl(rate_limiter_impl &&mi)
+    : detail::service_member(std::move(mi)), per_token_(mi.per_token_), burst_(mi.burst_), tokens_(mi.tokens_),
+      last_(mi.last_), exec_(mi.exec_)
+{
+  lock_type _{mi.mtx_};
+  mi.disarm();
+  waiters_ = std::move(mi.waiters_);
+  lock_type l{mtx_};
+  arm();
+}
+
+rate_limiter_impl &rate_limiter_impl::operator=(rate_limiter_impl &&lhs) noexcept
+{
+  lock_type _{mtx_};
+  lock_type l{lhs.mtx_};
+  disarm();
+  lhs.disarm();
+  detail::service_member::operator=(std::move(lhs));
+  per_token_ = lhs.per_token_;
+  burst_     = lhs.burst_;
+  tokens_    = lhs.tokens_;
+  last_      = lhs.last_;
+  exec_      = lhs.exec_;
+  std::swap(waiters_, lhs.waiters_);
+  arm();
+  lhs.arm();
+  return *this;
+}
+
+rate_limiter_impl::~rate_limiter_impl()
+{
+  lock_type _{mtx_};
+  disarm();
+}
+
+void rate_limiter_impl::shutdown()
+{
+  lock_type l{mtx_};
+  disarm();
+  auto w = std::move(waiters_);
+  l.unlock();
+  w.shutdown();
+}
+
+void rate_limiter_impl::refill(clock_type::time_point now) const
+{
+  if (now <= last_)
+    return;
+  tokens_ = (std::min)(static_cast<double>(burst_), tokens_ + (now - last_) / per_token_);
+  last_   = now;
+}
+
+bool rate_limiter_impl::try_acquire(int n)
+{
+  lock_type _{mtx_};
+  return try_acquire_locked(n);
+}
+
+bool rate_limiter_impl::try_acquire_locked(int n)
+{
+  if (waiters_.next_ != &waiters_)
+    return false;
+  refill(clock_type::now());
+  if (tokens_ + rate_limiter_epsilon < n)
+    return false;
+  tokens_ -= n;
+  return true;
+}
+
+void rate_limiter_impl::add_waiter(detail::semaphore_wait_op *waiter, const net::any_io_executor &exec)
+{
+  const bool first = waiters_.next_ == &waiters_;
+  waiter->link_before(&waiters_);
+  if (first)
+  {
+    exec_ = exec;
+    arm();
+  }
+}
+
+void rate_limiter_impl::cancel_waiter(detail::semaphore_wait_op *waiter, error_code ec)
+{
+  const bool first = waiters_.next_ == waiter;
+  waiter->complete(ec);
+  // the next one might be able to go right away, or needs a different refill time.
+  if (first)
+    wake_waiters();
+}
+
+void rate_limiter_impl::on_timeout() { wake_waiters(); }
+
+int rate_limiter_impl::available() const
+{
+  lock_type _{mtx_};
+  refill(clock_type::now());
+  return static_cast<int>(tokens_ + rate_limiter_epsilon);
+}
+
+void rate_limiter_impl::wake_waiters()
+{
+  refill(clock_type::now());
+  while (waiters_.next_ != &waiters_)
+  {
+    auto w = static_cast<detail::semaphore_wait_op *>(waiters_.next_);
+    if (tokens_ + rate_limiter_epsilon < w->weight)
+      break;
+    tokens_ -= w->weight;
+    w->complete(error_code());
+  }
+  arm();
+}
+
+void rate_limiter_impl::arm()
+{
+  disarm();
+  if (waiters_.next_ == &waiters_ || service == nullptr)
+    return;
+
+  auto       w       = static_cast<detail::semaphore_wait_op *>(waiters_.next_);
+  const auto missing = (std::max)(0.0, w->weight - tokens_);
+  const auto wait    = std::chrono::duration_cast<clock_type::duration>(per_token_ * missing);
+  service->add_timer(&refill_, this, last_ + wait, exec_);
+}
+
+void rate_limiter_impl::disarm()
+{
+  if (refill_.armed)
+    refill_.service->remove_timer(&refill_);
+}
+
+struct rate_limiter_impl::acquire_op_t final : detail::semaphore_wait_op
+{
+  error_code                         &ec;
+  bool                                done = false;
+  detail::internal_condition_variable var;
+  acquire_op_t(error_code &ec) : ec(ec) {}
+
+  void complete(error_code ec) override
+  {
+    done     = true;
+    this->ec = ec;
+    this->unlink();
+    var.notify_all();
+  }
+
+  void shutdown() override
+  {
+    done = true;
+    BOOST_SAM_ASSIGN_EC(this->ec, net::error::shut_down);
+    this->unlink();
+    var.notify_all();
+  }
+
+  void wait(lock_type &lock)
+  {
+    var.wait(lock, [this] { return done; });
+  }
+};
+
+void rate_limiter_impl::acquire(int n, error_code &ec, const net::any_io_executor &exec)
+{
+  if (n > burst_)
+  {
+    BOOST_SAM_ASSIGN_EC(ec, net::error::invalid_argument);
+    return;
+  }
+
+  if (!this->mtx_.enabled())
+  {
+    if (try_acquire(n))
+      return;
+    BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+    return;
+  }
+
+  lock_type lock{mtx_};
+  if (try_acquire_locked(n))
+    return;
+  acquire_op_t op{ec};
+  op.weight = n;
+  add_waiter(&op, exec);
+  op.wait(lock);
+}
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_RATE_LIMITER_IMPL_IPP
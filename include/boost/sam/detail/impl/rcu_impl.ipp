@@ -0,0 +1,214 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_RCU_IMPL_IPP
+#define BOOST_SAM_DETAIL_IMPL_RCU_IMPL_IPP
+
+#include <boost/sam/detail/rcu_impl.hpp>
+#include <boost/sam/detail/thread_slots.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+rcu_impl::rcu_impl(net::execution_context &ctx, int concurrency_hint)
+    : detail::service_member(ctx, concurrency_hint), slot_count_(slot_count(mtx_.enabled())),
+      slots_(slot_count_)
+{
+}
+
+rcu_impl::~rcu_impl() { reclaim(retired_head_); }
+
+auto rcu_impl::slot() noexcept -> reader_slot &
+{
+  return slots_[thread_slot(slot_count_)];
+}
+
+std::ptrdiff_t rcu_impl::readers(std::uint64_t epoch) const noexcept
+{
+  // a grace period waits for the readers on every slot.
+  std::ptrdiff_t sum = 0;
+  for (std::size_t i = 0u; i < slot_count_; i++)
+    sum += slots_[i].count[epoch & 1u].count.load(std::memory_order_seq_cst);
+  return sum;
+}
+
+auto rcu_impl::read_lock() noexcept -> reader_counter &
+{
+  auto &s = slot();
+  for (;;)
+  {
+    const auto epoch   = epoch_.load(std::memory_order_seq_cst);
+    auto      &counter = s.count[epoch & 1u];
+    counter.count.fetch_add(1, std::memory_order_seq_cst);
+    // if the epoch didn't change, the next grace period is guaranteed to see this reader.
+    if (epoch_.load(std::memory_order_seq_cst) == epoch)
+      return counter;
+    read_unlock(counter);
+  }
+}
+
+void rcu_impl::read_unlock(reader_counter &counter) noexcept
+{
+  // A counter is always left through the slot it was entered on, so it never drops below zero,
+  // and the grace period can only end once the last of its counters gets emptied.
+  // That's the only reader needing the mutex, every other one just leaves.
+  // Pairs with start_grace: either the grace period sees the decrement when summing up, or this sees it draining.
+  if (counter.count.fetch_sub(1, std::memory_order_seq_cst) != 1 ||
+      draining_.load(std::memory_order_seq_cst) != counter.parity + 1u)
+    return;
+
+  lock_type l{mtx_};
+  auto      reclaimed = check_grace();
+  l.unlock();
+  reclaim(reclaimed);
+}
+
+void rcu_impl::retire(rcu_node *node)
+{
+  lock_type l{mtx_};
+  node->epoch = epoch_.load(std::memory_order_seq_cst);
+  if (retired_tail_ != nullptr)
+    retired_tail_->next = node;
+  else
+    retired_head_ = node;
+  retired_tail_ = node;
+
+  // nobody might ever wait for a grace period, so start one to get the node deleted.
+  rcu_node *reclaimed = nullptr;
+  if (!in_grace_)
+    reclaimed = start_grace();
+  l.unlock();
+  reclaim(reclaimed);
+}
+
+rcu_node *rcu_impl::start_grace() noexcept
+{
+  BOOST_SAM_ASSERT(!in_grace_);
+  in_grace_    = true;
+  grace_epoch_ = epoch_.fetch_add(1u, std::memory_order_seq_cst);
+  draining_.store(1u + (grace_epoch_ & 1u), std::memory_order_seq_cst);
+  return check_grace();
+}
+
+rcu_node *rcu_impl::check_grace() noexcept
+{
+  rcu_node  *reclaimed = nullptr;
+  rcu_node **tail      = &reclaimed;
+
+  while (in_grace_ && readers(grace_epoch_) == 0)
+  {
+    in_grace_ = false;
+    draining_.store(0u, std::memory_order_seq_cst);
+
+    while (retired_head_ != nullptr && retired_head_->epoch <= grace_epoch_)
+    {
+      auto node     = retired_head_;
+      retired_head_ = node->next;
+      node->next    = nullptr;
+      *tail         = node;
+      tail          = &node->next;
+    }
+    if (retired_head_ == nullptr)
+      retired_tail_ = nullptr;
+
+    waiters_.complete_all(error_code());
+
+    // the waiters that arrived during this grace period might have missed readers, so they need another one,
+    // and so do the nodes retired during it.
+    if (next_waiters_.next_ != &next_waiters_ || retired_head_ != nullptr)
+    {
+      while (next_waiters_.next_ != &next_waiters_)
+      {
+        auto op = next_waiters_.next_;
+        op->unlink();
+        op->link_before(&waiters_);
+      }
+      in_grace_    = true;
+      grace_epoch_ = epoch_.fetch_add(1u, std::memory_order_seq_cst);
+      draining_.store(1u + (grace_epoch_ & 1u), std::memory_order_seq_cst);
+    }
+  }
+  return reclaimed;
+}
+
+bool rcu_impl::synchronize_or_add_waiter(detail::wait_op *waiter, rcu_node *&reclaimed) noexcept
+{
+  if (in_grace_)
+  {
+    waiter->link_before(&next_waiters_);
+    reclaimed = nullptr;
+    return false;
+  }
+
+  reclaimed = start_grace();
+  if (!in_grace_)
+    return true;
+  waiter->link_before(&waiters_);
+  return false;
+}
+
+void rcu_impl::reclaim(rcu_node *node) noexcept
+{
+  while (node != nullptr)
+  {
+    auto next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
+struct rcu_impl::synchronize_op_t final : detail::wait_op
+{
+  error_code   &ec;
+  bool          done = false;
+  detail::internal_condition_variable var;
+  synchronize_op_t(error_code &ec) : ec(ec) {}
+
+  void complete(error_code ec) override
+  {
+    done     = true;
+    this->ec = ec;
+    this->unlink();
+    var.notify_all();
+  }
+
+  void shutdown() override
+  {
+    done = true;
+    BOOST_SAM_ASSIGN_EC(this->ec, net::error::shut_down);
+    this->unlink();
+    var.notify_all();
+  }
+
+  void wait(lock_type &lock)
+  {
+    var.wait(lock, [this]{return done;});
+  }
+};
+
+void rcu_impl::synchronize(error_code &ec)
+{
+  lock_type        lock{mtx_};
+  synchronize_op_t op{ec};
+  rcu_node        *reclaimed = nullptr;
+  if (!synchronize_or_add_waiter(&op, reclaimed))
+  {
+    if (!this->mtx_.enabled())
+    {
+      // nobody else can end the grace period while this thread waits.
+      op.unlink();
+      BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+      return;
+    }
+    op.wait(lock);
+  }
+  lock.unlock();
+  reclaim(reclaimed);
+}
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_RCU_IMPL_IPP
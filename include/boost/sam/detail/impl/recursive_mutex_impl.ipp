@@ -0,0 +1,98 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_RECURSIVE_MUTEX_IMPL_IPP
+#define BOOST_SAM_DETAIL_IMPL_RECURSIVE_MUTEX_IMPL_IPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/recursive_mutex_impl.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+void recursive_mutex_impl::add_waiter(detail::recursive_wait_op *waiter) noexcept { waiter->link_before(&waiters_); }
+
+struct recursive_mutex_impl::lock_op_t final : detail::recursive_wait_op
+{
+  error_code   &ec;
+  bool          done = false;
+  detail::internal_condition_variable var;
+  lock_op_t(const void *owner, error_code &ec) : ec(ec) { this->owner = owner; }
+
+  void complete(error_code ec) override
+  {
+    done     = true;
+    this->ec = ec;
+    this->unlink();
+    var.notify_all();
+  }
+
+  void shutdown() override
+  {
+    done = true;
+    BOOST_SAM_ASSIGN_EC(this->ec, net::error::shut_down);
+    this->unlink();
+    var.notify_all();
+  }
+
+  void wait(lock_type &lock)
+  {
+    var.wait(lock, [this]{return done;});
+  }
+};
+
+void recursive_mutex_impl::lock(const void *owner, error_code &ec)
+{
+  if (!this->mtx_.enabled())
+  {
+    if (try_lock(owner))
+      return;
+    else
+    {
+      BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+      return;
+    }
+  }
+
+  lock_type lock{mtx_};
+  if (try_acquire(owner))
+    return;
+
+  lock_op_t op{owner, ec};
+  add_waiter(&op);
+  op.wait(lock);
+}
+
+void recursive_mutex_impl::unlock()
+{
+  lock_type lock{mtx_};
+  BOOST_SAM_ASSERT(depth_ > 0u);
+  if (--depth_ > 0u)
+    return;
+
+  if (waiters_.next_ == &waiters_)
+  {
+    owner_ = nullptr;
+    return;
+  }
+  // hand the ownership to the next waiter.
+  auto w = static_cast<detail::recursive_wait_op *>(waiters_.next_);
+  owner_ = w->owner;
+  depth_ = 1u;
+  w->complete(error_code());
+}
+
+recursive_mutex_impl::recursive_mutex_impl(net::execution_context &ctx, int concurrency_hint)
+    : detail::service_member(ctx, concurrency_hint), owner_(nullptr), depth_(0u)
+{
+}
+
+recursive_mutex_impl::~recursive_mutex_impl() = default;
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_RECURSIVE_MUTEX_IMPL_IPP
@@ -9,6 +9,8 @@
 #include <boost/sam/detail/basic_op.hpp>
 #include <boost/sam/detail/semaphore_impl.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <condition_variable>
 
 BOOST_SAM_BEGIN_NAMESPACE
@@ -22,24 +24,277 @@ semaphore_impl::semaphore_impl(net::execution_context &ctx,
 {
 }
 
-void semaphore_impl::add_waiter(detail::wait_op *waiter) noexcept { waiter->link_before(&waiters_); }
+bool semaphore_impl::shed_on_enqueue(std::chrono::steady_clock::time_point deadline) const
+{
+  if (queued_ >= shedding_.max_queue_length)
+    return true;
+  // the delay is only known while there's a queue.
+  if (shedding_.target.count() == 0 || queued_ == 0u ||
+      deadline == (std::chrono::steady_clock::time_point::max)())
+    return false;
+  return deadline - std::chrono::steady_clock::now() < shedding_.delay;
+}
 
-int semaphore_impl::count() const noexcept { return count_; }
+void semaphore_impl::add_waiter(detail::semaphore_wait_op *waiter, std::size_t priority)
+{
+  if (shedding_.target.count() != 0)
+  {
+    waiter->enqueued = std::chrono::steady_clock::now();
+    if (tracks_deadline(waiter))
+      deadlines_.emplace(waiter->deadline - waiter->enqueued, waiter);
+  }
+  queued_++;
+  waiting_ += waiter->weight;
+  waiters_.push(waiter, priority);
+  // a release might have missed the waiter, so look at the count again.
+  wake_waiters();
+}
 
-void semaphore_impl::release()
+void semaphore_impl::cancel_waiter(detail::semaphore_wait_op *waiter, error_code ec)
 {
-  lock_type lock_{mtx_};;
+  waiting_ -= waiter->weight;
+  queued_--;
+  forget_deadline(waiter);
+  waiter->complete(ec);
+  // it might have blocked the waiters behind it
+  wake_waiters();
+}
+
+void semaphore_impl::expire_waiter(detail::semaphore_wait_op *waiter)
+{
+  waiting_ -= waiter->weight;
+  queued_--;
+  forget_deadline(waiter);
+}
+
+void semaphore_impl::forget_deadline(detail::semaphore_wait_op *waiter)
+{
+  if (tracks_deadline(waiter))
+    deadlines_.erase(deadlines_.find(std::make_pair(waiter->deadline - waiter->enqueued, waiter)));
+}
+
+bool semaphore_impl::shed_late_waiters()
+{
+  bool shed = false;
+  while (!deadlines_.empty() && deadlines_.begin()->first < shedding_.delay)
+  {
+    auto w = deadlines_.begin()->second;
+    deadlines_.erase(deadlines_.begin());
+    waiting_ -= w->weight;
+    queued_--;
+    w->complete(net::error::try_again);
+    shed = true;
+  }
+  return shed;
+}
+
+void semaphore_timed_wait_op::on_expire(service_member *owner)
+{
+  static_cast<semaphore_impl *>(owner)->expire_waiter(this);
+}
+
+void semaphore_impl::on_timeout()
+{
+  reclaim_leases();
+  wake_waiters();
+}
+
+semaphore_impl::~semaphore_impl()
+{
+  lock_type _{mtx_};
+  disarm_leases();
+}
+
+std::uint64_t semaphore_impl::add_lease(std::chrono::steady_clock::duration ttl, const net::any_io_executor &exec)
+{
+  lock_type _{mtx_};
+  const auto id       = leases_.next_id++;
+  const auto deadline = semaphore_leases::clock_type::now() + ttl;
+  leases_.deadlines.emplace(id, deadline);
+  const auto itr = leases_.queue.emplace(deadline, id).first;
+  if (!lease_exec_)
+    lease_exec_ = exec;
+  if (itr == leases_.queue.begin())
+    arm_leases();
+  return id;
+}
+
+bool semaphore_impl::renew_lease(std::uint64_t id, std::chrono::steady_clock::duration ttl)
+{
+  lock_type _{mtx_};
+  auto itr = leases_.deadlines.find(id);
+  if (itr == leases_.deadlines.end())
+    return false;
+
+  const auto first    = leases_.queue.begin()->second == id;
+  const auto deadline = semaphore_leases::clock_type::now() + ttl;
+  leases_.queue.erase(std::make_pair(itr->second, id));
+  itr->second = deadline;
+  if (leases_.queue.emplace(deadline, id).first == leases_.queue.begin() || first)
+    arm_leases();
+  return true;
+}
+
+bool semaphore_impl::release_lease(std::uint64_t id)
+{
+  lock_type _{mtx_};
+  if (!erase_lease(id))
+    return false;
   count_++;
+  wake_waiters();
+  return true;
+}
+
+bool semaphore_impl::has_lease(std::uint64_t id) const
+{
+  lock_type _{mtx_};
+  return leases_.deadlines.count(id) != 0u;
+}
+
+std::size_t semaphore_impl::leases() const
+{
+  lock_type _{mtx_};
+  return leases_.deadlines.size();
+}
+
+bool semaphore_impl::erase_lease(std::uint64_t id)
+{
+  auto itr = leases_.deadlines.find(id);
+  if (itr == leases_.deadlines.end())
+    return false;
 
-  // release a pending operations
-  if (waiters_.next_ == &waiters_)
+  const auto first = leases_.queue.begin()->second == id;
+  leases_.queue.erase(std::make_pair(itr->second, id));
+  leases_.deadlines.erase(itr);
+  if (first)
+    arm_leases();
+  return true;
+}
+
+void semaphore_impl::reclaim_leases()
+{
+  if (lease_timer_.armed || leases_.queue.empty())
     return;
 
-  decrement();
-  static_cast<detail::wait_op *>(waiters_.next_)->complete(std::error_code());
+  const auto now = semaphore_leases::clock_type::now();
+  while (!leases_.queue.empty() && leases_.queue.begin()->first <= now)
+  {
+    leases_.deadlines.erase(leases_.queue.begin()->second);
+    leases_.queue.erase(leases_.queue.begin());
+    count_++;
+  }
+  arm_leases();
 }
 
-struct semaphore_impl::acquire_op_t final : detail::wait_op
+void semaphore_impl::arm_leases()
+{
+  disarm_leases();
+  if (leases_.queue.empty() || service == nullptr)
+    return;
+  service->add_timer(&lease_timer_, this, leases_.queue.begin()->first, lease_exec_);
+}
+
+void semaphore_impl::disarm_leases()
+{
+  if (lease_timer_.armed)
+    lease_timer_.service->remove_timer(&lease_timer_);
+}
+
+void semaphore_impl::release(int n)
+{
+  count_ += n;
+  if (waiting_.load() == 0)
+    return;
+
+  lock_type lock_{mtx_};;
+  wake_waiters();
+}
+
+void semaphore_impl::wake_waiters()
+{
+  if (count_.load() <= 0 || waiters_.empty())
+    return;
+
+  const bool controlled = shedding_.target.count() != 0;
+  const auto now        = controlled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+  std::size_t woken = 0u;
+  // one pass, in priority & FIFO order
+  waiters_.visit(
+      [&](detail::wait_op *op)
+      {
+        auto w = static_cast<detail::semaphore_wait_op *>(op);
+        if (!try_take(w->weight))
+          return !strict_fifo_;
+        waiting_ -= w->weight;
+        queued_--;
+        forget_deadline(w);
+        if (controlled && codel_drop(now - w->enqueued, now))
+        {
+          // the permits go to the next waiter instead.
+          count_ += w->weight;
+          w->complete(net::error::try_again);
+          return true;
+        }
+        w->complete(std::error_code());
+        woken++;
+        return count_.load() > 0;
+      });
+
+  // aging counts the waiters handed permits, not the passes. It moves waiters between lanes, so not while visiting.
+  while (woken-- > 0u)
+    waiters_.on_wakeup();
+
+  // the queue delay might have grown, so some deadlines can't be met anymore.
+  // Shedding a waiter might unblock the ones behind it.
+  if (controlled && shed_late_waiters() && strict_fifo_)
+    wake_waiters();
+}
+
+// The control law of CoDel: once the queue delay stayed above the target for an interval,
+// drop a waiter & keep dropping at a rate that increases with the square root of the drops,
+// until the delay gets below the target again.
+bool semaphore_impl::codel_drop(std::chrono::steady_clock::duration delay, std::chrono::steady_clock::time_point now)
+{
+  auto &sh = shedding_;
+  sh.delay = delay;
+
+  bool above = false;
+  // no point in dropping the last waiter, there's no standing queue then.
+  if (delay < sh.target || queued_ == 0u)
+    sh.first_above = {};
+  else if (sh.first_above == std::chrono::steady_clock::time_point{})
+    sh.first_above = now + sh.interval;
+  else
+    above = now >= sh.first_above;
+
+  const auto next_drop = [&](std::chrono::steady_clock::time_point tp)
+  {
+    return tp + std::chrono::duration_cast<std::chrono::steady_clock::duration>(sh.interval / std::sqrt(sh.drop_count));
+  };
+
+  if (sh.dropping)
+  {
+    if (!above)
+      sh.dropping = false;
+    else if (now >= sh.drop_next)
+    {
+      sh.drop_count++;
+      sh.drop_next = next_drop(sh.drop_next);
+      return true;
+    }
+    return false;
+  }
+  if (!above)
+    return false;
+
+  sh.dropping = true;
+  // start with the drop rate of the last dropping state, if it ended recently.
+  sh.drop_count = (sh.drop_count > 2u && now - sh.drop_next < 16 * sh.interval) ? sh.drop_count - 2u : 1u;
+  sh.drop_next  = next_drop(now);
+  return true;
+}
+
+struct semaphore_impl::acquire_op_t final : detail::semaphore_wait_op
 {
   error_code   &ec;
   bool          done = false;
@@ -68,11 +323,11 @@ struct semaphore_impl::acquire_op_t final : detail::wait_op
   }
 };
 
-void semaphore_impl::acquire(error_code &ec)
+void semaphore_impl::acquire(error_code &ec, int n)
 {
   if (!mtx_.enabled())
   {
-    if (try_acquire())
+    if (try_acquire(n))
       return;
     else
     {
@@ -81,43 +336,43 @@ void semaphore_impl::acquire(error_code &ec)
     }
   }
 
-  lock_type    lock{mtx_};
-  acquire_op_t op{ec};
-  add_waiter(&op);
-  if (count_ > 0)
+  if (try_acquire_uncontended(n))
+    return;
+
+  lock_type lock{mtx_};
+  if (try_acquire_locked(n))
+    return;
+  if (shed_on_enqueue())
   {
-    decrement();
-    op.unlink();
+    BOOST_SAM_ASSIGN_EC(ec, net::error::try_again);
     return;
   }
+  acquire_op_t op{ec};
+  op.weight = n;
+  add_waiter(&op);
   op.wait(lock);
 }
 
-BOOST_SAM_NODISCARD int semaphore_impl::value() const noexcept
+bool semaphore_impl::try_acquire(int n)
 {
-  lock_type lock_{mtx_};;
-  if (waiters_.next_ == &waiters_)
-    return count();
-
-  return count() - static_cast<int>(waiters_.size());
-}
+  if (uncontended())
+    return try_take(n);
 
-bool semaphore_impl::try_acquire()
-{
   lock_type _{mtx_};
-  if (count_ > 0)
-  {
-    --count_;
-    return true;
-  }
-  else
-    return false;
+  return try_acquire_locked(n);
 }
 
-int semaphore_impl::decrement()
+int semaphore_impl::take_up_to(int n)
 {
-  BOOST_SAM_ASSERT(count_ > 0);
-  return --count_;
+  wake_waiters();
+  if (strict_fifo_ && !waiters_.empty())
+    return 0;
+
+  int c = count_.load();
+  while (c > 0)
+    if (count_.compare_exchange_weak(c, c - (std::min)(n, c)))
+      return (std::min)(n, c);
+  return 0;
 }
 
 } // namespace detail
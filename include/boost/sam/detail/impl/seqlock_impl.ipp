@@ -0,0 +1,41 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_SEQLOCK_IMPL_IPP
+#define BOOST_SAM_DETAIL_IMPL_SEQLOCK_IMPL_IPP
+
+#include <boost/sam/detail/seqlock_impl.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+void seqlock_impl::write_end()
+{
+  const auto seq = seq_.load(std::memory_order_relaxed) + 1u;
+  BOOST_SAM_ASSERT((seq & 1u) == 0u);
+  seq_.store(seq, std::memory_order_release);
+
+  // add_version_waiter checks the version with mtx_ held, so no waiter can miss this.
+  lock_type l{mtx_};
+  const auto version = seq >> 1u;
+  auto       nx      = version_waiters_.next_;
+  while (nx != &version_waiters_)
+  {
+    auto op = static_cast<detail::version_wait_op *>(nx);
+    nx      = nx->next_;
+    if (op->version < version)
+      op->complete(error_code());
+  }
+}
+
+void seqlock_impl::add_version_waiter(detail::version_wait_op *waiter) noexcept
+{
+  waiter->link_before(&version_waiters_);
+}
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_SEQLOCK_IMPL_IPP
@@ -20,8 +20,99 @@ op_list_service::op_list_service(asio::execution_context &ctx)
 {
 }
 
+void op_list_service::add_timer(timer_entry *entry, service_member *owner,
+                                std::chrono::steady_clock::time_point deadline, const net::any_io_executor &exec)
+{
+  lock_type lock{mtx_};
+  entry->service = this;
+  entry->owner   = owner;
+  entry->tick    = wheel_.tick_of(deadline);
+  entry->armed   = true;
+  wheel_.insert(entry);
+  if (!timer_)
+    timer_.reset(new net::steady_timer(exec));
+  arm_timer();
+}
+
+void op_list_service::remove_timer(timer_entry *entry)
+{
+  lock_type lock{mtx_};
+  wheel_.remove(entry);
+  entry->armed = false;
+  // don't keep the context busy with a timer nobody waits for.
+  if (wheel_.empty() && timer_armed_)
+  {
+    timer_armed_ = false;
+    timer_->cancel();
+  }
+}
+
+void op_list_service::rebind_timer(timer_entry *entry, service_member *owner)
+{
+  // on_timer reads the owner under our mutex.
+  lock_type lock{mtx_};
+  entry->owner = owner;
+}
+
+void op_list_service::arm_timer()
+{
+  std::uint64_t tick;
+  if (!wheel_.next_tick(tick) || (timer_armed_ && timer_tick_ <= tick))
+    return;
+
+  timer_armed_ = true;
+  timer_tick_  = tick;
+  timer_->expires_at(wheel_.time_of(tick));
+  timer_->async_wait([this](error_code ec) { on_timer(ec); });
+}
+
+void op_list_service::on_timer(error_code ec)
+{
+  // re-armed or cancelled
+  if (ec == net::error::operation_aborted)
+    return;
+
+  lock_type lock{mtx_};
+  timer_armed_ = false;
+
+  bilist_node expired;
+  wheel_.advance(timer_wheel::clock_type::now(), expired);
+  // the service's mutex gets released while expiring an entry, so others might remove entries from the list meanwhile.
+  while (expired.next_ != &expired)
+  {
+    auto entry = static_cast<timer_entry *>(expired.next_);
+    auto owner = entry->owner;
+    wheel_.remove(entry);
+
+    // the owner's mutex gets locked before ours everywhere else, so don't wait for it.
+    // It might be held while waiting to remove this very entry, so put the entry back instead.
+    // Its tick passed already, so it gets retried with the next tick, about a millisecond later.
+    if (!owner->mtx_.try_lock())
+    {
+      wheel_.insert(entry);
+      continue;
+    }
+
+    entry->armed = false;
+    lock.unlock();
+    entry->expire();
+    owner->on_timeout();
+    owner->mtx_.unlock();
+    lock.lock();
+  }
+
+  if (timer_)
+    arm_timer();
+}
+
 void op_list_service::shutdown()
 {
+  {
+    lock_type lock{mtx_};
+    timer_armed_ = false;
+    timer_.reset();
+  }
+
   using op = service_member;
   auto e   = std::move(entries);
   auto nx  = e.next_;
@@ -16,6 +16,115 @@ namespace detail
 
 void shared_mutex_impl::add_shared_waiter(detail::wait_op *waiter) noexcept { waiter->link_before(&shared_waiters_); }
 
+void shared_mutex_impl::add_upgrade_waiter(detail::wait_op *waiter) noexcept
+{
+  waiter->link_before(&upgrade_waiters_);
+}
+
+bool shared_mutex_impl::hand_over() noexcept
+{
+  // only writer_preferring lets waiting writers go before the readers.
+  if ((shared_waiters_.next_ != &shared_waiters_ || upgrade_waiters_.next_ != &upgrade_waiters_) &&
+      (policy_ != shared_mutex_policy::writer_preferring || waiters_.empty()))
+  {
+    locked_ = false;
+    while (shared_waiters_.next_ != &shared_waiters_)
+    {
+      locked_shared_++;
+      static_cast<detail::wait_op *>(shared_waiters_.next_)->complete(error_code());
+    }
+    admit_upgrade_waiter();
+    return true;
+  }
+
+  if (waiters_.empty())
+    return false;
+  // ownership moves to the next waiter, so locked_ stays set.
+  waiters_.front()->complete(error_code());
+  return true;
+}
+
+void shared_mutex_impl::yield(detail::wait_op *waiter) noexcept
+{
+  const bool handed_over = hand_over();
+  BOOST_SAM_ASSERT(handed_over);
+  ignore_unused(handed_over);
+  add_waiter(waiter);
+}
+
+void shared_mutex_impl::relock_shared(detail::wait_op *waiter) noexcept
+{
+  BOOST_SAM_ASSERT(locked_shared_ > 0u);
+  BOOST_SAM_ASSERT(!waiters_.empty());
+  add_shared_waiter(waiter);
+  if (--locked_shared_ == 0u)
+    on_readers_drained();
+}
+
+void shared_mutex_impl::admit_shared_waiters() noexcept
+{
+  if (locked_ || !waiters_.empty())
+    return;
+
+  while (shared_waiters_.next_ != &shared_waiters_)
+  {
+    locked_shared_++;
+    static_cast<detail::wait_op *>(shared_waiters_.next_)->complete(error_code());
+  }
+  admit_upgrade_waiter();
+}
+
+void shared_mutex_impl::admit_upgrade_waiter() noexcept
+{
+  if (upgrade_waiters_.next_ == &upgrade_waiters_ || locked_ || upgrade_locked_)
+    return;
+
+  upgrade_locked_ = true;
+  static_cast<detail::wait_op *>(upgrade_waiters_.next_)->complete(error_code());
+}
+
+void shared_mutex_impl::on_readers_drained() noexcept
+{
+  // the pending upgrade already holds back everyone else.
+  if (upgrading_.next_ != &upgrading_)
+  {
+    upgrade_locked_ = false;
+    static_cast<detail::wait_op *>(upgrading_.next_)->complete(error_code());
+  }
+  else if (!upgrade_locked_ && !waiters_.empty())
+  {
+    locked_ = true;
+    waiters_.front()->complete(error_code());
+  }
+}
+
+bool shared_mutex_impl::upgrade_or_add_waiter(detail::wait_op *waiter) noexcept
+{
+  BOOST_SAM_ASSERT(upgrade_locked_ && !locked_);
+  // locking right away keeps new readers & writers out, so the upgrade can't starve.
+  locked_ = true;
+  if (locked_shared_ == 0u)
+  {
+    upgrade_locked_ = false;
+    return true;
+  }
+  waiter->link_before(&upgrading_);
+  return false;
+}
+
+void shared_mutex_impl::cancel_upgrade() noexcept
+{
+  BOOST_SAM_ASSERT(upgrade_locked_ && locked_);
+  locked_ = false;
+  // the readers that queued up behind the upgrade were only held back by it.
+  if (can_lock_shared())
+    while (shared_waiters_.next_ != &shared_waiters_)
+    {
+      locked_shared_++;
+      static_cast<detail::wait_op *>(shared_waiters_.next_)->complete(error_code());
+    }
+}
+
 void shared_mutex_impl::lock(error_code &ec)
 {
   if (!this->mtx_.enabled())
@@ -32,7 +141,7 @@ void shared_mutex_impl::lock(error_code &ec)
   lock_type lock{mtx_};
   lock_op_t op{ec};
   add_waiter(&op);
-  if (!locked_ && locked_shared_ == 0u)
+  if (can_lock())
   {
     locked_ = true;
     op.unlink();
@@ -44,26 +153,8 @@ void shared_mutex_impl::lock(error_code &ec)
 void shared_mutex_impl::unlock()
 {
   lock_type lock{mtx_};
-  if (shared_waiters_.next_ != &shared_waiters_)
-  {
-    // unlock unique lock
+  if (!hand_over())
     locked_ = false;
-    while (shared_waiters_.next_ != &shared_waiters_)
-    {
-      locked_shared_++;
-      static_cast<detail::wait_op *>(shared_waiters_.next_)->complete(std::error_code());
-    }
-    return ;
-  }
-
-  // release a pending operations
-  if (waiters_.next_ == &waiters_)
-  {
-    locked_ = false;
-    return;
-  }
-  assert(waiters_.next_ != nullptr);
-  static_cast<detail::wait_op *>(waiters_.next_)->complete(std::error_code());
 }
 
 
@@ -82,8 +173,8 @@ void shared_mutex_impl::lock_shared(error_code &ec)
 
   lock_type lock{mtx_};
   lock_op_t op{ec};
-  add_waiter(&op);
-  if (!locked_)
+  add_shared_waiter(&op);
+  if (can_lock_shared())
   {
     locked_shared_++;
     op.unlink();
@@ -99,14 +190,74 @@ void shared_mutex_impl::unlock_shared()
   if (locked_shared_ > 0u)
     locked_shared_--;
   if (locked_shared_ == 0u)
+    on_readers_drained();
+}
+
+void shared_mutex_impl::downgrade()
+{
+  lock_type lock{mtx_};
+  BOOST_SAM_ASSERT(locked_ && locked_shared_ == 0u);
+  locked_ = false;
+  locked_shared_++;
+
+  // whatever the policy, the readers that waited for this writer get in with it, while writers keep waiting.
+  while (shared_waiters_.next_ != &shared_waiters_)
+  {
+    locked_shared_++;
+    static_cast<detail::wait_op *>(shared_waiters_.next_)->complete(error_code());
+  }
+  admit_upgrade_waiter();
+}
+
+void shared_mutex_impl::lock_upgrade(error_code &ec)
+{
+  if (!this->mtx_.enabled())
   {
-    if (waiters_.next_ != &waiters_)
+    if (try_lock_upgrade())
+      return;
+    else
     {
-      locked_ = true;
-      static_cast<detail::wait_op *>(waiters_.next_)->complete(std::error_code());
+      BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+      return;
     }
+  }
 
+  lock_type lock{mtx_};
+  lock_op_t op{ec};
+  add_upgrade_waiter(&op);
+  if (can_lock_upgrade())
+  {
+    upgrade_locked_ = true;
+    op.unlink();
+    return;
   }
+  op.wait(lock);
+}
+
+void shared_mutex_impl::unlock_upgrade()
+{
+  lock_type lock{mtx_};
+  BOOST_SAM_ASSERT(upgrade_locked_ && !locked_);
+  upgrade_locked_ = false;
+
+  if (locked_shared_ == 0u && !waiters_.empty())
+  {
+    locked_ = true;
+    waiters_.front()->complete(error_code());
+  }
+  else if (can_lock_shared())
+    admit_upgrade_waiter();
+}
+
+bool shared_mutex_impl::try_upgrade()
+{
+  lock_type lock{mtx_};
+  BOOST_SAM_ASSERT(upgrade_locked_ && !locked_);
+  if (locked_shared_ > 0u)
+    return false;
+
+  upgrade_locked_ = false;
+  return locked_ = true;
 }
 
 
@@ -0,0 +1,100 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_STRIPED_MUTEX_IMPL_IPP
+#define BOOST_SAM_DETAIL_IMPL_STRIPED_MUTEX_IMPL_IPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/striped_mutex_impl.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+striped_mutex_impl::striped_mutex_impl(net::execution_context &ctx, std::size_t stripes, int concurrency_hint)
+    : detail::service_member(ctx, concurrency_hint), stripes_(stripes, mtx_.enabled())
+{
+}
+
+struct striped_mutex_impl::lock_op_t final : detail::wait_op
+{
+  error_code                         &ec;
+  bool                                done = false;
+  detail::internal_condition_variable var;
+  lock_op_t(error_code &ec) : ec(ec) {}
+
+  void complete(error_code ec) override
+  {
+    done     = true;
+    this->ec = ec;
+    this->unlink();
+    var.notify_all();
+  }
+
+  void shutdown() override
+  {
+    done = true;
+    BOOST_SAM_ASSIGN_EC(this->ec, net::error::shut_down);
+    this->unlink();
+    var.notify_all();
+  }
+
+  void wait(lock_type &lock)
+  {
+    var.wait(lock, [this] { return done; });
+  }
+};
+
+void striped_mutex_impl::lock(std::size_t idx, error_code &ec)
+{
+  if (!this->mtx_.enabled())
+  {
+    if (try_lock(idx))
+      return;
+    BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+    return;
+  }
+
+  auto     &st = stripes_[idx];
+  lock_type lock{st.mtx};
+  if (try_acquire(st))
+    return;
+  lock_op_t op{ec};
+  add_waiter(st, &op);
+  op.wait(lock);
+}
+
+void striped_mutex_impl::unlock(std::size_t idx)
+{
+  auto     &st = stripes_[idx];
+  lock_type lock{st.mtx};
+  // ownership moves to the next waiter, so locked stays set.
+  if (st.waiters.next_ == &st.waiters)
+    st.locked = false;
+  else
+    static_cast<detail::wait_op *>(st.waiters.next_)->complete(error_code());
+}
+
+void striped_mutex_impl::shutdown()
+{
+  detail::basic_bilist_holder<void(error_code)> w;
+  for (std::size_t i = 0u; i < stripes_.size(); i++)
+  {
+    auto     &st = stripes_[i];
+    lock_type _{st.mtx};
+    while (st.waiters.next_ != &st.waiters)
+    {
+      auto op = st.waiters.next_;
+      op->unlink();
+      op->link_before(&w);
+    }
+  }
+  w.shutdown();
+}
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_STRIPED_MUTEX_IMPL_IPP
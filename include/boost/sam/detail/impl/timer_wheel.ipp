@@ -0,0 +1,144 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_IMPL_TIMER_WHEEL_IPP
+#define BOOST_SAM_DETAIL_IMPL_TIMER_WHEEL_IPP
+
+#include <boost/sam/detail/timer_wheel.hpp>
+
+#include <algorithm>
+
+BOOST_SAM_BEGIN_NAMESPACE
+namespace detail
+{
+
+timer_wheel::timer_wheel() : origin_(clock_type::now()) {}
+
+std::uint64_t timer_wheel::tick_of(clock_type::time_point tp) const
+{
+  if (tp <= origin_)
+    return 0u;
+
+  const auto diff = tp - origin_;
+  auto       ms   = std::chrono::duration_cast<std::chrono::milliseconds>(diff);
+  if (ms < diff)
+    ms += std::chrono::milliseconds(1);
+  return static_cast<std::uint64_t>(ms.count());
+}
+
+void timer_wheel::insert(timer_entry *entry)
+{
+  const auto tick  = (std::max)(entry->tick, current_);
+  const auto delta = tick - current_;
+
+  unsigned l = 0u;
+  while (l < levels && delta >= (std::uint64_t(1u) << (slot_bits * (l + 1u))))
+    l++;
+
+  if (l == levels)
+    entry->link_before(&overflow_);
+  else
+  {
+    entry->link_before(&wheel_[l][(tick >> (slot_bits * l)) & (slots - 1u)]);
+    counts_[l]++;
+  }
+  entry->level = l;
+  size_++;
+}
+
+void timer_wheel::remove(timer_entry *entry)
+{
+  BOOST_SAM_ASSERT(entry->level != unlinked);
+  entry->unlink();
+  if (entry->level < levels)
+    counts_[entry->level]--;
+  if (entry->level <= overflow)
+    size_--;
+  entry->level = unlinked;
+}
+
+void timer_wheel::cascade(bilist_node &slot)
+{
+  bilist_node tmp{std::move(slot)};
+  while (tmp.next_ != &tmp)
+  {
+    auto entry = static_cast<timer_entry *>(tmp.next_);
+    remove(entry);
+    insert(entry);
+  }
+}
+
+void timer_wheel::advance(clock_type::time_point now, bilist_node &expired)
+{
+  if (now < origin_)
+    return;
+  const auto to = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - origin_).count());
+
+  while (current_ <= to)
+  {
+    // crossing into a new slot of the first level, so pull down what's due in there from the levels above.
+    if ((current_ & (slots - 1u)) == 0u)
+    {
+      unsigned top = 1u;
+      while (top < levels && ((current_ >> (slot_bits * top)) & (slots - 1u)) == 0u)
+        top++;
+
+      if (top == levels)
+      {
+        cascade(overflow_);
+        top--;
+      }
+      for (unsigned l = top; l > 0u; l--)
+        cascade(wheel_[l][(current_ >> (slot_bits * l)) & (slots - 1u)]);
+    }
+
+    auto &slot = wheel_[0u][current_ & (slots - 1u)];
+    while (slot.next_ != &slot)
+    {
+      auto entry = static_cast<timer_entry *>(slot.next_);
+      remove(entry);
+      entry->link_before(&expired);
+      entry->level = due;
+    }
+
+    // skip ahead over empty levels, up to the next tick where something might cascade.
+    auto next = current_ + 1u;
+    for (unsigned l = 0u; l < levels && counts_[l] == 0u; l++)
+      next = ((current_ >> (slot_bits * (l + 1u))) + 1u) << (slot_bits * (l + 1u));
+
+    current_ = (std::min)(next, to + 1u);
+  }
+}
+
+bool timer_wheel::next_tick(std::uint64_t &tick) const
+{
+  if (size_ == 0u)
+    return false;
+
+  // the next cascade of the lowest occupied level above the first.
+  unsigned l = 1u;
+  while (l < levels && counts_[l] == 0u)
+    l++;
+
+  const auto mask = (std::uint64_t(1u) << (slot_bits * l)) - 1u;
+  tick            = (current_ + mask) & ~mask;
+
+  if (counts_[0u] > 0u)
+    for (std::uint64_t i = 0u; i < slots && current_ + i < tick; i++)
+    {
+      auto &slot = wheel_[0u][(current_ + i) & (slots - 1u)];
+      if (slot.next_ != &slot)
+      {
+        tick = current_ + i;
+        break;
+      }
+    }
+
+  return true;
+}
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_IMPL_TIMER_WHEEL_IPP
@@ -0,0 +1,264 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_KEYED_MUTEX_IMPL_HPP
+#define BOOST_SAM_DETAIL_KEYED_MUTEX_IMPL_HPP
+
+#include <boost/sam/detail/aligned_array.hpp>
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/service.hpp>
+#include <boost/sam/detail/thread_slots.hpp>
+
+#include <cstddef>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A waiter for a key. The key points into the entry it waits on, which lives at least as long as it's queued.
+template <typename Key>
+struct keyed_wait_op : wait_op
+{
+  const Key *key    = nullptr;
+  bool       shared = false;
+};
+
+// A shared mutex per key, created when a key gets locked & erased again once it's neither locked nor waited on.
+//
+// The entries are spread over shards with a mutex each, so unrelated keys rarely contend.
+// All shards share one registration with the op_list_service.
+template <typename Key, typename Hash, typename KeyEqual>
+struct keyed_mutex_impl : detail::service_member
+{
+  using wait_op_type = keyed_wait_op<Key>;
+
+  struct entry
+  {
+    bool                                          locked        = false;
+    std::size_t                                   locked_shared = 0u;
+    detail::basic_bilist_holder<void(error_code)> waiters;
+  };
+
+  struct alignas(64) shard
+  {
+    shard(bool enabled, const Hash &hash, const KeyEqual &eq) : mtx(enabled), entries(0u, hash, eq) {}
+
+    mutable mutex_type                             mtx;
+    std::unordered_map<Key, entry, Hash, KeyEqual> entries;
+  };
+
+  keyed_mutex_impl(net::execution_context &ctx, int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT,
+                   const Hash &hash = Hash(), const KeyEqual &eq = KeyEqual())
+      : detail::service_member(ctx, concurrency_hint), hash_(hash), shard_count_(slot_count(mtx_.enabled(), 4u)),
+        shards_(shard_count_, mtx_.enabled(), hash, eq)
+  {
+  }
+
+  shard &shard_of(const Key &key)
+  {
+    return shards_[shard_index(hash_(key), shard_count_)];
+  }
+
+  // Lock the key if it's free & nobody waits for it. Requires the shard's mutex to be held.
+  bool try_acquire(shard &sh, const Key &key, bool shared)
+  {
+    auto &e = sh.entries[key];
+    if (e.locked || e.waiters.next_ != &e.waiters || (!shared && e.locked_shared > 0u))
+      return false;
+    if (shared)
+      e.locked_shared++;
+    else
+      e.locked = true;
+    return true;
+  }
+
+  // Enqueue a waiter that failed to acquire. Requires the shard's mutex to be held.
+  void add_waiter(shard &sh, const Key &key, wait_op_type *waiter) noexcept
+  {
+    auto itr    = sh.entries.find(key);
+    waiter->key = &itr->first;
+    waiter->link_before(&itr->second.waiters);
+  }
+
+  // Dequeue a waiter & complete it with `ec`. Requires the shard's mutex to be held.
+  void cancel_waiter(shard &sh, wait_op_type *waiter, error_code ec)
+  {
+    auto itr = sh.entries.find(*waiter->key);
+    waiter->complete(ec);
+    // the waiters behind it might be able to get in now.
+    admit(sh, itr);
+  }
+
+  bool try_lock(const Key &key, bool shared)
+  {
+    auto     &sh = shard_of(key);
+    lock_type _{sh.mtx};
+    if (try_acquire(sh, key, shared))
+      return true;
+    auto itr = sh.entries.find(key);
+    if (is_idle(itr->second))
+      sh.entries.erase(itr);
+    return false;
+  }
+
+  void unlock(const Key &key, bool shared)
+  {
+    auto     &sh = shard_of(key);
+    lock_type _{sh.mtx};
+    auto      itr = sh.entries.find(key);
+    BOOST_SAM_ASSERT(itr != sh.entries.end());
+    if (shared)
+    {
+      BOOST_SAM_ASSERT(itr->second.locked_shared > 0u);
+      itr->second.locked_shared--;
+    }
+    else
+    {
+      BOOST_SAM_ASSERT(itr->second.locked);
+      itr->second.locked = false;
+    }
+    admit(sh, itr);
+  }
+
+  struct lock_op_t final : wait_op_type
+  {
+    error_code                         &ec;
+    bool                                done = false;
+    detail::internal_condition_variable var;
+    lock_op_t(error_code &ec) : ec(ec) {}
+
+    void complete(error_code ec) override
+    {
+      done     = true;
+      this->ec = ec;
+      this->unlink();
+      var.notify_all();
+    }
+
+    void shutdown() override
+    {
+      done = true;
+      BOOST_SAM_ASSIGN_EC(this->ec, net::error::shut_down);
+      this->unlink();
+      var.notify_all();
+    }
+
+    void wait(lock_type &lock)
+    {
+      var.wait(lock, [this] { return done; });
+    }
+  };
+
+  void lock(const Key &key, bool shared, error_code &ec)
+  {
+    if (!this->mtx_.enabled())
+    {
+      if (try_lock(key, shared))
+        return;
+      BOOST_SAM_ASSIGN_EC(ec, asio::error::in_progress);
+      return;
+    }
+
+    auto     &sh = shard_of(key);
+    lock_type lock{sh.mtx};
+    if (try_acquire(sh, key, shared))
+      return;
+    lock_op_t op{ec};
+    op.shared = shared;
+    add_waiter(sh, key, &op);
+    op.wait(lock);
+  }
+
+  // The number of keys that are locked or waited on.
+  std::size_t size() const
+  {
+    std::size_t sz = 0u;
+    for (auto &sh : shards_)
+    {
+      lock_type _{sh.mtx};
+      sz += sh.entries.size();
+    }
+    return sz;
+  }
+
+  void shutdown() override
+  {
+    detail::basic_bilist_holder<void(error_code)> w;
+    for (auto &sh : shards_)
+    {
+      lock_type _{sh.mtx};
+      for (auto &e : sh.entries)
+        while (e.second.waiters.next_ != &e.second.waiters)
+        {
+          auto op = e.second.waiters.next_;
+          op->unlink();
+          op->link_before(&w);
+        }
+    }
+    w.shutdown();
+  }
+
+  keyed_mutex_impl()                         = delete;
+  keyed_mutex_impl(const keyed_mutex_impl &) = delete;
+  keyed_mutex_impl(keyed_mutex_impl &&mi)
+      : detail::service_member(std::move(mi)), hash_(std::move(mi.hash_)), shard_count_(mi.shard_count_),
+        shards_(std::move(mi.shards_))
+  {
+  }
+
+  keyed_mutex_impl &operator=(const keyed_mutex_impl &lhs) = delete;
+  keyed_mutex_impl &operator=(keyed_mutex_impl &&lhs) noexcept
+  {
+    detail::service_member::operator=(std::move(lhs));
+    hash_        = std::move(lhs.hash_);
+    shard_count_ = lhs.shard_count_;
+    shards_      = std::move(lhs.shards_);
+    return *this;
+  }
+
+private:
+  static bool is_idle(const entry &e) noexcept { return !e.locked && e.locked_shared == 0u && e.waiters.next_ == &e.waiters; }
+
+  // Hand the key to the waiters at the front that can get in, or erase the entry if it's idle.
+  void admit(shard &sh, typename std::unordered_map<Key, entry, Hash, KeyEqual>::iterator itr)
+  {
+    auto &e = itr->second;
+    while (e.waiters.next_ != &e.waiters)
+    {
+      auto w = static_cast<wait_op_type *>(e.waiters.next_);
+      if (w->shared)
+      {
+        if (e.locked)
+          break;
+        e.locked_shared++;
+        w->complete(error_code());
+      }
+      else
+      {
+        if (e.locked || e.locked_shared > 0u)
+          break;
+        e.locked = true;
+        w->complete(error_code());
+        break;
+      }
+    }
+    if (is_idle(e))
+      sh.entries.erase(itr);
+  }
+
+  Hash                 hash_;
+  std::size_t          shard_count_;
+  aligned_array<shard> shards_;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_KEYED_MUTEX_IMPL_HPP
@@ -0,0 +1,234 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_KEYED_RATE_LIMITER_IMPL_HPP
+#define BOOST_SAM_DETAIL_KEYED_RATE_LIMITER_IMPL_HPP
+
+#include <boost/sam/detail/aligned_array.hpp>
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/service.hpp>
+#include <boost/sam/detail/thread_slots.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A waiter parked until the time its request conforms. It sits in the timer wheel through a member,
+// which completes it successfully when it expires.
+struct parked_wait_op : wait_op
+{
+  struct entry final : timer_entry
+  {
+    explicit entry(parked_wait_op *op) : op(op) {}
+    void expire() override { op->complete(error_code()); }
+
+    parked_wait_op *op;
+  };
+
+  parked_wait_op() : timer(this) {}
+  parked_wait_op(const parked_wait_op &) = delete;
+
+  entry timer;
+};
+
+// The generic cell rate algorithm per key: every key only stores its theoretical arrival time (TAT),
+// i.e. when it would have used up all of its burst. A request at `now` conforms once TAT - now <= tolerance,
+// and pushes the TAT out by one emission interval.
+//
+// Keys are spread over shards with a mutex each. A key whose TAT passed is equivalent to a fresh one,
+// so every call also sweeps a few entries of its shard & erases those.
+// Parked waiters don't need their key anymore, they only wait in the timer wheel, guarded by mtx_.
+template <typename Key, typename Hash, typename KeyEqual>
+struct keyed_rate_limiter_impl : detail::service_member
+{
+  using clock_type = std::chrono::steady_clock;
+  using map_type   = std::unordered_map<Key, clock_type::time_point, Hash, KeyEqual>;
+
+  // the entries looked at by every call, so idle keys get erased while the table's used.
+  constexpr static std::size_t sweep_step = 2u;
+
+  struct alignas(64) shard
+  {
+    shard(bool enabled, const Hash &hash, const KeyEqual &eq) : mtx(enabled), entries(0u, hash, eq) {}
+
+    mutable mutex_type          mtx;
+    map_type                    entries;
+    typename map_type::iterator cursor = entries.end();
+  };
+
+  keyed_rate_limiter_impl(net::execution_context &ctx, int rate, clock_type::duration interval, int burst,
+                          int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT, const Hash &hash = Hash(),
+                          const KeyEqual &eq = KeyEqual())
+      : detail::service_member(ctx, concurrency_hint), emission_(interval / rate),
+        tolerance_(emission_ * (burst - 1)), hash_(hash), shard_count_(slot_count(mtx_.enabled(), 4u)),
+        shards_(shard_count_, mtx_.enabled(), hash, eq)
+  {
+    BOOST_SAM_ASSERT(rate > 0);
+    BOOST_SAM_ASSERT(burst > 0);
+  }
+
+  // Admit the request if it conforms.
+  bool try_acquire(const Key &key)
+  {
+    const auto now = clock_type::now();
+    auto      &sh  = shard_of(key);
+    lock_type  _{sh.mtx};
+    sweep(sh, now);
+    auto      &tat = lookup(sh, key);
+    const auto t   = (std::max)(tat, now);
+    if (t - now > tolerance_)
+      return false;
+    tat = t + emission_;
+    return true;
+  }
+
+  // Reserve the next conforming slot for the key, returns when it's due.
+  clock_type::time_point reserve(const Key &key)
+  {
+    const auto now = clock_type::now();
+    auto      &sh  = shard_of(key);
+    lock_type  _{sh.mtx};
+    sweep(sh, now);
+    auto      &tat = lookup(sh, key);
+    const auto t   = (std::max)(tat, now);
+    tat            = t + emission_;
+    return t - tolerance_;
+  }
+
+  // Park a waiter until its time. Requires mtx_ to be held.
+  void add_waiter(parked_wait_op *waiter, clock_type::time_point due, const net::any_io_executor &exec)
+  {
+    waiter->link_before(&parked_);
+    service->add_timer(&waiter->timer, this, due, exec);
+  }
+
+  // Requires mtx_ to be held.
+  void cancel_waiter(parked_wait_op *waiter, error_code ec)
+  {
+    if (waiter->timer.armed)
+      waiter->timer.service->remove_timer(&waiter->timer);
+    waiter->complete(ec);
+  }
+
+  // The number of keys currently tracked.
+  std::size_t size() const
+  {
+    std::size_t sz = 0u;
+    for (auto &sh : shards_)
+    {
+      lock_type _{sh.mtx};
+      sz += sh.entries.size();
+    }
+    return sz;
+  }
+
+  void shutdown() override
+  {
+    lock_type l{mtx_};
+    disarm_all();
+    auto w = std::move(parked_);
+    l.unlock();
+    w.shutdown();
+  }
+
+  keyed_rate_limiter_impl()                                = delete;
+  keyed_rate_limiter_impl(const keyed_rate_limiter_impl &) = delete;
+  keyed_rate_limiter_impl(keyed_rate_limiter_impl &&mi)
+      : detail::service_member(std::move(mi)), emission_(mi.emission_), tolerance_(mi.tolerance_),
+        hash_(std::move(mi.hash_)), shard_count_(mi.shard_count_), shards_(std::move(mi.shards_))
+  {
+    // the parked waiters are owned by the old timers, so they get cancelled.
+    lock_type _{mi.mtx_};
+    mi.disarm_all();
+    mi.parked_.complete_all(net::error::operation_aborted);
+  }
+
+  keyed_rate_limiter_impl &operator=(const keyed_rate_limiter_impl &lhs) = delete;
+  keyed_rate_limiter_impl &operator=(keyed_rate_limiter_impl &&lhs) noexcept
+  {
+    {
+      lock_type _{lhs.mtx_};
+      lhs.disarm_all();
+      lhs.parked_.complete_all(net::error::operation_aborted);
+    }
+    detail::service_member::operator=(std::move(lhs));
+    emission_    = lhs.emission_;
+    tolerance_   = lhs.tolerance_;
+    hash_        = std::move(lhs.hash_);
+    shard_count_ = lhs.shard_count_;
+    shards_      = std::move(lhs.shards_);
+    return *this;
+  }
+
+  ~keyed_rate_limiter_impl()
+  {
+    lock_type _{mtx_};
+    disarm_all();
+  }
+
+private:
+  shard &shard_of(const Key &key)
+  {
+    return shards_[shard_index(hash_(key), shard_count_)];
+  }
+
+  clock_type::time_point &lookup(shard &sh, const Key &key)
+  {
+    const auto buckets = sh.entries.bucket_count();
+    auto      &tat     = sh.entries[key];
+    // a rehash invalidates the cursor.
+    if (sh.entries.bucket_count() != buckets)
+      sh.cursor = sh.entries.end();
+    return tat;
+  }
+
+  // Erase a few keys whose TAT passed.
+  void sweep(shard &sh, clock_type::time_point now)
+  {
+    for (std::size_t i = 0u; i < sweep_step && !sh.entries.empty(); i++)
+    {
+      if (sh.cursor == sh.entries.end())
+        sh.cursor = sh.entries.begin();
+      if (sh.cursor->second <= now)
+        sh.cursor = sh.entries.erase(sh.cursor);
+      else
+        ++sh.cursor;
+    }
+  }
+
+  void disarm_all()
+  {
+    for (auto itr = parked_.next_; itr != &parked_; itr = itr->next_)
+    {
+      auto &t = static_cast<parked_wait_op *>(itr)->timer;
+      if (t.armed)
+        t.service->remove_timer(&t);
+    }
+  }
+
+  clock_type::duration                          emission_, tolerance_;
+  Hash                                          hash_;
+  std::size_t                                   shard_count_;
+  aligned_array<shard>                          shards_;
+  detail::basic_bilist_holder<void(error_code)> parked_;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_KEYED_RATE_LIMITER_IMPL_HPP
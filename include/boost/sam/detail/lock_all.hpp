@@ -0,0 +1,244 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_LOCK_ALL_HPP
+#define BOOST_SAM_DETAIL_LOCK_ALL_HPP
+
+#include <boost/sam/detail/config.hpp>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/cancellation_type.hpp>
+#else
+#include <boost/asio/cancellation_type.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+template <typename>
+struct basic_semaphore;
+template <typename>
+struct basic_mutex;
+template <typename>
+struct basic_shared_mutex;
+
+namespace detail
+{
+
+// the lockable interface used by async_lock_all.
+template <typename Executor>
+bool try_lock_one(basic_mutex<Executor> &mtx)
+{
+  return mtx.try_lock();
+}
+
+template <typename Executor>
+void unlock_one(basic_mutex<Executor> &mtx)
+{
+  mtx.unlock();
+}
+
+template <typename Executor, typename Handler>
+void async_lock_one(basic_mutex<Executor> &mtx, Handler &&handler)
+{
+  mtx.async_lock(std::forward<Handler>(handler));
+}
+
+template <typename Executor>
+bool try_lock_one(basic_shared_mutex<Executor> &mtx)
+{
+  return mtx.try_lock();
+}
+
+template <typename Executor>
+void unlock_one(basic_shared_mutex<Executor> &mtx)
+{
+  mtx.unlock();
+}
+
+template <typename Executor, typename Handler>
+void async_lock_one(basic_shared_mutex<Executor> &mtx, Handler &&handler)
+{
+  mtx.async_lock(std::forward<Handler>(handler));
+}
+
+template <typename Executor>
+bool try_lock_one(basic_semaphore<Executor> &sem)
+{
+  return sem.try_acquire();
+}
+
+template <typename Executor>
+void unlock_one(basic_semaphore<Executor> &sem)
+{
+  sem.release();
+}
+
+template <typename Executor, typename Handler>
+void async_lock_one(basic_semaphore<Executor> &sem, Handler &&handler)
+{
+  sem.async_acquire(std::forward<Handler>(handler));
+}
+
+struct try_lock_one_t
+{
+  template <typename Lockable>
+  bool operator()(Lockable *lockable) const
+  {
+    return try_lock_one(*lockable);
+  }
+};
+
+struct unlock_one_t
+{
+  template <typename Lockable>
+  bool operator()(Lockable *lockable) const
+  {
+    unlock_one(*lockable);
+    return true;
+  }
+};
+
+template <typename Handler>
+struct async_lock_one_t
+{
+  Handler handler;
+
+  template <typename Lockable>
+  bool operator()(Lockable *lockable)
+  {
+    async_lock_one(*lockable, std::move(handler));
+    return true;
+  }
+};
+
+// invoke func on the idx-th element of a tuple of lockable pointers.
+template <std::size_t I, typename Tuple, typename Func>
+bool visit_lockable_impl(Tuple &tup, std::size_t idx, Func &func, std::false_type /* last */)
+{
+  BOOST_SAM_ASSERT(idx == I);
+  ignore_unused(idx);
+  return func(std::get<I>(tup));
+}
+
+template <std::size_t I, typename Tuple, typename Func>
+bool visit_lockable_impl(Tuple &tup, std::size_t idx, Func &func, std::true_type)
+{
+  if (idx == I)
+    return func(std::get<I>(tup));
+  return visit_lockable_impl<I + 1u>(tup, idx, func,
+                                     std::integral_constant<bool, (I + 2u < std::tuple_size<Tuple>::value)>{});
+}
+
+template <typename Tuple, typename Func>
+bool visit_lockable(Tuple &tup, std::size_t idx, Func &&func)
+{
+  return visit_lockable_impl<0u>(tup, idx, func, std::integral_constant<bool, (1u < std::tuple_size<Tuple>::value)>{});
+}
+
+// Guard is void if the op doesn't produce a guard.
+template <typename Guard, typename... Lockables>
+struct lock_all_op
+{
+  constexpr static std::size_t size = sizeof...(Lockables);
+
+  std::tuple<Lockables *...>    lockables;
+  std::array<std::size_t, size> order;
+  // the lockable we wait for, i.e. the only one held when resuming.
+  std::size_t blocker = size;
+
+  explicit lock_all_op(Lockables &...ls) : lockables(&ls...)
+  {
+    const void *addresses[size] = {static_cast<const void *>(&ls)...};
+    for (std::size_t i = 0u; i < size; i++)
+      order[i] = i;
+
+    std::sort(order.begin(), order.end(),
+              [&](std::size_t lhs, std::size_t rhs) { return std::less<const void *>()(addresses[lhs], addresses[rhs]); });
+  }
+
+  // lock everything but the blocker in order. If that fails, release everything & record the new blocker.
+  bool try_lock_rest()
+  {
+    for (std::size_t i = 0u; i < size; i++)
+    {
+      const auto idx = order[i];
+      if (idx == blocker || visit_lockable(lockables, idx, try_lock_one_t{}))
+        continue;
+
+      // back off, so we never wait while holding anything.
+      for (std::size_t j = 0u; j < i; j++)
+        if (order[j] != blocker)
+          visit_lockable(lockables, order[j], unlock_one_t{});
+      if (blocker != size)
+        visit_lockable(lockables, blocker, unlock_one_t{});
+      blocker = idx;
+      return false;
+    }
+    return true;
+  }
+
+  template <typename Self>
+  void wait_for_blocker(Self &&self)
+  {
+    using self_type = typename std::decay<Self>::type;
+    auto idx        = blocker;
+    visit_lockable(lockables, idx, async_lock_one_t<self_type>{std::move(self)});
+  }
+
+  template <typename Self>
+  void complete(Self &self, error_code ec, std::true_type /* no guard */)
+  {
+    self.complete(ec);
+  }
+
+  template <typename Self>
+  void complete(Self &self, error_code ec, std::false_type)
+  {
+    if (ec)
+      self.complete(ec, Guard{});
+    else
+      self.complete(ec, Guard{lockables, std::adopt_lock});
+  }
+
+  template <typename Self>
+  void operator()(Self &&self) // init
+  {
+    if (self.get_cancellation_state().cancelled() != net::cancellation_type::none)
+      complete(self, net::error::operation_aborted, std::is_void<Guard>{});
+    else if (try_lock_rest())
+      complete(self, error_code(), std::is_void<Guard>{});
+    else
+      wait_for_blocker(std::move(self));
+  }
+
+  template <typename Self>
+  void operator()(Self &&self, error_code ec) // blocker acquired
+  {
+    if (!ec && self.get_cancellation_state().cancelled() != net::cancellation_type::none)
+    {
+      visit_lockable(lockables, blocker, unlock_one_t{});
+      ec = net::error::operation_aborted;
+    }
+
+    if (ec)
+      complete(self, ec, std::is_void<Guard>{});
+    else if (try_lock_rest())
+      complete(self, ec, std::is_void<Guard>{});
+    else
+      wait_for_blocker(std::move(self));
+  }
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_LOCK_ALL_HPP
@@ -0,0 +1,133 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_LOCK_HIERARCHY_IMPL_HPP
+#define BOOST_SAM_DETAIL_LOCK_HIERARCHY_IMPL_HPP
+
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/service.hpp>
+
+#include <cstddef>
+#include <deque>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/// The modes a node of a lock_hierarchy can be locked in.
+enum class lock_mode
+{
+  /// Intends to lock descendants shared.
+  intention_shared,
+  /// Intends to lock descendants exclusively.
+  intention_exclusive,
+  /// Reads the node & all its descendants.
+  shared,
+  /// Reads the node & all its descendants, and intends to lock some of them exclusively.
+  shared_intention_exclusive,
+  /// Writes the node & all its descendants.
+  exclusive
+};
+
+namespace detail
+{
+
+// A waiter for a node to be locked in a mode.
+struct hierarchy_wait_op : wait_op
+{
+  std::size_t node   = 0u;
+  lock_mode   mode   = lock_mode::exclusive;
+  // the ancestor the intention locks stop at.
+  std::size_t within = static_cast<std::size_t>(-1);
+  // the node it's queued at, i.e. the topmost one that it's blocked by.
+  std::size_t queued_at = 0u;
+};
+
+// Multi granularity locking. Locking a node also locks all its ancestors in the matching intention mode,
+// up to the root or to an ancestor the caller holds already.
+//
+// A waiter queues at the topmost node it conflicts with, either with the modes held there or with waiters that queued
+// there before it. Whenever a node is unlocked, its queue gets checked in order: waiters that can get in are granted,
+// the ones blocked further up move to that node's queue.
+struct lock_hierarchy_impl : detail::service_member
+{
+  constexpr static std::size_t modes = 5u;
+  // take intention locks up to the root.
+  constexpr static std::size_t no_ancestor = static_cast<std::size_t>(-1);
+
+  struct node_type
+  {
+    explicit node_type(std::size_t parent) : parent(parent) {}
+
+    std::size_t                                   parent;
+    std::size_t                                   held[modes]   = {};
+    std::size_t                                   queued[modes] = {};
+    detail::basic_bilist_holder<void(error_code)> waiters;
+  };
+
+  BOOST_SAM_DECL lock_hierarchy_impl(net::execution_context &ctx,
+                                     int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT);
+
+  // Add a child to `parent`, returning its index. The root has index 0 & is its own parent.
+  BOOST_SAM_DECL std::size_t add_node(std::size_t parent);
+  std::size_t                size() const
+  {
+    lock_type _{mtx_};
+    return nodes_.size();
+  }
+
+  BOOST_SAM_DECL void lock(std::size_t node, lock_mode mode, std::size_t within, error_code &ec);
+  BOOST_SAM_DECL bool try_lock(std::size_t node, lock_mode mode, std::size_t within);
+  BOOST_SAM_DECL void unlock(std::size_t node, lock_mode mode, std::size_t within);
+
+  // Lock the node if nothing conflicts, neither held locks nor earlier waiters. Requires mtx_ to be held.
+  BOOST_SAM_DECL bool try_acquire(std::size_t node, lock_mode mode, std::size_t within) noexcept;
+  // Enqueue a waiter that failed to acquire. Requires mtx_ to be held.
+  BOOST_SAM_DECL void add_waiter(detail::hierarchy_wait_op *waiter) noexcept;
+  // Dequeue a waiter & complete it with `ec`. Requires mtx_ to be held.
+  BOOST_SAM_DECL void cancel_waiter(detail::hierarchy_wait_op *waiter, error_code ec) noexcept;
+
+  BOOST_SAM_DECL void shutdown() override;
+
+  std::deque<node_type> nodes_;
+
+  lock_hierarchy_impl()                            = delete;
+  lock_hierarchy_impl(const lock_hierarchy_impl &) = delete;
+  lock_hierarchy_impl(lock_hierarchy_impl &&mi) : detail::service_member(std::move(mi)), nodes_(std::move(mi.nodes_))
+  {
+  }
+
+  lock_hierarchy_impl &operator=(const lock_hierarchy_impl &lhs) = delete;
+  lock_hierarchy_impl &operator=(lock_hierarchy_impl &&lhs) noexcept
+  {
+    detail::service_member::operator=(std::move(lhs));
+    lock_type _{lhs.mtx_};
+    nodes_ = std::move(lhs.nodes_);
+    return *this;
+  }
+
+  BOOST_SAM_DECL ~lock_hierarchy_impl();
+
+  struct lock_op_t;
+
+private:
+  // The topmost node that locking `node` in `mode` is blocked by, or `nodes_.size()` if it can lock right away.
+  // `skipped` are the modes of the waiters that are still queued at `queued_at`, ahead of the one checked.
+  BOOST_SAM_DECL std::size_t blocked_at(std::size_t node, lock_mode mode, std::size_t within, std::size_t queued_at,
+                                        unsigned skipped) const noexcept;
+  BOOST_SAM_DECL void        acquire(std::size_t node, lock_mode mode, std::size_t within) noexcept;
+  BOOST_SAM_DECL void        enqueue(detail::hierarchy_wait_op *waiter, std::size_t at) noexcept;
+  BOOST_SAM_DECL void        dequeue(detail::hierarchy_wait_op *waiter) noexcept;
+  // Check the waiters queued at `node`, in order.
+  BOOST_SAM_DECL void        process(std::size_t node) noexcept;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/lock_hierarchy_impl.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_LOCK_HIERARCHY_IMPL_HPP
@@ -7,9 +7,11 @@
 
 #include <boost/sam/detail/basic_op_model.hpp>
 #include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/priority_bilist_holder.hpp>
 #include <boost/sam/detail/service.hpp>
 
 #include <mutex>
+#include <utility>
 
 BOOST_SAM_BEGIN_NAMESPACE
 
@@ -32,7 +34,16 @@ struct mutex_impl : detail::service_member
       return locked_ = true;
   }
 
-  BOOST_SAM_DECL void add_waiter(detail::wait_op *waiter) noexcept;
+  BOOST_SAM_DECL void add_waiter(detail::wait_op *waiter, std::size_t priority = 0u) noexcept;
+
+  void set_aging(std::size_t wakeups)
+  {
+    lock_type _{mtx_};
+    waiters_.set_aging(wakeups);
+  }
+
+  // Hand the lock to the next waiter and enqueue `waiter` behind the others. Requires mtx_ to be held.
+  virtual BOOST_SAM_DECL void yield(detail::wait_op *waiter) noexcept;
 
   void shutdown() override
   {
@@ -44,7 +55,7 @@ struct mutex_impl : detail::service_member
 
   bool locked_;
 
-  detail::basic_bilist_holder<void(error_code)> waiters_;
+  detail::priority_bilist_holder<void(error_code)> waiters_;
 
   mutex_impl()                   = delete;
   mutex_impl(const mutex_impl &) = delete;
@@ -52,18 +63,35 @@ struct mutex_impl : detail::service_member
       : detail::service_member(std::move(mi)), locked_(mi.locked_), waiters_(std::move(mi.waiters_))
   {
     mi.locked_ = false;
+    lock_type _{mi.mtx_};
+    adopt_waiters();
   }
 
   mutex_impl &operator=(const mutex_impl &lhs) = delete;
   mutex_impl &operator=(mutex_impl &&lhs) noexcept
   {
-    lock_type _{lhs.mtx_};
+    lock_type _{mtx_};
+    lock_type l{lhs.mtx_};
     locked_      = lhs.locked_;
     lhs.locked_  = false;
-    lhs.waiters_ = std::move(waiters_);
+    std::swap(waiters_, lhs.waiters_);
+    adopt_waiters();
+    lhs.adopt_waiters();
     return *this;
   }
 
+  // Make the timed waiters expire here, after they got moved here.
+  // Requires the mutex of the mutex_impl they came from to be held.
+  void adopt_waiters()
+  {
+    waiters_.visit(
+        [this](wait_op *op)
+        {
+          adopt_timer(op);
+          return true;
+        });
+  }
+
   BOOST_SAM_DECL ~mutex_impl();
 
   struct lock_op_t;
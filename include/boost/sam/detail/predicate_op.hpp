@@ -17,6 +17,9 @@ BOOST_SAM_BEGIN_NAMESPACE
 
 namespace detail
 {
+struct service_member;
+struct timer_entry;
+
 template <typename Signature>
 struct predicate_op;
 
@@ -26,6 +29,11 @@ struct predicate_op<void(Ts...)> : detail::bilist_node
   virtual void shutdown()      = 0;
   virtual void complete(Ts...) = 0;
   virtual bool done()          = 0;
+
+  // Called by timed_op, like basic_op::on_expire.
+  void on_expire(service_member *) {}
+  // Like basic_op::timer.
+  virtual timer_entry *timer() noexcept { return nullptr; }
 };
 
 using predicate_wait_op = predicate_op<void(error_code)>;
@@ -26,12 +26,12 @@ BOOST_SAM_BEGIN_NAMESPACE
 
 namespace detail
 {
-template <class Executor, class Predicate, class Handler, class Signature>
+// Base can be used to attach extra state to the op, it needs to derive from predicate_op<Signature>.
+template <class Executor, class Handler, class Predicate, class Signature, class Base = predicate_op<Signature>>
 struct predicate_op_model;
 
-template <class Executor, class Handler, class Predicate, class... Ts>
-struct predicate_op_model<Executor, Handler, Predicate, void(error_code, Ts...)> final
-    : predicate_op<void(error_code, Ts...)>
+template <class Executor, class Handler, class Predicate, class Base, class... Ts>
+struct predicate_op_model<Executor, Handler, Predicate, void(error_code, Ts...), Base> final : Base
 {
   using executor_type          = Executor;
   using cancellation_slot_type = net::associated_cancellation_slot_t<Handler>;
@@ -0,0 +1,147 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_PRIORITY_BILIST_HOLDER_HPP
+#define BOOST_SAM_DETAIL_PRIORITY_BILIST_HOLDER_HPP
+
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+
+#include <cstddef>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+template <typename Signature>
+struct priority_bilist_holder;
+
+// A set of FIFO lanes, one per priority, with a bitmap of the lanes that might have waiters.
+// Ops unlink themselves when completed or cancelled, so a set bit might be stale & gets cleared lazily.
+template <typename... Ts>
+struct priority_bilist_holder<void(error_code, Ts...)>
+{
+  using op_type = basic_op<void(error_code, Ts...)>;
+
+  constexpr static std::size_t lanes = 8u;
+
+  bool empty() const noexcept { return highest_lane() == lanes; }
+
+  // The first op of the highest priority lane, or nullptr.
+  op_type *front() const noexcept
+  {
+    const auto l = highest_lane();
+    if (l == lanes)
+      return nullptr;
+    return static_cast<op_type *>(lanes_[l].next_);
+  }
+
+  void push(op_type *op, std::size_t priority = 0u) noexcept
+  {
+    if (priority >= lanes)
+      priority = lanes - 1u;
+    op->link_before(&lanes_[priority]);
+    mask_ |= 1u << priority;
+  }
+
+  std::size_t size() const
+  {
+    std::size_t sz = 0u;
+    for (auto &l : lanes_)
+      sz += l.size();
+    return sz;
+  }
+
+  // Visit the ops from the highest lane down, in FIFO order within a lane, until `f` returns false.
+  // `f` may complete the op it's passed, but must not touch any other.
+  template <typename Func>
+  void visit(Func f) const
+  {
+    const auto top = highest_lane();
+    for (std::size_t l = top + 1u; top != lanes && l-- > 0u;)
+    {
+      auto &lane = lanes_[l];
+      for (auto itr = lane.next_; itr != &lane;)
+      {
+        auto op = static_cast<op_type *>(itr);
+        itr     = itr->next_;
+        if (!f(op))
+          return;
+      }
+    }
+  }
+
+  void complete_all(error_code ec, Ts... ts)
+  {
+    for (std::size_t l = lanes; l-- > 0u;)
+      lanes_[l].complete_all(ec, ts...);
+    mask_ = 0u;
+  }
+
+  void shutdown()
+  {
+    for (std::size_t l = lanes; l-- > 0u;)
+      lanes_[l].shutdown();
+    mask_ = 0u;
+  }
+
+  // Every `wakeups` wake-ups, every lane below the highest waiting one passes its first op up by one priority.
+  // 0 disables aging.
+  void set_aging(std::size_t wakeups) noexcept
+  {
+    aging_   = wakeups;
+    wakeups_ = 0u;
+  }
+
+  // To be called once per op woken up.
+  void on_wakeup() noexcept
+  {
+    if (aging_ == 0u || ++wakeups_ < aging_)
+      return;
+    wakeups_ = 0u;
+
+    // top down, so nothing moves up more than one lane
+    for (std::size_t l = highest_lane(); l-- > 0u;)
+    {
+      auto &lane = lanes_[l];
+      if ((mask_ & (1u << l)) == 0u || lane.next_ == &lane)
+        continue;
+
+      auto op = lane.next_;
+      op->unlink();
+      op->link_before(&lanes_[l + 1u]);
+      mask_ |= 1u << (l + 1u);
+    }
+  }
+
+  priority_bilist_holder() noexcept                                 = default;
+  priority_bilist_holder(priority_bilist_holder &&)                 = default;
+  priority_bilist_holder(priority_bilist_holder const &)            = delete;
+  priority_bilist_holder &operator=(priority_bilist_holder &&)      = default;
+  priority_bilist_holder &operator=(priority_bilist_holder const &) = delete;
+
+private:
+  std::size_t highest_lane() const noexcept
+  {
+    for (std::size_t l = lanes; mask_ != 0u && l-- > 0u;)
+    {
+      if ((mask_ & (1u << l)) == 0u)
+        continue;
+      if (lanes_[l].next_ != &lanes_[l])
+        return l;
+      mask_ &= ~(1u << l);
+    }
+    return lanes;
+  }
+
+  basic_bilist_holder<void(error_code, Ts...)> lanes_[lanes];
+  mutable unsigned                             mask_ = 0u;
+  std::size_t                                  aging_ = 0u, wakeups_ = 0u;
+};
+
+} // namespace detail
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_PRIORITY_BILIST_HOLDER_HPP
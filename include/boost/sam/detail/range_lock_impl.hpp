@@ -0,0 +1,138 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_RANGE_LOCK_IMPL_HPP
+#define BOOST_SAM_DETAIL_RANGE_LOCK_IMPL_HPP
+
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/service.hpp>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A waiter for the range [begin, end) to be locked.
+struct range_wait_op : wait_op
+{
+  std::uint64_t begin  = 0u;
+  std::uint64_t end    = 0u;
+  bool          shared = false;
+};
+
+// A waiter with a deadline, which tells its range_lock_impl which range it leaves when it expires.
+struct range_timed_wait_op : range_wait_op
+{
+  BOOST_SAM_DECL void on_expire(service_member *owner);
+};
+
+// Locks on half open ranges, shared or exclusive.
+//
+// The held ranges are ordered by their start. Since no held range is longer than the longest one,
+// the ones overlapping a request can only start in [begin - longest, end), which bounds the lookup.
+// Waiters queue in order & only get checked again when a range overlapping theirs gets released,
+// or a waiter ahead of them leaves.
+struct range_lock_impl : detail::service_member
+{
+  BOOST_SAM_DECL range_lock_impl(net::execution_context &ctx,
+                                 int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT);
+
+  BOOST_SAM_DECL void lock(std::uint64_t begin, std::uint64_t end, bool shared, error_code &ec);
+  BOOST_SAM_DECL bool try_lock(std::uint64_t begin, std::uint64_t end, bool shared);
+  BOOST_SAM_DECL void unlock(std::uint64_t begin, std::uint64_t end, bool shared);
+
+  // Lock the range if it neither overlaps a conflicting held range nor a conflicting waiter.
+  // Requires mtx_ to be held.
+  BOOST_SAM_DECL bool try_acquire(std::uint64_t begin, std::uint64_t end, bool shared);
+  // Requires mtx_ to be held.
+  BOOST_SAM_DECL void add_waiter(detail::range_wait_op *waiter) noexcept;
+  // Check the waiters overlapping [begin, end) again, e.g. after one of them left. Requires mtx_ to be held.
+  BOOST_SAM_DECL void process(std::uint64_t begin, std::uint64_t end);
+
+  // Remember the range of a waiter that timed out, for on_timeout. Requires mtx_ to be held.
+  void expire_waiter(const detail::range_wait_op *waiter) noexcept
+  {
+    expired_begin_ = waiter->begin;
+    expired_end_   = waiter->end;
+  }
+
+  // the expired waiter might have blocked the ones overlapping it.
+  void on_timeout() override
+  {
+    process(expired_begin_, expired_end_);
+    expired_begin_ = expired_end_ = 0u;
+  }
+
+  void shutdown() override
+  {
+    lock_type l{mtx_};
+    auto w = std::move(waiters_);
+    l.unlock();
+    w.shutdown();
+  }
+
+  struct held_range
+  {
+    std::uint64_t end;
+    bool          shared;
+  };
+
+  std::multimap<std::uint64_t, held_range>      held_;
+  // the lengths of the held ranges.
+  std::multiset<std::uint64_t>                  lengths_;
+  detail::basic_bilist_holder<void(error_code)> waiters_;
+  // the range of the waiter that just timed out, on_timeout follows every expiry.
+  std::uint64_t                                 expired_begin_ = 0u, expired_end_ = 0u;
+
+  range_lock_impl()                        = delete;
+  range_lock_impl(const range_lock_impl &) = delete;
+  range_lock_impl(range_lock_impl &&mi)
+      : detail::service_member(std::move(mi)), held_(std::move(mi.held_)), lengths_(std::move(mi.lengths_)),
+        waiters_(std::move(mi.waiters_))
+  {
+    lock_type _{mi.mtx_};
+    adopt_timers<wait_op>(waiters_);
+  }
+
+  range_lock_impl &operator=(const range_lock_impl &lhs) = delete;
+  range_lock_impl &operator=(range_lock_impl &&lhs) noexcept
+  {
+    detail::service_member::operator=(std::move(lhs));
+    lock_type _{mtx_};
+    lock_type l{lhs.mtx_};
+    held_    = std::move(lhs.held_);
+    lengths_ = std::move(lhs.lengths_);
+    std::swap(waiters_, lhs.waiters_);
+    adopt_timers<wait_op>(waiters_);
+    lhs.adopt_timers<wait_op>(lhs.waiters_);
+    return *this;
+  }
+
+  BOOST_SAM_DECL ~range_lock_impl();
+
+  struct lock_op_t;
+
+private:
+  BOOST_SAM_DECL bool conflicts_held(std::uint64_t begin, std::uint64_t end, bool shared) const;
+  // Whether a waiter in [first, last) conflicts.
+  BOOST_SAM_DECL bool conflicts_waiting(const bilist_node *first, const bilist_node *last, std::uint64_t begin,
+                                        std::uint64_t end, bool shared) const noexcept;
+  BOOST_SAM_DECL void acquire(std::uint64_t begin, std::uint64_t end, bool shared);
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/range_lock_impl.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_RANGE_LOCK_IMPL_HPP
@@ -0,0 +1,102 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_RATE_LIMITER_IMPL_HPP
+#define BOOST_SAM_DETAIL_RATE_LIMITER_IMPL_HPP
+
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/semaphore_impl.hpp>
+#include <boost/sam/detail/service.hpp>
+
+#include <chrono>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
+#else
+#include <boost/asio/any_io_executor.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A token bucket. The tokens get refilled from the time passed whenever they're looked at,
+// so nothing runs periodically. Only while somebody waits, one entry in the timer wheel
+// is armed for the time the first waiter's tokens will be there.
+//
+// Waiters are served strictly in FIFO order, a waiter whose tokens aren't there yet blocks everyone behind it.
+struct rate_limiter_impl : detail::service_member
+{
+  using clock_type = std::chrono::steady_clock;
+
+  BOOST_SAM_DECL rate_limiter_impl(net::execution_context &ctx, int rate, clock_type::duration interval, int burst,
+                                   int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT);
+
+  rate_limiter_impl(const rate_limiter_impl &) = delete;
+  BOOST_SAM_DECL rate_limiter_impl(rate_limiter_impl &&mi);
+
+  rate_limiter_impl &operator=(const rate_limiter_impl &) = delete;
+  BOOST_SAM_DECL rate_limiter_impl &operator=(rate_limiter_impl &&lhs) noexcept;
+
+  BOOST_SAM_DECL ~rate_limiter_impl();
+
+  BOOST_SAM_DECL void shutdown() override;
+
+  BOOST_SAM_DECL bool try_acquire(int n);
+
+  // Take n tokens if nobody waits & they're there. Requires mtx_ to be held.
+  BOOST_SAM_DECL bool try_acquire_locked(int n);
+
+  BOOST_SAM_DECL void acquire(int n, error_code &ec, const net::any_io_executor &exec);
+
+  // Enqueue a waiter & arm the timer if it's the first one. Requires mtx_ to be held.
+  BOOST_SAM_DECL void add_waiter(detail::semaphore_wait_op *waiter, const net::any_io_executor &exec);
+
+  // Dequeue a waiter & complete it with ec. Requires mtx_ to be held.
+  BOOST_SAM_DECL void cancel_waiter(detail::semaphore_wait_op *waiter, error_code ec);
+
+  // The refill time is there. Called with mtx_ held.
+  BOOST_SAM_DECL void on_timeout() override;
+
+  // The number of tokens available right now.
+  BOOST_SAM_DECL int available() const;
+
+  int burst() const noexcept { return burst_; }
+
+  struct acquire_op_t;
+
+private:
+  // The timer entry of the first waiter, it doesn't complete anything itself, on_timeout does.
+  struct refill_entry final : timer_entry
+  {
+    void expire() override {}
+  };
+
+  BOOST_SAM_DECL void refill(clock_type::time_point now) const;
+  // Hand the tokens to the waiters at the front & re-arm the timer for the next one.
+  BOOST_SAM_DECL void wake_waiters();
+  BOOST_SAM_DECL void arm();
+  BOOST_SAM_DECL void disarm();
+
+  // the time it takes to refill one token.
+  std::chrono::duration<double, std::nano>      per_token_;
+  int                                           burst_;
+  mutable double                                tokens_;
+  mutable clock_type::time_point                last_;
+  detail::basic_bilist_holder<void(error_code)> waiters_;
+  refill_entry                                  refill_;
+  net::any_io_executor                          exec_;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/rate_limiter_impl.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_RATE_LIMITER_IMPL_HPP
@@ -0,0 +1,171 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_RCU_IMPL_HPP
+#define BOOST_SAM_DETAIL_RCU_IMPL_HPP
+
+#include <boost/sam/detail/aligned_array.hpp>
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/service.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A snapshot, which gets deleted once no reader can see it anymore.
+struct rcu_node
+{
+  virtual ~rcu_node() = default;
+
+  rcu_node     *next  = nullptr;
+  // the epoch it got replaced in.
+  std::uint64_t epoch = 0u;
+};
+
+template <typename T>
+struct rcu_snapshot final : rcu_node
+{
+  template <typename... Args>
+  explicit rcu_snapshot(Args &&...args) : value(std::forward<Args>(args)...)
+  {
+  }
+
+  T value;
+};
+
+// Epoch based reclamation with two reader counters per slot, one for even & one for odd epochs.
+//
+// A grace period bumps the epoch and waits for the counters of the previous one to drain. Grace periods don't overlap,
+// so once one ends, no reader from its epoch or any earlier one is left, and every snapshot replaced
+// up to that epoch can be deleted.
+struct rcu_impl : detail::service_member
+{
+  BOOST_SAM_DECL rcu_impl(net::execution_context &ctx, int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT);
+
+  // The readers of the even or the odd epochs on one slot.
+  struct reader_counter
+  {
+    std::atomic<std::ptrdiff_t> count{0};
+    unsigned                    parity = 0u;
+  };
+
+  // Enter a read section. Returns the counter to leave it with.
+  BOOST_SAM_DECL reader_counter &read_lock() noexcept;
+  BOOST_SAM_DECL void            read_unlock(reader_counter &counter) noexcept;
+
+  // Hand over a snapshot that got replaced, to be deleted after the next grace period,
+  // which gets started if none is running.
+  BOOST_SAM_DECL void retire(rcu_node *node);
+
+  // Wait for a grace period to start & end. If none is running, one gets started and might end right away,
+  // in which case the waiter doesn't get enqueued & true is returned. Requires mtx_ to be held.
+  // Returns the snapshots that can be deleted in `reclaimed`, which should be done after releasing mtx_.
+  BOOST_SAM_DECL bool synchronize_or_add_waiter(detail::wait_op *waiter, rcu_node *&reclaimed) noexcept;
+
+  BOOST_SAM_DECL void synchronize(error_code &ec);
+
+  // Delete a list of snapshots.
+  BOOST_SAM_DECL static void reclaim(rcu_node *node) noexcept;
+
+  void shutdown() override
+  {
+    lock_type l{mtx_};
+    auto w = std::move(waiters_);
+    auto n = std::move(next_waiters_);
+    l.unlock();
+    w.shutdown();
+    n.shutdown();
+  }
+
+  // Two counters per cache line, so readers on different threads don't contend.
+  struct alignas(64) reader_slot
+  {
+    reader_slot() noexcept { count[1].parity = 1u; }
+
+    reader_counter count[2];
+  };
+
+  std::atomic<std::uint64_t>     epoch_{0u};
+  std::size_t                    slot_count_;
+  aligned_array<reader_slot>     slots_;
+
+  // a grace period is running & waits for the readers of grace_epoch_.
+  bool                           in_grace_    = false;
+  std::uint64_t                  grace_epoch_ = 0u;
+  // 1 + the parity of grace_epoch_ while a grace period runs, 0 otherwise.
+  // The reader emptying a counter of that parity needs to check on the grace period when leaving.
+  std::atomic<unsigned>          draining_{0u};
+
+  rcu_node *retired_head_ = nullptr;
+  rcu_node *retired_tail_ = nullptr;
+
+  // the waiters for the running grace period & the ones that arrived after it started.
+  detail::basic_bilist_holder<void(error_code)> waiters_;
+  detail::basic_bilist_holder<void(error_code)> next_waiters_;
+
+  rcu_impl()                 = delete;
+  rcu_impl(const rcu_impl &) = delete;
+  rcu_impl(rcu_impl &&mi)
+      : detail::service_member(std::move(mi)), epoch_(mi.epoch_.load()), slot_count_(mi.slot_count_),
+        slots_(std::move(mi.slots_)), in_grace_(mi.in_grace_), grace_epoch_(mi.grace_epoch_),
+        draining_(mi.draining_.load()), retired_head_(mi.retired_head_), retired_tail_(mi.retired_tail_),
+        waiters_(std::move(mi.waiters_)), next_waiters_(std::move(mi.next_waiters_))
+  {
+    mi.in_grace_     = false;
+    mi.retired_head_ = mi.retired_tail_ = nullptr;
+  }
+
+  rcu_impl &operator=(const rcu_impl &lhs) = delete;
+  rcu_impl &operator=(rcu_impl &&lhs) noexcept
+  {
+    detail::service_member::operator=(std::move(lhs));
+    lock_type _{lhs.mtx_};
+    reclaim(retired_head_);
+    epoch_.store(lhs.epoch_.load());
+    slot_count_    = lhs.slot_count_;
+    slots_         = std::move(lhs.slots_);
+    in_grace_      = lhs.in_grace_;
+    grace_epoch_   = lhs.grace_epoch_;
+    draining_.store(lhs.draining_.load());
+    retired_head_  = lhs.retired_head_;
+    retired_tail_  = lhs.retired_tail_;
+    lhs.in_grace_  = false;
+    lhs.retired_head_ = lhs.retired_tail_ = nullptr;
+    waiters_       = std::move(lhs.waiters_);
+    next_waiters_  = std::move(lhs.next_waiters_);
+    return *this;
+  }
+
+  BOOST_SAM_DECL ~rcu_impl();
+
+  struct synchronize_op_t;
+
+private:
+  // The slot of the calling thread.
+  BOOST_SAM_DECL reader_slot &slot() noexcept;
+  // The number of readers in the epochs with the parity of `epoch`.
+  BOOST_SAM_DECL std::ptrdiff_t readers(std::uint64_t epoch) const noexcept;
+  // Bump the epoch & wait for its readers. Requires mtx_ to be held & no grace period to be running.
+  BOOST_SAM_DECL rcu_node *start_grace() noexcept;
+  // End the grace period if its readers are gone, start the next one if needed & return what can be deleted.
+  // Requires mtx_ to be held.
+  BOOST_SAM_DECL rcu_node *check_grace() noexcept;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/rcu_impl.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_RCU_IMPL_HPP
@@ -0,0 +1,99 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_RECURSIVE_MUTEX_IMPL_HPP
+#define BOOST_SAM_DETAIL_RECURSIVE_MUTEX_IMPL_HPP
+
+#include <boost/sam/detail/basic_op_model.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/service.hpp>
+
+#include <cstddef>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A waiter that knows who it's locking for, so the ownership can be handed over on unlock.
+struct recursive_wait_op : wait_op
+{
+  const void *owner = nullptr;
+};
+
+struct recursive_mutex_impl : detail::service_member
+{
+  BOOST_SAM_DECL recursive_mutex_impl(net::execution_context &ctx,
+                                      int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT);
+
+  BOOST_SAM_DECL void lock(const void *owner, error_code &ec);
+  BOOST_SAM_DECL void unlock();
+  bool                try_lock(const void *owner)
+  {
+    lock_type _{mtx_};
+    return try_acquire(owner);
+  }
+
+  // Lock the mutex or re-enter it if `owner` holds it already. Requires mtx_ to be held.
+  bool try_acquire(const void *owner) noexcept
+  {
+    BOOST_SAM_ASSERT(owner != nullptr);
+    if (depth_ != 0u && owner_ != owner)
+      return false;
+    owner_ = owner;
+    depth_++;
+    return true;
+  }
+
+  BOOST_SAM_DECL void add_waiter(detail::recursive_wait_op *waiter) noexcept;
+
+  void shutdown() override
+  {
+    lock_type l{mtx_};
+    auto w = std::move(waiters_);
+    l.unlock();
+    w.shutdown();
+  }
+
+  const void *owner_;
+  std::size_t depth_;
+
+  detail::basic_bilist_holder<void(error_code)> waiters_;
+
+  recursive_mutex_impl()                             = delete;
+  recursive_mutex_impl(const recursive_mutex_impl &) = delete;
+  recursive_mutex_impl(recursive_mutex_impl &&mi)
+      : detail::service_member(std::move(mi)), owner_(mi.owner_), depth_(mi.depth_), waiters_(std::move(mi.waiters_))
+  {
+    mi.owner_ = nullptr;
+    mi.depth_ = 0u;
+  }
+
+  recursive_mutex_impl &operator=(const recursive_mutex_impl &lhs) = delete;
+  recursive_mutex_impl &operator=(recursive_mutex_impl &&lhs) noexcept
+  {
+    detail::service_member::operator=(std::move(lhs));
+    lock_type _{lhs.mtx_};
+    owner_     = lhs.owner_;
+    depth_     = lhs.depth_;
+    lhs.owner_ = nullptr;
+    lhs.depth_ = 0u;
+    waiters_   = std::move(lhs.waiters_);
+    return *this;
+  }
+
+  BOOST_SAM_DECL ~recursive_mutex_impl();
+
+  struct lock_op_t;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/recursive_mutex_impl.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_RECURSIVE_MUTEX_IMPL_HPP
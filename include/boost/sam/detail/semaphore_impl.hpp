@@ -7,14 +7,69 @@
 
 #include <boost/sam/detail/basic_op_model.hpp>
 #include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/priority_bilist_holder.hpp>
 #include <boost/sam/detail/service.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
 #include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
 
 BOOST_SAM_BEGIN_NAMESPACE
 
 namespace detail
 {
 
+// A waiter for `weight` permits.
+struct semaphore_wait_op : wait_op
+{
+  int weight = 1;
+  // only set if the queue delay is controlled.
+  std::chrono::steady_clock::time_point enqueued;
+  // the point in time the waiter times out at, if any.
+  std::chrono::steady_clock::time_point deadline = (std::chrono::steady_clock::time_point::max)();
+};
+
+// A waiter with a deadline, which takes itself out of the counts of its semaphore_impl when it expires.
+struct semaphore_timed_wait_op : semaphore_wait_op
+{
+  BOOST_SAM_DECL void on_expire(service_member *owner);
+};
+
+// The shedding configuration & the state of the CoDel controller for the queue delay.
+struct semaphore_shedding
+{
+  using clock_type = std::chrono::steady_clock;
+
+  std::size_t          max_queue_length = (std::numeric_limits<std::size_t>::max)();
+  // zero if the queue delay isn't controlled.
+  clock_type::duration target{0}, interval{0};
+
+  // the queue delay of the last waiter that got dequeued.
+  clock_type::duration   delay{0};
+  clock_type::time_point first_above, drop_next;
+  unsigned               drop_count = 0u;
+  bool                   dropping   = false;
+};
+
+// The permits handed out as leases, which get reclaimed unless they're renewed or released before their deadline.
+struct semaphore_leases
+{
+  using clock_type = std::chrono::steady_clock;
+
+  // 0 is the id of no lease.
+  std::uint64_t                                               next_id = 1u;
+  std::unordered_map<std::uint64_t, clock_type::time_point>   deadlines;
+  // the leases ordered by deadline, so the first one is the next to expire.
+  std::set<std::pair<clock_type::time_point, std::uint64_t>> queue;
+};
+
+// The count is atomic, so acquires & releases that don't involve waiters never take the mutex.
+// Waiters announce themselves in waiting_ before checking the count, and releases check waiting_
+// after increasing it, so one of them always sees the other.
 struct semaphore_impl : detail::service_member
 {
   BOOST_SAM_DECL semaphore_impl(net::execution_context &ctx,
@@ -23,44 +78,218 @@ struct semaphore_impl : detail::service_member
 
   semaphore_impl(const semaphore_impl &) = delete;
   semaphore_impl(semaphore_impl &&mi)
-      : detail::service_member(std::move(mi)), count_(mi.count_), waiters_(std::move(mi.waiters_))
+      : detail::service_member(std::move(mi)), count_(mi.count_.load()), waiting_(mi.waiting_.load()),
+        queued_(mi.queued_), strict_fifo_(mi.strict_fifo_), shedding_(mi.shedding_), waiters_(std::move(mi.waiters_)),
+        deadlines_(std::move(mi.deadlines_))
   {
+    mi.waiting_ = 0;
+    mi.queued_  = 0u;
+    lock_type _{mi.mtx_};
+    adopt_waiters();
+    mi.disarm_leases();
+    leases_     = std::move(mi.leases_);
+    lease_exec_ = mi.lease_exec_;
+    arm_leases();
   }
 
   semaphore_impl &operator=(const semaphore_impl &) = delete;
   semaphore_impl &operator=(semaphore_impl &&lhs) noexcept
   {
     lock_type _{mtx_};
-    count_ = lhs.count_;
+    lock_type l{lhs.mtx_};
+    count_       = lhs.count_.load();
+    strict_fifo_ = lhs.strict_fifo_;
+    shedding_    = lhs.shedding_;
     std::swap(lhs.waiters_, waiters_);
+    std::swap(lhs.deadlines_, deadlines_);
+    std::swap(lhs.queued_, queued_);
+    const int w = waiting_.load();
+    waiting_    = lhs.waiting_.load();
+    lhs.waiting_ = w;
+    adopt_waiters();
+    lhs.adopt_waiters();
+    disarm_leases();
+    lhs.disarm_leases();
+    std::swap(leases_, lhs.leases_);
+    std::swap(lease_exec_, lhs.lease_exec_);
+    arm_leases();
+    lhs.arm_leases();
     return *this;
   }
 
+  BOOST_SAM_DECL ~semaphore_impl();
+
   void shutdown() override
   {
     lock_type l{mtx_};;
-    auto w = std::move(waiters_);
+    auto w   = std::move(waiters_);
+    waiting_ = 0;
+    queued_  = 0u;
+    deadlines_.clear();
+    disarm_leases();
+    leases_ = semaphore_leases();
     l.unlock();
     w.shutdown();
   }
 
-  BOOST_SAM_DECL bool try_acquire();
+  BOOST_SAM_DECL bool try_acquire(int n = 1);
+
+  // Take n permits without locking, if nobody waits.
+  bool try_acquire_uncontended(int n) noexcept { return waiting_.load() == 0 && try_take(n); }
+
+  bool uncontended() const noexcept { return waiting_.load() == 0; }
+
+  // Take n permits if the waiters don't get them first. Requires mtx_ to be held.
+  bool try_acquire_locked(int n)
+  {
+    wake_waiters();
+    return (!strict_fifo_ || waiters_.empty()) && try_take(n);
+  }
+
+  // Change the count by delta without waking anyone up. It may go negative,
+  // which blocks acquires until enough permits got released.
+  void adjust(int delta) noexcept { count_ += delta; }
 
-  BOOST_SAM_DECL void acquire(error_code &ec);
+  // Take up to n permits if any are available, returns the number taken. Requires mtx_ to be held.
+  BOOST_SAM_DECL int take_up_to(int n);
 
-  BOOST_SAM_DECL void release();
+  BOOST_SAM_DECL void acquire(error_code &ec, int n = 1);
 
-  BOOST_SAM_NODISCARD BOOST_SAM_DECL int value() const noexcept;
+  BOOST_SAM_DECL void release(int n = 1);
 
-  BOOST_SAM_DECL void add_waiter(detail::wait_op *waiter) noexcept;
+  // The count minus the permits waited for. Lock-free, but not a consistent snapshot while it changes.
+  BOOST_SAM_NODISCARD int value() const noexcept { return count_.load() - waiting_.load(); }
 
-  BOOST_SAM_DECL int decrement();
+  // Whether a new waiter should be rejected instead of enqueued, because the queue is full
+  // or its deadline can't be met with the current queue delay. Requires mtx_ to be held.
+  BOOST_SAM_DECL bool shed_on_enqueue(std::chrono::steady_clock::time_point deadline =
+                                          (std::chrono::steady_clock::time_point::max)()) const;
 
-  BOOST_SAM_NODISCARD BOOST_SAM_DECL int count() const noexcept;
+  // Enqueue a waiter, which might get the permits right away. Requires mtx_ to be held.
+  BOOST_SAM_DECL void add_waiter(detail::semaphore_wait_op *waiter, std::size_t priority = 0u);
+
+  // Dequeue a waiter & complete it with ec. Requires mtx_ to be held.
+  BOOST_SAM_DECL void cancel_waiter(detail::semaphore_wait_op *waiter, error_code ec);
+
+  // Hand the permits to as many waiters as fit, then shed the waiters whose deadline
+  // can't be met with the current queue delay anymore. Requires mtx_ to be held.
+  BOOST_SAM_DECL void wake_waiters();
+
+  // Take a waiter that timed out out of the counts, before it completes. Requires mtx_ to be held.
+  BOOST_SAM_DECL void expire_waiter(detail::semaphore_wait_op *waiter);
+
+  // Reclaims the expired leases & wakes up the waiters an expired one might have blocked.
+  BOOST_SAM_DECL void on_timeout() override;
+
+  // Turn a permit that was just acquired into a lease & return its id.
+  // `exec` runs the timer that reclaims the expired leases, only the one of the first lease is kept.
+  BOOST_SAM_DECL std::uint64_t add_lease(std::chrono::steady_clock::duration ttl, const net::any_io_executor &exec);
+  // Move the deadline of a lease to now + ttl. Returns false if it expired already.
+  BOOST_SAM_DECL bool renew_lease(std::uint64_t id, std::chrono::steady_clock::duration ttl);
+  // Release the permit of a lease. Returns false if it expired already, i.e. the permit was reclaimed.
+  BOOST_SAM_DECL bool release_lease(std::uint64_t id);
+  BOOST_SAM_DECL bool has_lease(std::uint64_t id) const;
+  // The number of leases currently held.
+  BOOST_SAM_DECL std::size_t leases() const;
+
+  void set_strict_fifo(bool strict)
+  {
+    lock_type _{mtx_};
+    strict_fifo_ = strict;
+    wake_waiters();
+  }
+
+  void set_max_queue_length(std::size_t n)
+  {
+    lock_type _{mtx_};
+    shedding_.max_queue_length = n;
+  }
+
+  void set_queue_delay_target(std::chrono::steady_clock::duration target, std::chrono::steady_clock::duration interval)
+  {
+    lock_type _{mtx_};
+    shedding_.target      = target;
+    shedding_.interval    = interval;
+    shedding_.first_above = shedding_.drop_next = {};
+    shedding_.drop_count  = 0u;
+    shedding_.dropping    = false;
+  }
+
+  void set_aging(std::size_t wakeups)
+  {
+    lock_type _{mtx_};
+    waiters_.set_aging(wakeups);
+  }
+
+  BOOST_SAM_NODISCARD int count() const noexcept { return count_.load(); }
 
 private:
-  int                                           count_;
-  detail::basic_bilist_holder<void(error_code)> waiters_;
+  // Whether the CoDel controller drops a waiter dequeued with the given queue delay. Requires mtx_ to be held.
+  BOOST_SAM_DECL bool codel_drop(std::chrono::steady_clock::duration delay, std::chrono::steady_clock::time_point now);
+
+  // Whether the waiter is in deadlines_, i.e. it has a deadline & got enqueued while the queue delay was controlled.
+  static bool tracks_deadline(const detail::semaphore_wait_op *waiter) noexcept
+  {
+    return waiter->enqueued != std::chrono::steady_clock::time_point{} &&
+           waiter->deadline != (std::chrono::steady_clock::time_point::max)();
+  }
+  // Remove a waiter that leaves the queue from deadlines_. Requires mtx_ to be held.
+  BOOST_SAM_DECL void forget_deadline(detail::semaphore_wait_op *waiter);
+  // Fail the waiters with net::error::try_again whose time between enqueueing & deadline is shorter
+  // than the current queue delay. Returns whether any were shed. Requires mtx_ to be held.
+  BOOST_SAM_DECL bool shed_late_waiters();
+
+  // The timer entry of the lease that expires first, it doesn't complete anything itself, on_timeout does.
+  struct lease_entry final : timer_entry
+  {
+    void expire() override {}
+  };
+
+  // Erase the lease & stop the timer if it was the first one. Requires mtx_ to be held.
+  BOOST_SAM_DECL bool erase_lease(std::uint64_t id);
+  // Give the permits of the expired leases back & wake the waiters up. Requires mtx_ to be held.
+  BOOST_SAM_DECL void reclaim_leases();
+  // (Re-)arm the timer for the first lease, after it changed. Requires mtx_ to be held.
+  // Make the timed waiters expire here, after they got moved here.
+  // Requires the mutex of the semaphore they came from to be held.
+  void adopt_waiters()
+  {
+    waiters_.visit(
+        [this](wait_op *op)
+        {
+          adopt_timer(op);
+          return true;
+        });
+  }
+
+  BOOST_SAM_DECL void arm_leases();
+  BOOST_SAM_DECL void disarm_leases();
+
+  // Take n permits if available.
+  bool try_take(int n) noexcept
+  {
+    int c = count_.load();
+    while (c >= n)
+      if (count_.compare_exchange_weak(c, c - n))
+        return true;
+    return false;
+  }
+
+  std::atomic<int>                                 count_;
+  // the sum of the weights of all waiters.
+  std::atomic<int>                                 waiting_{0};
+  // the number of waiters.
+  std::size_t                                      queued_ = 0u;
+  // if set, waiters that don't fit block the ones behind them.
+  bool                                             strict_fifo_ = false;
+  semaphore_shedding                               shedding_;
+  detail::priority_bilist_holder<void(error_code)> waiters_;
+  // the waiters tracked by tracks_deadline, ordered by the time between their enqueueing & their deadline.
+  // The queue delay only changes when a waiter gets dequeued, so they're only checked then.
+  std::multiset<std::pair<std::chrono::steady_clock::duration, detail::semaphore_wait_op *>> deadlines_;
+  semaphore_leases                                 leases_;
+  lease_entry                                      lease_timer_;
+  net::any_io_executor                             lease_exec_;
   struct acquire_op_t;
 };
 
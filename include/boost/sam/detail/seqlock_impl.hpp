@@ -0,0 +1,112 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_SEQLOCK_IMPL_HPP
+#define BOOST_SAM_DETAIL_SEQLOCK_IMPL_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/mutex_impl.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A waiter for the version to move past `version`.
+struct version_wait_op : wait_op
+{
+  std::uint64_t version = 0u;
+};
+
+// The writer side of a seqlock is a plain mutex. The sequence counter is odd while a write is in progress,
+// readers copy the value optimistically & retry if the counter changed in between.
+struct seqlock_impl : mutex_impl
+{
+  seqlock_impl(net::execution_context &ctx, int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT)
+      : mutex_impl(ctx, concurrency_hint)
+  {
+  }
+
+  // The number of completed writes.
+  std::uint64_t version() const noexcept { return seq_.load(std::memory_order_acquire) >> 1u; }
+
+  // Start an optimistic read, waiting out a write in progress.
+  std::uint64_t read_begin() const noexcept
+  {
+    auto seq = seq_.load(std::memory_order_acquire);
+    while ((seq & 1u) != 0u)
+      seq = seq_.load(std::memory_order_acquire);
+    return seq;
+  }
+
+  // Whether a write happened since read_begin, so the read needs to be repeated.
+  bool read_retry(std::uint64_t seq) const noexcept
+  {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return seq_.load(std::memory_order_relaxed) != seq;
+  }
+
+  // Start a write. Requires the lock to be held.
+  void write_begin() noexcept
+  {
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  // Publish the write & complete the version waiters it satisfies.
+  BOOST_SAM_DECL void write_end();
+
+  // Requires mtx_ to be held, and the version not to have moved past the waiter's yet.
+  BOOST_SAM_DECL void add_version_waiter(detail::version_wait_op *waiter) noexcept;
+
+  void shutdown() override
+  {
+    lock_type l{mtx_};
+    auto w = std::move(waiters_);
+    auto v = std::move(version_waiters_);
+    l.unlock();
+    w.shutdown();
+    v.shutdown();
+  }
+
+  std::atomic<std::uint64_t>                    seq_{0u};
+  detail::basic_bilist_holder<void(error_code)> version_waiters_;
+
+  seqlock_impl()                     = delete;
+  seqlock_impl(const seqlock_impl &) = delete;
+  seqlock_impl(seqlock_impl &&mi)
+      : mutex_impl(std::move(mi)), seq_(mi.seq_.load()), version_waiters_(std::move(mi.version_waiters_))
+  {
+  }
+
+  seqlock_impl &operator=(const seqlock_impl &lhs) = delete;
+  seqlock_impl &operator=(seqlock_impl &&lhs) noexcept
+  {
+    lock_type _{mtx_};
+    lock_type l{lhs.mtx_};
+    locked_          = lhs.locked_;
+    lhs.locked_      = false;
+    seq_.store(lhs.seq_.load());
+    std::swap(waiters_, lhs.waiters_);
+    std::swap(version_waiters_, lhs.version_waiters_);
+    // the timed lock waiters expire with the seqlock they're in now.
+    adopt_waiters();
+    lhs.adopt_waiters();
+    return *this;
+  }
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/seqlock_impl.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_SEQLOCK_IMPL_HPP
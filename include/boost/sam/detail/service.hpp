@@ -12,14 +12,20 @@
 #include <boost/sam/detail/bilist_node.hpp>
 #include <boost/sam/detail/concurrency_hint.hpp>
 #include <boost/sam/detail/conditionally_enabled_mutex.hpp>
+#include <boost/sam/detail/timer_wheel.hpp>
+#include <memory>
 #include <mutex>
 
 #if defined(BOOST_SAM_STANDALONE)
+#include <asio/any_io_executor.hpp>
 #include <asio/detail/null_mutex.hpp>
 #include <asio/execution_context.hpp>
+#include <asio/steady_timer.hpp>
 #else
+#include <boost/asio/any_io_executor.hpp>
 #include <boost/asio/detail/null_mutex.hpp>
 #include <boost/asio/execution_context.hpp>
+#include <boost/asio/steady_timer.hpp>
 #endif
 
 BOOST_SAM_BEGIN_NAMESPACE
@@ -51,8 +57,26 @@ struct op_list_service final : net::detail::execution_context_service_base<op_li
     sm->unlink();
   }
 
+  // Time out `entry` at the deadline. Requires the owner's mutex to be held.
+  // The timer driving the wheel is created on first use, on the executor passed in.
+  BOOST_SAM_DECL void add_timer(timer_entry *entry, service_member *owner, std::chrono::steady_clock::time_point deadline,
+                                const net::any_io_executor &exec);
+  // Requires the owner's mutex to be held.
+  BOOST_SAM_DECL void remove_timer(timer_entry *entry);
+  // Hand the entry over to the owner its waiter got moved to. Requires the old owner's mutex to be held.
+  BOOST_SAM_DECL void rebind_timer(timer_entry *entry, service_member *owner);
+
   BOOST_SAM_DECL void shutdown() override;
   ~op_list_service() final = default;
+
+private:
+  BOOST_SAM_DECL void arm_timer();
+  BOOST_SAM_DECL void on_timer(error_code ec);
+
+  timer_wheel                        wheel_;
+  std::unique_ptr<net::steady_timer> timer_;
+  bool                               timer_armed_ = false;
+  std::uint64_t                      timer_tick_  = 0u;
 };
 
 struct service_member : bilist_node
@@ -95,6 +119,25 @@ struct service_member : bilist_node
   using mutex_type        = detail::conditionally_enabled_mutex;
   using lock_type         = typename mutex_type::scoped_lock;
   virtual void shutdown() = 0;
+  // Called after a timed waiter expired, with mtx_ held.
+  virtual void on_timeout() {}
+
+  // Make the timed waiter expire here, after it got moved here from another member.
+  // Requires the other member's mutex to be held, so it can't expire meanwhile.
+  template <typename Op>
+  void adopt_timer(Op *op)
+  {
+    if (auto entry = op->timer())
+      entry->service->rebind_timer(entry, this);
+  }
+
+  // The same for all waiters in a list.
+  template <typename Op>
+  void adopt_timers(bilist_node &waiters)
+  {
+    for (auto nx = waiters.next_; nx != &waiters; nx = nx->next_)
+      adopt_timer(static_cast<Op *>(nx));
+  }
 
   mutable mutex_type mtx_;
 };
@@ -14,21 +14,38 @@
 #include <boost/sam/detail/service.hpp>
 
 #include <mutex>
+#include <utility>
 
 BOOST_SAM_BEGIN_NAMESPACE
 
+/// Decides who gets a shared_mutex next, when readers & writers are waiting.
+enum class shared_mutex_policy
+{
+  /// Readers get in whenever no writer holds the lock & are admitted first on unlock. Writers can starve.
+  reader_preferring,
+  /// Readers queue up behind waiting writers, which are served first on unlock. Readers can starve.
+  writer_preferring,
+  /// Readers queue up behind waiting writers, while an unlocking writer admits all waiting readers.
+  /// Readers & writers take turns, so both have a bounded wait.
+  phase_fair
+};
+
 namespace detail
 {
 
 struct shared_mutex_impl : mutex_impl
 {
-  using mutex_impl::mutex_impl;
+  shared_mutex_impl(net::execution_context &ctx, int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT,
+                    shared_mutex_policy policy = shared_mutex_policy::reader_preferring)
+      : mutex_impl(ctx, concurrency_hint), policy_(policy)
+  {
+  }
 
   BOOST_SAM_DECL void lock(error_code &ec) override;
   bool                try_lock() override
   {
     lock_type _{mtx_};
-    if (locked_ || locked_shared_ > 0u)
+    if (!can_lock())
       return false;
     else
       return locked_ = true;
@@ -40,7 +57,7 @@ struct shared_mutex_impl : mutex_impl
   bool                try_lock_shared()
   {
     lock_type _{mtx_};
-    if (locked_)
+    if (!can_lock_shared())
       return false;
     else
     {
@@ -49,44 +66,126 @@ struct shared_mutex_impl : mutex_impl
     }
   }
   BOOST_SAM_DECL void unlock_shared();
+  // Turn the exclusive lock into a shared one & admit the queued readers along with it.
+  BOOST_SAM_DECL void downgrade();
 
   BOOST_SAM_DECL void add_shared_waiter(detail::wait_op *waiter) noexcept;
 
+  BOOST_SAM_DECL void lock_upgrade(error_code &ec);
+  bool                try_lock_upgrade()
+  {
+    lock_type _{mtx_};
+    if (!can_lock_upgrade())
+      return false;
+    else
+      return upgrade_locked_ = true;
+  }
+  BOOST_SAM_DECL void unlock_upgrade();
+  // Turn the upgrade lock into an exclusive one, if no reader holds the lock.
+  BOOST_SAM_DECL bool try_upgrade();
+
+  BOOST_SAM_DECL void add_upgrade_waiter(detail::wait_op *waiter) noexcept;
+  // Start turning the upgrade lock into an exclusive one. New readers are held back right away,
+  // `waiter` completes once the current ones are gone. Returns false if it got enqueued. Requires mtx_ to be held.
+  BOOST_SAM_DECL bool upgrade_or_add_waiter(detail::wait_op *waiter) noexcept;
+  // Go back to the upgrade lock after the pending upgrade got cancelled. Requires mtx_ to be held.
+  BOOST_SAM_DECL void cancel_upgrade() noexcept;
+
+  // Whether a writer can get the lock right away. Requires mtx_ to be held.
+  bool can_lock() const noexcept { return !locked_ && locked_shared_ == 0u && !upgrade_locked_; }
+  // Whether a reader can get the lock right away. Requires mtx_ to be held.
+  bool can_lock_shared() const noexcept
+  {
+    return !locked_ && (policy_ == shared_mutex_policy::reader_preferring || waiters_.empty());
+  }
+  // Whether an upgrader can get the lock right away. Requires mtx_ to be held.
+  bool can_lock_upgrade() const noexcept { return !upgrade_locked_ && can_lock_shared(); }
+  // Pass the exclusive lock on to the waiters the policy picks. Returns false if nobody is waiting.
+  // Requires mtx_ to be held.
+  BOOST_SAM_DECL bool hand_over() noexcept;
+
+  BOOST_SAM_DECL void yield(detail::wait_op *waiter) noexcept override;
+  // Give up a shared lock to the pending exclusive waiters and enqueue `waiter` as a shared waiter.
+  BOOST_SAM_DECL void relock_shared(detail::wait_op *waiter) noexcept;
+  // Admit the queued shared waiters if no exclusive lock is held or pending.
+  BOOST_SAM_DECL void admit_shared_waiters() noexcept;
+  // Admit the first upgrade waiter, unless the lock is held exclusively or for upgrade. Requires mtx_ to be held.
+  BOOST_SAM_DECL void admit_upgrade_waiter() noexcept;
+  // Pass the lock on to a pending upgrade or the first writer, after the last reader left. Requires mtx_ to be held.
+  BOOST_SAM_DECL void on_readers_drained() noexcept;
+  // a timed out exclusive waiter might have been the only thing holding back the shared waiters.
+  void on_timeout() override { admit_shared_waiters(); }
+
   void shutdown() override
   {
     lock_type l{mtx_};;
     auto w = std::move(waiters_);
     auto s = std::move(shared_waiters_);
+    auto u = std::move(upgrade_waiters_);
+    auto p = std::move(upgrading_);
     l.unlock();
     w.shutdown();
     s.shutdown();
+    u.shutdown();
+    p.shutdown();
   }
 
+  shared_mutex_policy policy_;
   std::uintptr_t locked_shared_{0u};
   detail::basic_bilist_holder<void(error_code)> shared_waiters_;
+  // the upgrade lock is held. It's shared with the readers, but not with other upgraders or writers.
+  bool upgrade_locked_ = false;
+  detail::basic_bilist_holder<void(error_code)> upgrade_waiters_;
+  // the upgrade waiting for the readers to leave, if any. locked_ is already set while it waits.
+  detail::basic_bilist_holder<void(error_code)> upgrading_;
 
   shared_mutex_impl()                   = delete;
   shared_mutex_impl(const shared_mutex_impl &) = delete;
   shared_mutex_impl(shared_mutex_impl &&mi)
       : mutex_impl(std::move(mi)),
+        policy_(mi.policy_),
         locked_shared_(mi.locked_shared_),
-        shared_waiters_(std::move(mi.shared_waiters_))
+        shared_waiters_(std::move(mi.shared_waiters_)),
+        upgrade_locked_(mi.upgrade_locked_),
+        upgrade_waiters_(std::move(mi.upgrade_waiters_)),
+        upgrading_(std::move(mi.upgrading_))
   {
     mi.locked_ = false;
+    mi.upgrade_locked_ = false;
+    lock_type _{mi.mtx_};
+    adopt_waiters();
   }
 
   shared_mutex_impl &operator=(const shared_mutex_impl &lhs) = delete;
   shared_mutex_impl &operator=(shared_mutex_impl &&lhs) noexcept
   {
-    lock_type _{lhs.mtx_};
+    lock_type _{mtx_};
+    lock_type l{lhs.mtx_};
     locked_      = lhs.locked_;
+    policy_      = lhs.policy_;
     locked_shared_ = lhs.locked_shared_;
+    upgrade_locked_ = lhs.upgrade_locked_;
     lhs.locked_  = false;
     lhs.locked_shared_  = 0u;
-    lhs.waiters_ = std::move(waiters_);
-    lhs.shared_waiters_ = std::move(shared_waiters_);
+    lhs.upgrade_locked_ = false;
+    std::swap(waiters_, lhs.waiters_);
+    std::swap(shared_waiters_, lhs.shared_waiters_);
+    std::swap(upgrade_waiters_, lhs.upgrade_waiters_);
+    std::swap(upgrading_, lhs.upgrading_);
+    adopt_waiters();
+    lhs.adopt_waiters();
     return *this;
   }
+
+  // Make the timed waiters of all queues expire here, after they got moved here.
+  // Requires the mutex of the shared_mutex_impl they came from to be held.
+  void adopt_waiters()
+  {
+    mutex_impl::adopt_waiters();
+    adopt_timers<wait_op>(shared_waiters_);
+    adopt_timers<wait_op>(upgrade_waiters_);
+    adopt_timers<wait_op>(upgrading_);
+  }
 };
 
 } // namespace detail
@@ -94,7 +193,7 @@ struct shared_mutex_impl : mutex_impl
 BOOST_SAM_END_NAMESPACE
 
 #if defined(BOOST_SAM_HEADER_ONLY)
-#include <boost/sam/detail/impl/mutex_impl.ipp>
+#include <boost/sam/detail/impl/shared_mutex_impl.ipp>
 #endif
 
 
@@ -0,0 +1,104 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_STRIPED_MUTEX_IMPL_HPP
+#define BOOST_SAM_DETAIL_STRIPED_MUTEX_IMPL_HPP
+
+#include <boost/sam/detail/aligned_array.hpp>
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/service.hpp>
+#include <boost/sam/detail/thread_slots.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// A fixed number of mutexes, each padded to its own cache line, so that stripes don't contend.
+// All stripes share one registration with the op_list_service & live in one allocation.
+struct striped_mutex_impl : detail::service_member
+{
+  struct alignas(64) stripe
+  {
+    explicit stripe(bool enabled) : mtx(enabled) {}
+
+    mutex_type                                    mtx;
+    bool                                          locked = false;
+    detail::basic_bilist_holder<void(error_code)> waiters;
+  };
+
+  BOOST_SAM_DECL striped_mutex_impl(net::execution_context &ctx, std::size_t stripes,
+                                    int concurrency_hint = BOOST_SAM_CONCURRENCY_HINT_DEFAULT);
+
+  // The stripe a hash maps to. The bits are mixed first, so that identity hashes spread too.
+  static std::size_t index_of(std::size_t hash, std::size_t stripes) noexcept { return mix_hash(hash) % stripes; }
+
+  std::size_t size() const noexcept { return stripes_.size(); }
+  stripe     &get(std::size_t idx) noexcept { return stripes_[idx]; }
+
+  // Requires the stripe's mutex to be held.
+  bool try_acquire(stripe &st) noexcept
+  {
+    if (st.locked)
+      return false;
+    return st.locked = true;
+  }
+
+  // Requires the stripe's mutex to be held.
+  void add_waiter(stripe &st, detail::wait_op *waiter) noexcept { waiter->link_before(&st.waiters); }
+
+  bool try_lock(std::size_t idx)
+  {
+    auto     &st = stripes_[idx];
+    lock_type _{st.mtx};
+    return try_acquire(st);
+  }
+
+  BOOST_SAM_DECL void lock(std::size_t idx, error_code &ec);
+  BOOST_SAM_DECL void unlock(std::size_t idx);
+  BOOST_SAM_DECL void shutdown() override;
+
+  striped_mutex_impl()                           = delete;
+  striped_mutex_impl(const striped_mutex_impl &) = delete;
+  striped_mutex_impl(striped_mutex_impl &&mi) noexcept
+      : detail::service_member(std::move(mi)), stripes_(std::move(mi.stripes_))
+  {
+  }
+
+  striped_mutex_impl &operator=(const striped_mutex_impl &lhs) = delete;
+  striped_mutex_impl &operator=(striped_mutex_impl &&lhs) noexcept
+  {
+    detail::service_member::operator=(std::move(lhs));
+    std::swap(stripes_, lhs.stripes_);
+    return *this;
+  }
+
+  struct lock_op_t;
+
+private:
+  aligned_array<stripe> stripes_;
+};
+
+// Sort the stripes & drop duplicates, so they get locked in a global order. Returns the number of distinct stripes.
+template <std::size_t Size>
+std::size_t order_stripes(std::array<std::size_t, Size> &stripes)
+{
+  std::sort(stripes.begin(), stripes.end());
+  return static_cast<std::size_t>(std::unique(stripes.begin(), stripes.end()) - stripes.begin());
+}
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/striped_mutex_impl.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_STRIPED_MUTEX_IMPL_HPP
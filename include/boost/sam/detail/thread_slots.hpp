@@ -0,0 +1,58 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_THREAD_SLOTS_HPP
+#define BOOST_SAM_DETAIL_THREAD_SLOTS_HPP
+
+#include <boost/sam/detail/config.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+// The number of slots to spread state over, `per_thread` per hardware thread rounded up to a power of two,
+// but at most 256. Single threaded objects have no contention to spread out, so they get one.
+inline std::size_t slot_count(bool multi_threaded, std::size_t per_thread = 1u)
+{
+  std::size_t n = 1u;
+  if (!multi_threaded)
+    return n;
+
+  const std::size_t hc = per_thread * std::thread::hardware_concurrency();
+  while (n < hc && n < 256u)
+    n <<= 1u;
+  return n;
+}
+
+// The slot of the calling thread out of `count`, which needs to be a power of two.
+// The indices are handed out round robin, so threads spread evenly over the slots.
+inline std::size_t thread_slot(std::size_t count) noexcept
+{
+  static std::atomic<std::size_t> next_index{0u};
+  static thread_local std::size_t index = next_index.fetch_add(1u, std::memory_order_relaxed);
+  return index & (count - 1u);
+}
+
+// Mix the bits of a hash, so that identity hashes spread over shards too.
+// The low bits get dropped, since the unordered maps within the shards use them already.
+inline std::size_t mix_hash(std::size_t hash) noexcept
+{
+  hash ^= hash >> 17u;
+  hash *= 0x9E3779B1u;
+  return hash >> 7u;
+}
+
+// The shard a hash maps to out of `count`, which needs to be a power of two.
+inline std::size_t shard_index(std::size_t hash, std::size_t count) noexcept { return mix_hash(hash) & (count - 1u); }
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_THREAD_SLOTS_HPP
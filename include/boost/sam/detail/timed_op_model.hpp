@@ -0,0 +1,77 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_TIMED_OP_MODEL_HPP
+#define BOOST_SAM_DETAIL_TIMED_OP_MODEL_HPP
+
+#include <boost/sam/detail/basic_op.hpp>
+#include <boost/sam/detail/basic_op_model.hpp>
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/predicate_op.hpp>
+#include <boost/sam/detail/predicate_op_model.hpp>
+#include <boost/sam/detail/service.hpp>
+#include <boost/sam/detail/timer_wheel.hpp>
+
+#include <chrono>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+inline std::chrono::steady_clock::time_point to_steady_time(std::chrono::steady_clock::time_point tp) { return tp; }
+
+template <typename Clock, typename Duration>
+std::chrono::steady_clock::time_point to_steady_time(const std::chrono::time_point<Clock, Duration> &tp)
+{
+  return std::chrono::steady_clock::now() +
+         std::chrono::duration_cast<std::chrono::steady_clock::duration>(tp - Clock::now());
+}
+
+template <typename Rep, typename Period>
+std::chrono::steady_clock::time_point deadline_after(const std::chrono::duration<Rep, Period> &timeout)
+{
+  return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+}
+
+// An op that also waits in the timer wheel & completes with net::error::timed_out when it expires.
+// Base can be used to attach extra state to the op,
+// it needs to derive from basic_op<Signature> or predicate_op<Signature>.
+template <class Signature, class Base = basic_op<Signature>>
+struct timed_op;
+
+template <class Base, class... Ts>
+struct timed_op<void(error_code, Ts...), Base> : Base, timer_entry
+{
+  virtual void expire() override
+  {
+    Base::on_expire(this->owner);
+    this->complete(net::error::timed_out, Ts{}...);
+  }
+
+  virtual timer_entry *timer() noexcept override { return this; }
+
+  // The op models unlink the op when it completes or shuts down, so this takes it out of the timer wheel too.
+  void unlink()
+  {
+    if (this->armed)
+      this->service->remove_timer(this);
+    Base::unlink();
+  }
+};
+
+// A basic_op_model that also waits in the timer wheel.
+template <class Executor, class Handler, class Signature, class Base = basic_op<Signature>>
+using timed_op_model = basic_op_model<Executor, Handler, Signature, timed_op<Signature, Base>>;
+
+// A predicate_op_model that also waits in the timer wheel.
+template <class Executor, class Handler, class Predicate, class Signature>
+using timed_predicate_op_model =
+    predicate_op_model<Executor, Handler, Predicate, Signature, timed_op<Signature, predicate_op<Signature>>>;
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_DETAIL_TIMED_OP_MODEL_HPP
@@ -0,0 +1,91 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_DETAIL_TIMER_WHEEL_HPP
+#define BOOST_SAM_DETAIL_TIMER_WHEEL_HPP
+
+#include <boost/sam/detail/bilist_node.hpp>
+#include <boost/sam/detail/config.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+namespace detail
+{
+
+struct op_list_service;
+struct service_member;
+
+// A waiter with a deadline, linked into the timer_wheel of its op_list_service.
+struct timer_entry : bilist_node
+{
+  // Complete the waiter with net::error::timed_out. Called with the owner's mutex held.
+  virtual void expire() = 0;
+
+  op_list_service *service = nullptr;
+  service_member  *owner   = nullptr;
+  std::uint64_t    tick    = 0u;
+  unsigned         level   = 0u;
+  // Whether the service owns the entry. Only changes when the owner's & the service's mutex are both held.
+  bool             armed = false;
+};
+
+// A hierarchical timing wheel with millisecond ticks.
+// Level n holds entries expiring within 64^(n+1) ticks, and gets cascaded into the lower levels
+// whenever the current tick crosses one of its slots. Everything further out waits in an overflow list.
+struct timer_wheel
+{
+  using clock_type = std::chrono::steady_clock;
+
+  constexpr static unsigned    slot_bits = 6u;
+  constexpr static std::size_t slots     = std::size_t(1u) << slot_bits;
+  constexpr static unsigned    levels    = 4u;
+
+  // the level of entries that are not in one of the wheels.
+  constexpr static unsigned overflow = levels, due = levels + 1u, unlinked = levels + 2u;
+
+  BOOST_SAM_DECL timer_wheel();
+
+  // The first tick at or after tp.
+  BOOST_SAM_DECL std::uint64_t tick_of(clock_type::time_point tp) const;
+  clock_type::time_point       time_of(std::uint64_t tick) const { return origin_ + std::chrono::milliseconds(tick); }
+
+  // Link the entry according to its tick. Ticks in the past expire with the next advance.
+  BOOST_SAM_DECL void insert(timer_entry *entry);
+  // Unlink the entry from the wheel or from a due list.
+  BOOST_SAM_DECL void remove(timer_entry *entry);
+  // Move all entries that expired at `now` into the `expired` list.
+  BOOST_SAM_DECL void advance(clock_type::time_point now, bilist_node &expired);
+  // A lower bound for the next tick an advance can expire an entry at. Returns false if the wheel is empty.
+  BOOST_SAM_DECL bool next_tick(std::uint64_t &tick) const;
+
+  bool empty() const noexcept { return size_ == 0u; }
+
+  timer_wheel(const timer_wheel &)            = delete;
+  timer_wheel &operator=(const timer_wheel &) = delete;
+
+private:
+  BOOST_SAM_DECL void cascade(bilist_node &slot);
+
+  clock_type::time_point origin_;
+  // the next tick to be processed.
+  std::uint64_t          current_ = 0u;
+  std::size_t            size_    = 0u;
+  std::size_t            counts_[levels] = {};
+  bilist_node            wheel_[levels][slots];
+  bilist_node            overflow_;
+};
+
+} // namespace detail
+
+BOOST_SAM_END_NAMESPACE
+
+#if defined(BOOST_SAM_HEADER_ONLY)
+#include <boost/sam/detail/impl/timer_wheel.ipp>
+#endif
+
+#endif // BOOST_SAM_DETAIL_TIMER_WHEEL_HPP
@@ -55,6 +55,30 @@ guarded(basic_mutex<Executor> &mtx, Op &&op,
   return net::async_compose<CompletionToken, sig_t>(cop{mtx, std::forward<Op>(op)}, completion_token, mtx);
 }
 
+/** Function to run OPs only when the adaptive limiter hands out a permit.
+ *  The latency & outcome of the op get fed back into the limit.
+ *  Ops that complete with an error count as dropped, except for cancellation, which doesn't count at all.
+ *
+ *  @tparam Executor The executor of the limiter.
+ *  @tparam token The completion token
+ *
+ *  @param lim The limiter to guard the protection
+ *  @param op The operation to guard.
+ *  @param completion_token The completion token to use for the async completion.
+ */
+template <typename Executor, typename Op,
+          BOOST_SAM_COMPLETION_TOKEN_FOR(typename net::completion_signature_of<Op>::type)
+              CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(Executor)>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, typename net::completion_signature_of<Op>::type)
+guarded(basic_adaptive_limiter<Executor> &lim, Op &&op,
+        CompletionToken &&completion_token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(Executor))
+{
+  using op_t  = typename std::decay<Op>::type;
+  using sig_t = typename decltype(std::declval<op_t>()(net::detail::completion_signature_probe{}))::type;
+  using cop   = detail::guard_by_adaptive_limiter_op<Executor, op_t, sig_t>;
+  return net::async_compose<CompletionToken, sig_t>(cop{lim, std::forward<Op>(op)}, completion_token, lim);
+}
+
 BOOST_SAM_END_NAMESPACE
 
 #endif // BOOST_SAM_GUARDED_HPP
@@ -0,0 +1,21 @@
+//
+// Copyright (c) 2023 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_SAM_HIERARCHICAL_SEMAPHORE_HPP
+#define BOOST_SAM_HIERARCHICAL_SEMAPHORE_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/basic_hierarchical_semaphore.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/// basic_hierarchical_semaphore with default executor.
+using hierarchical_semaphore = basic_hierarchical_semaphore<>;
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_HIERARCHICAL_SEMAPHORE_HPP
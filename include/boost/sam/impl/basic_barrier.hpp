@@ -76,6 +76,54 @@ struct basic_barrier<Executor>::async_arrive_op
   }
 };
 
+template <class Executor>
+struct basic_barrier<Executor>::async_arrive_until_op
+{
+  basic_barrier<Executor>              *self;
+  std::chrono::steady_clock::time_point deadline;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+
+    if (self->impl_.try_arrive())
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    self->impl_.decrement();
+    ignore_unused(l);
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type =
+        detail::timed_op_model<decltype(e), handler_type, void(error_code), detail::barrier_timed_wait_op>;
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock{impl.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+            }
+          });
+    }
+
+    // the arrival gets withdrawn by barrier_timed_wait_op::on_expire
+    self->impl_.add_waiter(model);
+    self->impl_.service->add_timer(model, &self->impl_, deadline, self->get_executor());
+  }
+};
+
 BOOST_SAM_END_NAMESPACE
 
 #endif
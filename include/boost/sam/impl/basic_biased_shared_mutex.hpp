@@ -0,0 +1,113 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_IMPL_BASIC_BIASED_SHARED_MUTEX_HPP
+#define BOOST_SAM_IMPL_BASIC_BIASED_SHARED_MUTEX_HPP
+
+#include <boost/sam/basic_biased_shared_mutex.hpp>
+#include <boost/sam/detail/basic_op_model.hpp>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/associated_immediate_executor.hpp>
+#include <asio/dispatch.hpp>
+#else
+#include <boost/asio/associated_immediate_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+template <class Executor>
+struct basic_biased_shared_mutex<Executor>::async_lock_op
+{
+  basic_biased_shared_mutex<Executor> *self;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code)>;
+    // constructed up front, since even an uncontended lock might have to wait for the readers to drain.
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+    if (self->impl_.lock_or_add_waiter(model))
+    {
+      model->complete(error_code());
+      return;
+    }
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              auto &mtx = impl;
+              detail::op_list_service::lock_type lock{mtx.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+              mtx.on_writer_cancelled();
+            }
+          });
+    }
+  }
+};
+
+template <class Executor>
+struct basic_biased_shared_mutex<Executor>::async_lock_shared_op
+{
+  basic_biased_shared_mutex<Executor> *self;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    // the fast path doesn't touch the mutex at all.
+    if (self->impl_.try_lock_shared_fast())
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code)>;
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+    if (self->impl_.lock_shared_or_add_waiter(model))
+    {
+      model->complete(error_code());
+      return;
+    }
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock{impl.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+            }
+          });
+    }
+  }
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_IMPL_BASIC_BIASED_SHARED_MUTEX_HPP
@@ -7,6 +7,7 @@
 
 #include <boost/sam/basic_condition_variable.hpp>
 #include <boost/sam/detail/predicate_op_model.hpp>
+#include <boost/sam/detail/timed_op_model.hpp>
 
 BOOST_SAM_BEGIN_NAMESPACE
 
@@ -100,6 +101,48 @@ struct basic_condition_variable<Executor>::async_wait_op
   }
 };
 
+template <class Executor>
+template <class Predicate>
+struct basic_condition_variable<Executor>::async_predicate_wait_until_op
+{
+  basic_condition_variable<Executor>   *self;
+  Predicate                             predicate;
+  std::chrono::steady_clock::time_point deadline;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    using handler_type   = typename std::decay<Handler>::type;
+    using predicate_type = Predicate;
+    using model_type = detail::timed_predicate_op_model<decltype(e), handler_type, predicate_type, void(error_code)>;
+    model_type *model = model_type::construct(std::move(e), std::forward<Handler>(handler), std::move(predicate));
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock{impl.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+            }
+          });
+    }
+
+    self->impl_.add_waiter(model);
+    self->impl_.service->add_timer(model, &self->impl_, deadline, self->get_executor());
+  }
+};
+
 BOOST_SAM_END_NAMESPACE
 
 #endif // BOOST_SAM_IMPL_BASIC_CONDITION_VARIABLE_HPP
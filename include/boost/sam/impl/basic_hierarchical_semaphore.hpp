@@ -0,0 +1,64 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_IMPL_BASIC_HIERARCHICAL_SEMAPHORE_HPP
+#define BOOST_SAM_IMPL_BASIC_HIERARCHICAL_SEMAPHORE_HPP
+
+#include <boost/sam/basic_hierarchical_semaphore.hpp>
+#include <boost/sam/detail/basic_op_model.hpp>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/associated_immediate_executor.hpp>
+#include <asio/dispatch.hpp>
+#else
+#include <boost/asio/associated_immediate_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+template <class Executor>
+struct basic_hierarchical_semaphore<Executor>::async_acquire_op
+{
+  basic_hierarchical_semaphore<Executor> *self;
+  node_id                                 node;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    if (self->impl_.try_acquire_locked(node))
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code), detail::hierarchical_wait_op>;
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock{impl.mtx_};
+              ignore_unused(lock);
+              impl.cancel_waiter(model, net::error::operation_aborted);
+            }
+          });
+    }
+    self->impl_.add_waiter(model, node);
+  }
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_IMPL_BASIC_HIERARCHICAL_SEMAPHORE_HPP
@@ -12,6 +12,7 @@
 
 #include <boost/sam/basic_mutex.hpp>
 #include <boost/sam/detail/basic_op_model.hpp>
+#include <boost/sam/detail/timed_op_model.hpp>
 
 #if defined(BOOST_SAM_STANDALONE)
 #include <asio/deferred.hpp>
@@ -29,6 +30,7 @@ template <class Executor>
 struct basic_mutex<Executor>::async_lock_op
 {
   basic_mutex<Executor> *self;
+  std::size_t            priority;
 
   template <class Handler>
   void operator()(Handler &&handler)
@@ -47,6 +49,49 @@ struct basic_mutex<Executor>::async_lock_op
     using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code)>;
     model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
 
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock{impl.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+            }
+          });
+    }
+    self->impl_.add_waiter(model, priority);
+  }
+};
+
+template <class Executor>
+struct basic_mutex<Executor>::async_lock_until_op
+{
+  basic_mutex<Executor>                *self;
+  std::chrono::steady_clock::time_point deadline;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    if (!self->impl_.locked_)
+    {
+      self->impl_.locked_ = true;
+      auto ie             = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::timed_op_model<decltype(e), handler_type, void(error_code)>;
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+
     auto slot = model->get_cancellation_slot();
     if (slot.is_connected())
     {
@@ -64,6 +109,49 @@ struct basic_mutex<Executor>::async_lock_op
           });
     }
     self->impl_.add_waiter(model);
+    self->impl_.service->add_timer(model, &self->impl_, deadline, self->get_executor());
+  }
+};
+
+template <class Executor>
+struct basic_mutex<Executor>::async_yield_op
+{
+  basic_mutex<Executor> *self;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    // nobody to yield to, so we keep the lock.
+    if (self->impl_.waiters_.empty())
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code)>;
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock{impl.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+            }
+          });
+    }
+    self->impl_.yield(model);
   }
 };
 
@@ -0,0 +1,126 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_IMPL_BASIC_RANGE_LOCK_HPP
+#define BOOST_SAM_IMPL_BASIC_RANGE_LOCK_HPP
+
+#include <boost/sam/basic_range_lock.hpp>
+#include <boost/sam/detail/basic_op_model.hpp>
+#include <boost/sam/detail/timed_op_model.hpp>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/associated_immediate_executor.hpp>
+#include <asio/dispatch.hpp>
+#else
+#include <boost/asio/associated_immediate_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+template <class Executor>
+struct basic_range_lock<Executor>::async_lock_op
+{
+  basic_range_lock<Executor> *self;
+  std::uint64_t               begin, end;
+  bool                        shared;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    if (self->impl_.try_acquire(begin, end, shared))
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type = detail::basic_op_model<decltype(e), handler_type, void(error_code), detail::range_wait_op>;
+    model_type *model = model_type::construct(std::move(e), std::forward<Handler>(handler));
+    model->begin      = begin;
+    model->end        = end;
+    model->shared     = shared;
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              auto &mtx = impl;
+              detail::op_list_service::lock_type lock{mtx.mtx_};
+              ignore_unused(lock);
+              auto      *self  = model;
+              const auto begin = self->begin, end = self->end;
+              self->complete(net::error::operation_aborted);
+              // the waiters behind it might have been blocked by it only.
+              mtx.process(begin, end);
+            }
+          });
+    }
+    self->impl_.add_waiter(model);
+  }
+};
+
+template <class Executor>
+struct basic_range_lock<Executor>::async_lock_until_op
+{
+  basic_range_lock<Executor>           *self;
+  std::uint64_t                         begin, end;
+  bool                                  shared;
+  std::chrono::steady_clock::time_point deadline;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    if (self->impl_.try_acquire(begin, end, shared))
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type = detail::timed_op_model<decltype(e), handler_type, void(error_code), detail::range_timed_wait_op>;
+    model_type *model = model_type::construct(std::move(e), std::forward<Handler>(handler));
+    model->begin      = begin;
+    model->end        = end;
+    model->shared     = shared;
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              auto &mtx = impl;
+              detail::op_list_service::lock_type lock{mtx.mtx_};
+              ignore_unused(lock);
+              auto      *self  = model;
+              const auto begin = self->begin, end = self->end;
+              self->complete(net::error::operation_aborted);
+              mtx.process(begin, end);
+            }
+          });
+    }
+    // a timeout lets the waiters overlapping this op in through on_timeout.
+    self->impl_.add_waiter(model);
+    self->impl_.service->add_timer(model, &self->impl_, deadline, self->get_executor());
+  }
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_IMPL_BASIC_RANGE_LOCK_HPP
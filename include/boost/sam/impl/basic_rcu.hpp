@@ -0,0 +1,59 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_IMPL_BASIC_RCU_HPP
+#define BOOST_SAM_IMPL_BASIC_RCU_HPP
+
+#include <boost/sam/basic_rcu.hpp>
+#include <boost/sam/detail/basic_op_model.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+template <typename T, class Executor>
+struct basic_rcu<T, Executor>::async_synchronize_op
+{
+  basic_rcu<T, Executor> *self;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code)>;
+    // constructed up front, since the grace period it starts might end right away.
+    model_type     *model     = model_type::construct(std::move(e), std::forward<Handler>(handler));
+    detail::rcu_node *reclaimed = nullptr;
+    if (self->impl_.synchronize_or_add_waiter(model, reclaimed))
+    {
+      model->complete(error_code());
+      l.unlock();
+      detail::rcu_impl::reclaim(reclaimed);
+      return;
+    }
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock{impl.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+            }
+          });
+    }
+  }
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_IMPL_BASIC_RCU_HPP
@@ -15,10 +15,12 @@
 
 #if defined(BOOST_SAM_STANDALONE)
 #include <asio/associated_immediate_executor.hpp>
+#include <asio/compose.hpp>
 #include <asio/dispatch.hpp>
 #include <asio/post.hpp>
 #else
 #include <boost/asio/associated_immediate_executor.hpp>
+#include <boost/asio/compose.hpp>
 #include <boost/asio/dispatch.hpp>
 #include <boost/asio/post.hpp>
 #endif
@@ -41,45 +43,111 @@ template <class Executor>
 struct basic_semaphore<Executor>::async_aquire_op
 {
   basic_semaphore<Executor> *self;
+  std::size_t                priority;
+  int                        weight;
 
   template <class Handler>
   void operator()(Handler &&handler)
   {
     auto e = get_associated_executor(handler, self->get_executor());
+    if (self->impl_.try_acquire_uncontended(weight))
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+      return;
+    }
+
     detail::op_list_service::lock_type l{self->impl_.mtx_};
     ignore_unused(l);
-    if (self->impl_.count() > 0)
+    if (self->impl_.try_acquire_locked(weight))
     {
-      self->impl_.decrement();
       auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
       net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
       return;
     }
+    if (self->impl_.shed_on_enqueue())
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code{net::error::try_again}));
+      return;
+    }
 
     using handler_type = typename std::decay<Handler>::type;
-    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code)>;
+    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code), detail::semaphore_wait_op>;
     model_type *model  = model_type ::construct(std::move(e), std::forward<Handler>(handler));
+    model->weight      = weight;
     auto        slot   = model->get_cancellation_slot();
     if (slot.is_connected())
     {
       auto &impl = self->impl_;
       slot.assign(
-          [model, &impl, slot](net::cancellation_type type)
+          [model, &impl](net::cancellation_type type)
           {
             if (type != net::cancellation_type::none)
             {
-              auto sl   = slot;
               detail::op_list_service::lock_type lock {impl.mtx_};
               ignore_unused(lock);
-              // completed already
-              if (!sl.is_connected())
-                return;
+              impl.cancel_waiter(model, net::error::operation_aborted);
+            }
+          });
+    }
+    self->impl_.add_waiter(model, priority);
+  }
+};
+
+template <class Executor>
+struct basic_semaphore<Executor>::async_aquire_until_op
+{
+  basic_semaphore<Executor>            *self;
+  std::chrono::steady_clock::time_point deadline;
 
-              auto *self = model;
-              self->complete(net::error::operation_aborted);
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    if (self->impl_.try_acquire_uncontended(1))
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+      return;
+    }
+
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+    if (self->impl_.try_acquire_locked(1))
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+      return;
+    }
+    if (self->impl_.shed_on_enqueue(deadline))
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code{net::error::try_again}));
+      return;
+    }
+
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::timed_op_model<decltype(e), handler_type, void(error_code), detail::semaphore_timed_wait_op>;
+    model_type *model  = model_type ::construct(std::move(e), std::forward<Handler>(handler));
+    auto        slot   = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock {impl.mtx_};
+              ignore_unused(lock);
+              impl.cancel_waiter(model, net::error::operation_aborted);
             }
           });
     }
+    model->deadline = deadline;
+    // the waiter might complete right away, which disarms the timer again.
+    self->impl_.service->add_timer(model, &self->impl_, deadline, self->get_executor());
     self->impl_.add_waiter(model);
   }
 };
@@ -87,9 +155,117 @@ struct basic_semaphore<Executor>::async_aquire_op
 template <class Executor>
 template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code)) CompletionHandler>
 BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code))
-basic_semaphore<Executor>::async_acquire(CompletionHandler &&token)
+basic_semaphore<Executor>::async_acquire(
+    CompletionHandler &&token,
+    typename std::enable_if<!std::is_integral<typename std::decay<CompletionHandler>::type>::value>::type *)
+{
+  return net::async_initiate<CompletionHandler, void(std::error_code)>(async_aquire_op{this, 0u, 1}, token);
+}
+
+template <class Executor>
+template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code)) CompletionHandler>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code))
+basic_semaphore<Executor>::async_acquire(std::size_t priority, CompletionHandler &&token)
+{
+  return net::async_initiate<CompletionHandler, void(std::error_code)>(async_aquire_op{this, priority, 1}, token);
+}
+
+template <class Executor>
+template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code)) CompletionHandler>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code))
+basic_semaphore<Executor>::async_acquire_n(int n, CompletionHandler &&token)
+{
+  BOOST_SAM_ASSERT(n > 0);
+  return net::async_initiate<CompletionHandler, void(std::error_code)>(async_aquire_op{this, 0u, n}, token);
+}
+
+template <class Executor>
+struct basic_semaphore<Executor>::async_aquire_up_to_op
+{
+  basic_semaphore<Executor> *self;
+  int                        n;
+
+  template <typename Self>
+  void operator()(Self &&s)
+  {
+    self->async_acquire_n(1, std::move(s));
+  }
+
+  template <typename Self>
+  void operator()(Self &&s, error_code ec)
+  {
+    if (ec)
+      return s.complete(ec, 0);
+
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    const auto taken = 1 + self->impl_.take_up_to(n - 1);
+    l.unlock();
+    s.complete(ec, taken);
+  }
+};
+
+template <class Executor>
+template <BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code, int)) CompletionHandler>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code, int))
+basic_semaphore<Executor>::async_acquire_up_to(int n, CompletionHandler &&token)
+{
+  BOOST_SAM_ASSERT(n > 0);
+  return net::async_compose<CompletionHandler, void(error_code, int)>(async_aquire_up_to_op{this, n}, token, exec_);
+}
+
+template <class Executor>
+template <typename Clock, typename Duration, BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code)) CompletionHandler>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code))
+basic_semaphore<Executor>::async_acquire_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                                               CompletionHandler                             &&token)
+{
+  return net::async_initiate<CompletionHandler, void(std::error_code)>(
+      async_aquire_until_op{this, detail::to_steady_time(deadline)}, token);
+}
+
+template <class Executor>
+template <typename Rep, typename Period, BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code)) CompletionHandler>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code))
+basic_semaphore<Executor>::async_acquire_for(const std::chrono::duration<Rep, Period> &timeout,
+                                             CompletionHandler                       &&token)
+{
+  return net::async_initiate<CompletionHandler, void(std::error_code)>(
+      async_aquire_until_op{this, detail::deadline_after(timeout)}, token);
+}
+
+template <class Executor>
+struct basic_semaphore<Executor>::async_aquire_lease_op
+{
+  basic_semaphore<Executor>          *self;
+  std::chrono::steady_clock::duration ttl;
+
+  template <typename Self>
+  void operator()(Self &&s)
+  {
+    self->async_acquire(std::move(s));
+  }
+
+  template <typename Self>
+  void operator()(Self &&s, error_code ec)
+  {
+    if (ec)
+      return s.complete(ec, semaphore_lease());
+
+    const auto id = self->impl_.add_lease(ttl, self->exec_);
+    s.complete(ec, semaphore_lease(self->impl_, id));
+  }
+};
+
+template <class Executor>
+template <typename Rep, typename Period,
+          BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code, semaphore_lease)) CompletionHandler>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionHandler, void(error_code, semaphore_lease))
+basic_semaphore<Executor>::async_acquire_lease(const std::chrono::duration<Rep, Period> &ttl,
+                                               CompletionHandler                       &&token)
 {
-  return net::async_initiate<CompletionHandler, void(std::error_code)>(async_aquire_op{this}, token);
+  return net::async_compose<CompletionHandler, void(error_code, semaphore_lease)>(
+      async_aquire_lease_op{this, std::chrono::duration_cast<std::chrono::steady_clock::duration>(ttl)}, token,
+      exec_);
 }
 
 BOOST_SAM_END_NAMESPACE
@@ -10,6 +10,7 @@
 
 #include <boost/sam/basic_shared_mutex.hpp>
 #include <boost/sam/detail/basic_op_model.hpp>
+#include <boost/sam/detail/timed_op_model.hpp>
 
 #if defined(BOOST_SAM_STANDALONE)
 #include <asio/deferred.hpp>
@@ -35,7 +36,7 @@ struct basic_shared_mutex<Executor>::async_lock_op
     detail::op_list_service::lock_type l{self->impl_.mtx_};
     ignore_unused(l);
 
-    if (!self->impl_.locked_ && self->impl_.locked_shared_ == 0u)
+    if (self->impl_.can_lock())
     {
       self->impl_.locked_ = true;
       auto ie             = net::get_associated_immediate_executor(handler, self->get_executor());
@@ -54,10 +55,14 @@ struct basic_shared_mutex<Executor>::async_lock_op
           {
             if (type != net::cancellation_type::none)
             {
-              detail::op_list_service::lock_type lock{impl.mtx_};
+              // completing destroys this handler, so the captures can't be used afterwards.
+              auto &mtx = impl;
+              detail::op_list_service::lock_type lock{mtx.mtx_};
               ignore_unused(lock);
               auto *self = model;
               self->complete(net::error::operation_aborted);
+              // shared waiters might be parked behind this op
+              mtx.admit_shared_waiters();
             }
           });
     }
@@ -66,6 +71,53 @@ struct basic_shared_mutex<Executor>::async_lock_op
 };
 
 
+template <class Executor>
+struct basic_shared_mutex<Executor>::async_lock_until_op
+{
+  basic_shared_mutex<Executor>         *self;
+  std::chrono::steady_clock::time_point deadline;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    if (self->impl_.can_lock())
+    {
+      self->impl_.locked_ = true;
+      auto ie             = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::timed_op_model<decltype(e), handler_type, void(error_code)>;
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              auto &mtx = impl;
+              detail::op_list_service::lock_type lock{mtx.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+              mtx.admit_shared_waiters();
+            }
+          });
+    }
+    // a timeout admits the shared waiters parked behind this op through on_timeout.
+    self->impl_.add_waiter(model);
+    self->impl_.service->add_timer(model, &self->impl_, deadline, self->get_executor());
+  }
+};
+
 template <class Executor>
 struct basic_shared_mutex<Executor>::async_lock_shared_op
 {
@@ -78,7 +130,7 @@ struct basic_shared_mutex<Executor>::async_lock_shared_op
     detail::op_list_service::lock_type l{self->impl_.mtx_};
     ignore_unused(l);
 
-    if (!self->impl_.locked_)
+    if (self->impl_.can_lock_shared())
     {
       self->impl_.locked_shared_ ++;
       auto ie             = net::get_associated_immediate_executor(handler, self->get_executor());
@@ -108,6 +160,222 @@ struct basic_shared_mutex<Executor>::async_lock_shared_op
   }
 };
 
+template <class Executor>
+struct basic_shared_mutex<Executor>::async_lock_shared_until_op
+{
+  basic_shared_mutex<Executor>         *self;
+  std::chrono::steady_clock::time_point deadline;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    if (self->impl_.can_lock_shared())
+    {
+      self->impl_.locked_shared_++;
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::timed_op_model<decltype(e), handler_type, void(error_code)>;
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock{impl.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+            }
+          });
+    }
+    self->impl_.add_shared_waiter(model);
+    self->impl_.service->add_timer(model, &self->impl_, deadline, self->get_executor());
+  }
+};
+
+template <class Executor>
+struct basic_shared_mutex<Executor>::async_yield_op
+{
+  basic_shared_mutex<Executor> *self;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    auto &impl = self->impl_;
+    // nobody to yield to, so we keep the lock.
+    if (impl.waiters_.empty() && impl.shared_waiters_.next_ == &impl.shared_waiters_ &&
+        impl.upgrade_waiters_.next_ == &impl.upgrade_waiters_)
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code)>;
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              auto &mtx = impl;
+              detail::op_list_service::lock_type lock{mtx.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+              mtx.admit_shared_waiters();
+            }
+          });
+    }
+    impl.yield(model);
+  }
+};
+
+template <class Executor>
+struct basic_shared_mutex<Executor>::async_relock_shared_op
+{
+  basic_shared_mutex<Executor> *self;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    auto &impl = self->impl_;
+    // no writer is waiting, so we keep the shared lock.
+    if (impl.waiters_.empty())
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code)>;
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock{impl.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+            }
+          });
+    }
+    impl.relock_shared(model);
+  }
+};
+
+template <class Executor>
+struct basic_shared_mutex<Executor>::async_lock_upgrade_op
+{
+  basic_shared_mutex<Executor> *self;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    if (self->impl_.can_lock_upgrade())
+    {
+      self->impl_.upgrade_locked_ = true;
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code)>;
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock{impl.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+            }
+          });
+    }
+    self->impl_.add_upgrade_waiter(model);
+  }
+};
+
+template <class Executor>
+struct basic_shared_mutex<Executor>::async_upgrade_op
+{
+  basic_shared_mutex<Executor> *self;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto e = get_associated_executor(handler, self->get_executor());
+    detail::op_list_service::lock_type l{self->impl_.mtx_};
+    ignore_unused(l);
+
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code)>;
+    // constructed up front, since the upgrade holds back new readers even if it has to wait.
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+    if (self->impl_.upgrade_or_add_waiter(model))
+    {
+      model->complete(error_code());
+      return;
+    }
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+    {
+      auto &impl = self->impl_;
+      slot.assign(
+          [model, &impl](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              auto &mtx = impl;
+              detail::op_list_service::lock_type lock{mtx.mtx_};
+              ignore_unused(lock);
+              auto *self = model;
+              self->complete(net::error::operation_aborted);
+              mtx.cancel_upgrade();
+            }
+          });
+    }
+  }
+};
+
 BOOST_SAM_END_NAMESPACE
 
 #endif // BOOST_SAM_DETAIL_BASIC_SHARED_MUTEX_HPP
@@ -0,0 +1,93 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_IMPL_BASIC_STRIPED_MUTEX_HPP
+#define BOOST_SAM_IMPL_BASIC_STRIPED_MUTEX_HPP
+
+#include <boost/sam/basic_striped_mutex.hpp>
+#include <boost/sam/detail/basic_op_model.hpp>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/associated_immediate_executor.hpp>
+#include <asio/dispatch.hpp>
+#else
+#include <boost/asio/associated_immediate_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+template <std::size_t Stripes, class Executor>
+struct basic_striped_mutex<Stripes, Executor>::async_lock_op
+{
+  basic_striped_mutex<Stripes, Executor> *self;
+  std::size_t                             index;
+
+  template <class Handler>
+  void operator()(Handler &&handler)
+  {
+    auto  e  = get_associated_executor(handler, self->get_executor());
+    auto &st = self->impl_.get(index);
+    detail::op_list_service::lock_type l{st.mtx};
+    ignore_unused(l);
+
+    if (self->impl_.try_acquire(st))
+    {
+      auto ie = net::get_associated_immediate_executor(handler, self->get_executor());
+      return net::dispatch(ie, net::append(std::forward<Handler>(handler), error_code()));
+    }
+    using handler_type = typename std::decay<Handler>::type;
+    using model_type   = detail::basic_op_model<decltype(e), handler_type, void(error_code)>;
+    model_type *model  = model_type::construct(std::move(e), std::forward<Handler>(handler));
+
+    auto slot = model->get_cancellation_slot();
+    if (slot.is_connected())
+      slot.assign(
+          [model, &st](net::cancellation_type type)
+          {
+            if (type != net::cancellation_type::none)
+            {
+              detail::op_list_service::lock_type lock{st.mtx};
+              ignore_unused(lock);
+              model->complete(net::error::operation_aborted);
+            }
+          });
+    self->impl_.add_waiter(st, model);
+  }
+};
+
+template <std::size_t Stripes, class Executor>
+template <std::size_t Size>
+struct basic_striped_mutex<Stripes, Executor>::async_lock_all_op
+{
+  basic_striped_mutex<Stripes, Executor> *self;
+  std::array<std::size_t, Size>           stripes;
+  std::size_t                             count = 0u, locked = 0u;
+
+  template <typename Self>
+  void operator()(Self &&s)
+  {
+    count = detail::order_stripes(stripes);
+    async_lock_op{self, stripes[0u]}(std::move(s));
+  }
+
+  template <typename Self>
+  void operator()(Self &&s, error_code ec)
+  {
+    if (ec)
+    {
+      while (locked > 0u)
+        self->impl_.unlock(stripes[--locked]);
+      return s.complete(ec);
+    }
+
+    if (++locked == count)
+      return s.complete(error_code());
+    async_lock_op{self, stripes[locked]}(std::move(s));
+  }
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_IMPL_BASIC_STRIPED_MUTEX_HPP
@@ -0,0 +1,22 @@
+//
+// Copyright (c) 2023 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_SAM_KEYED_MUTEX_HPP
+#define BOOST_SAM_KEYED_MUTEX_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/basic_keyed_mutex.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/// basic_keyed_mutex with default executor.
+template <typename Key>
+using keyed_mutex = basic_keyed_mutex<Key>;
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_KEYED_MUTEX_HPP
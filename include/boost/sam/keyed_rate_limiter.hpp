@@ -0,0 +1,22 @@
+//
+// Copyright (c) 2023 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_SAM_KEYED_RATE_LIMITER_HPP
+#define BOOST_SAM_KEYED_RATE_LIMITER_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/basic_keyed_rate_limiter.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/// basic_keyed_rate_limiter with default executor.
+template <typename Key>
+using keyed_rate_limiter = basic_keyed_rate_limiter<Key>;
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_KEYED_RATE_LIMITER_HPP
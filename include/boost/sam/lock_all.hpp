@@ -0,0 +1,126 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef BOOST_SAM_LOCK_ALL_HPP
+#define BOOST_SAM_LOCK_ALL_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/lock_all.hpp>
+#include <boost/sam/basic_mutex.hpp>
+#include <boost/sam/basic_semaphore.hpp>
+#include <boost/sam/basic_shared_mutex.hpp>
+
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/async_result.hpp>
+#include <asio/compose.hpp>
+#else
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/compose.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/** A guard used as an RAII object that releases multiple primitives on destruction.
+ *
+ * To use with async_guard_all.
+ */
+template <typename... Lockables>
+struct multi_lock_guard
+{
+  /// Construct an empty multi_lock_guard.
+  multi_lock_guard()                         = default;
+  multi_lock_guard(const multi_lock_guard &) = delete;
+  multi_lock_guard(multi_lock_guard &&lhs) : lockables_(lhs.lockables_), owns_(lhs.owns_) { lhs.owns_ = false; }
+
+  multi_lock_guard &operator=(const multi_lock_guard &) = delete;
+  multi_lock_guard &operator=(multi_lock_guard &&lhs)
+  {
+    std::swap(lhs.lockables_, lockables_);
+    std::swap(lhs.owns_, owns_);
+    return *this;
+  }
+
+  /// Release all the underlying primitives.
+  ~multi_lock_guard()
+  {
+    if (owns_)
+      for (std::size_t i = 0u; i < sizeof...(Lockables); i++)
+        detail::visit_lockable(lockables_, i, detail::unlock_one_t{});
+  }
+
+  /// Adopt primitives that are already held.
+  multi_lock_guard(Lockables &...lockables, const std::adopt_lock_t &) : lockables_(&lockables...), owns_(true) {}
+
+  multi_lock_guard(const std::tuple<Lockables *...> &lockables, const std::adopt_lock_t &)
+      : lockables_(lockables), owns_(true)
+  {
+  }
+
+private:
+  std::tuple<Lockables *...> lockables_;
+  bool                       owns_ = false;
+};
+
+/** Acquire multiple primitives at once, without risking deadlocks.
+ *
+ * The primitives can be mutexes, shared_mutexes (locked exclusively) or semaphores.
+ * This never waits while holding any of them: if a primitive is taken,
+ * everything acquired so far gets released and the op waits for the blocking primitive only.
+ * Once that's acquired it tries to take the rest again, in a global order.
+ *
+ * On success, all primitives are held, on error none are.
+ * Each primitive must only be passed once.
+ *
+ * @param token The Completion Token.
+ * @param lockables The primitives to acquire.
+ *
+ * @returns The async_result deduced from the token.
+ *
+ * @example
+ * @code{.cpp}
+ *
+ * awaitable<void> transfer(mutex & from, mutex & to, semaphore & sem)
+ * {
+ *   co_await async_lock_all(use_awaitable, from, to, sem);
+ *   // do work
+ *   from.unlock();
+ *   to.unlock();
+ *   sem.release();
+ * }
+ *
+ * @endcode
+ */
+template <typename CompletionToken, typename Lockable, typename... Lockables>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code))
+async_lock_all(CompletionToken &&token, Lockable &lockable, Lockables &...lockables)
+{
+  return net::async_compose<CompletionToken, void(error_code)>(
+      detail::lock_all_op<void, Lockable, Lockables...>{lockable, lockables...}, token, lockable, lockables...);
+}
+
+/** Acquire multiple primitives at once & return a guard releasing them.
+ *
+ * Works like async_lock_all, but completes with a multi_lock_guard.
+ *
+ * @param token The Completion Token.
+ * @param lockables The primitives to acquire.
+ *
+ * @returns The async_result deduced from the token.
+ */
+template <typename CompletionToken, typename Lockable, typename... Lockables>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code, multi_lock_guard<Lockable, Lockables...>))
+async_guard_all(CompletionToken &&token, Lockable &lockable, Lockables &...lockables)
+{
+  using guard_type = multi_lock_guard<Lockable, Lockables...>;
+  return net::async_compose<CompletionToken, void(error_code, guard_type)>(
+      detail::lock_all_op<guard_type, Lockable, Lockables...>{lockable, lockables...}, token, lockable, lockables...);
+}
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_LOCK_ALL_HPP
@@ -29,6 +29,11 @@ struct basic_mutex;
 template <typename Executor>
 struct basic_shared_mutex;
 
+template <typename T, typename Executor>
+struct basic_seqlock;
+
+struct shared_lock_guard;
+
 /** A lock-guard used as an RAII object that automatically unlocks on destruction
  *
  * To use with with async_clock.
@@ -64,7 +69,15 @@ struct lock_guard
   {
   }
 
+  template <typename T, typename Executor>
+  lock_guard(basic_seqlock<T, Executor> &mtx, const std::adopt_lock_t &) : mtx_(&mtx.impl_)
+  {
+  }
+
 private:
+  template <typename Executor>
+  friend shared_lock_guard downgrade(basic_shared_mutex<Executor> &mtx, lock_guard &&lock);
+
   detail::mutex_impl *mtx_ = nullptr;
 };
 
@@ -118,6 +131,23 @@ lock_guard lock(basic_shared_mutex<Executor> &mtx, error_code &ec)
     return lock_guard(mtx, std::adopt_lock);
 }
 
+template <typename T, typename Executor>
+lock_guard lock(basic_seqlock<T, Executor> &mtx)
+{
+  mtx.lock();
+  return lock_guard(mtx, std::adopt_lock);
+}
+
+template <typename T, typename Executor>
+lock_guard lock(basic_seqlock<T, Executor> &mtx, error_code &ec)
+{
+  mtx.lock(ec);
+  if (ec)
+    return lock_guard();
+  else
+    return lock_guard(mtx, std::adopt_lock);
+}
+
 namespace detail
 {
 
@@ -197,6 +227,20 @@ async_lock(basic_shared_mutex<Executor> &mtx, CompletionToken &&token BOOST_SAM_
       );
 }
 
+template <typename T, typename Executor,
+          BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code, lock_guard))
+              CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(Executor)>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code, lock_guard))
+async_lock(basic_seqlock<T, Executor> &mtx, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(Executor))
+{
+  return net::async_compose<
+      CompletionToken, void(error_code, lock_guard)>
+      (
+          detail::async_lock_op<basic_seqlock<T, Executor>>{mtx},
+          token, mtx
+      );
+}
+
 BOOST_SAM_END_NAMESPACE
 
 #endif // BOOST_SAM_LOCK_GUARD_HPP
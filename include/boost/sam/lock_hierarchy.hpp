@@ -0,0 +1,21 @@
+//
+// Copyright (c) 2023 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_SAM_LOCK_HIERARCHY_HPP
+#define BOOST_SAM_LOCK_HIERARCHY_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/basic_lock_hierarchy.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/// basic_lock_hierarchy with default executor.
+using lock_hierarchy = basic_lock_hierarchy<>;
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_LOCK_HIERARCHY_HPP
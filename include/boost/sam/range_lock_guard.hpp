@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2023 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_SAM_RANGE_LOCK_GUARD_HPP
+#define BOOST_SAM_RANGE_LOCK_GUARD_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/range_lock_impl.hpp>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/async_result.hpp>
+#include <asio/compose.hpp>
+#include <asio/deferred.hpp>
+
+#else
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/deferred.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+template <typename Executor>
+struct basic_range_lock;
+
+/** A lock-guard used as an RAII object that automatically unlocks a range on destruction
+ *
+ * To use with with async_lock & async_lock_shared on a range lock.
+ */
+struct range_lock_guard
+{
+  /// Construct an empty range_lock_guard.
+  range_lock_guard() = default;
+  range_lock_guard(const range_lock_guard &) = delete;
+  range_lock_guard(range_lock_guard &&lhs)
+      : mtx_(lhs.mtx_), begin_(lhs.begin_), end_(lhs.end_), shared_(lhs.shared_)
+  {
+    lhs.mtx_ = nullptr;
+  }
+
+  range_lock_guard &operator=(const range_lock_guard &) = delete;
+  range_lock_guard &operator=(range_lock_guard &&lhs)
+  {
+    std::swap(lhs.mtx_, mtx_);
+    std::swap(lhs.begin_, begin_);
+    std::swap(lhs.end_, end_);
+    std::swap(lhs.shared_, shared_);
+    return *this;
+  }
+
+  /// Unlock the range.
+  ~range_lock_guard()
+  {
+    if (mtx_ != nullptr)
+      mtx_->unlock(begin_, end_, shared_);
+  }
+
+  /// Adopt an exclusive lock of the range.
+  template <typename Executor>
+  range_lock_guard(basic_range_lock<Executor> &mtx, std::uint64_t offset, std::uint64_t length,
+                   const std::adopt_lock_t &)
+      : mtx_(&mtx.impl_), begin_(offset), end_(offset + length), shared_(false)
+  {
+  }
+
+  /// Adopt a lock of the range, which is shared if `shared` is true.
+  template <typename Executor>
+  range_lock_guard(basic_range_lock<Executor> &mtx, std::uint64_t offset, std::uint64_t length, bool shared,
+                   const std::adopt_lock_t &)
+      : mtx_(&mtx.impl_), begin_(offset), end_(offset + length), shared_(shared)
+  {
+  }
+
+  /// The start of the locked range.
+  std::uint64_t offset() const noexcept { return begin_; }
+  /// The length of the locked range.
+  std::uint64_t length() const noexcept { return end_ - begin_; }
+  /// Whether the range is locked shared.
+  bool shared() const noexcept { return shared_; }
+
+private:
+  detail::range_lock_impl *mtx_    = nullptr;
+  std::uint64_t            begin_  = 0u;
+  std::uint64_t            end_    = 0u;
+  bool                     shared_ = false;
+};
+
+/** Lock a range exclusively & acquire a range_lock_guard synchronously.
+ *
+ * @param mtx The range lock.
+ * @param offset The start of the range.
+ * @param length The length of the range.
+ *
+ * @returns The range_lock_guard.
+ *
+ * @throws May throw a system_error if locking is not possible without a deadlock.
+ */
+template <typename Executor>
+range_lock_guard lock(basic_range_lock<Executor> &mtx, std::uint64_t offset, std::uint64_t length)
+{
+  mtx.lock(offset, length);
+  return range_lock_guard(mtx, offset, length, std::adopt_lock);
+}
+
+template <typename Executor>
+range_lock_guard lock(basic_range_lock<Executor> &mtx, std::uint64_t offset, std::uint64_t length, error_code &ec)
+{
+  mtx.lock(offset, length, ec);
+  if (ec)
+    return range_lock_guard();
+  else
+    return range_lock_guard(mtx, offset, length, std::adopt_lock);
+}
+
+/// Lock a range shared & acquire a range_lock_guard synchronously.
+template <typename Executor>
+range_lock_guard lock_shared(basic_range_lock<Executor> &mtx, std::uint64_t offset, std::uint64_t length)
+{
+  mtx.lock_shared(offset, length);
+  return range_lock_guard(mtx, offset, length, true, std::adopt_lock);
+}
+
+template <typename Executor>
+range_lock_guard lock_shared(basic_range_lock<Executor> &mtx, std::uint64_t offset, std::uint64_t length,
+                             error_code &ec)
+{
+  mtx.lock_shared(offset, length, ec);
+  if (ec)
+    return range_lock_guard();
+  else
+    return range_lock_guard(mtx, offset, length, true, std::adopt_lock);
+}
+
+namespace detail
+{
+
+template<typename RangeLock>
+struct async_lock_range_op
+{
+  RangeLock    &mtx;
+  std::uint64_t offset, length;
+  bool          shared;
+
+  template<typename Self>
+  void operator()(Self && self)
+  {
+    if (shared)
+      mtx.async_lock_shared(offset, length, std::move(self));
+    else
+      mtx.async_lock(offset, length, std::move(self));
+  }
+
+  template<typename Self>
+  void operator()(Self && self, error_code ec)
+  {
+    if (ec)
+      self.complete(ec, range_lock_guard{});
+    else
+      self.complete(ec, range_lock_guard{mtx, offset, length, shared, std::adopt_lock});
+  }
+};
+
+}
+
+/** Lock a range exclusively & acquire a range_lock_guard asynchronously.
+ *
+ * @param mtx The range lock.
+ * @param offset The start of the range.
+ * @param length The length of the range.
+ * @param token The Completion Token.
+ *
+ * @returns The async_result deduced from the token.
+ */
+template <typename Executor,
+          BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code, range_lock_guard))
+              CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(Executor)>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code, range_lock_guard))
+async_lock(basic_range_lock<Executor> &mtx, std::uint64_t offset, std::uint64_t length,
+           CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(Executor))
+{
+  return net::async_compose<
+      CompletionToken, void(error_code, range_lock_guard)>
+      (
+          detail::async_lock_range_op<basic_range_lock<Executor>>{mtx, offset, length, false},
+          token, mtx
+      );
+}
+
+/// Lock a range shared & acquire a range_lock_guard asynchronously.
+template <typename Executor,
+          BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code, range_lock_guard))
+              CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(Executor)>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code, range_lock_guard))
+async_lock_shared(basic_range_lock<Executor> &mtx, std::uint64_t offset, std::uint64_t length,
+                  CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(Executor))
+{
+  return net::async_compose<
+      CompletionToken, void(error_code, range_lock_guard)>
+      (
+          detail::async_lock_range_op<basic_range_lock<Executor>>{mtx, offset, length, true},
+          token, mtx
+      );
+}
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_RANGE_LOCK_GUARD_HPP
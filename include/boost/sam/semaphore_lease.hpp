@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2023 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_SAM_SEMAPHORE_LEASE_HPP
+#define BOOST_SAM_SEMAPHORE_LEASE_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/semaphore_impl.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+template <class Executor>
+struct basic_semaphore;
+
+/** A permit of a semaphore, that gets reclaimed unless it's renewed or released before it expires.
+ *
+ * Obtained from basic_semaphore::async_acquire_lease. Releases the permit on destruction,
+ * unless it expired already.
+ */
+struct semaphore_lease
+{
+  /// Construct an empty lease.
+  semaphore_lease()                        = default;
+  semaphore_lease(const semaphore_lease &) = delete;
+  semaphore_lease(semaphore_lease &&lhs) noexcept : sem_(lhs.sem_), id_(lhs.id_) { lhs.sem_ = nullptr; }
+
+  semaphore_lease &operator=(const semaphore_lease &) = delete;
+  semaphore_lease &operator=(semaphore_lease &&lhs) noexcept
+  {
+    std::swap(lhs.sem_, sem_);
+    std::swap(lhs.id_, id_);
+    return *this;
+  }
+
+  /// Release the permit, if the lease didn't expire yet.
+  ~semaphore_lease() { release(); }
+
+  /// Extend the lease to `ttl` from now. Returns false if it expired already & the permit was reclaimed.
+  template <typename Rep, typename Period>
+  bool renew(const std::chrono::duration<Rep, Period> &ttl)
+  {
+    return sem_ != nullptr &&
+           sem_->renew_lease(id_, std::chrono::duration_cast<std::chrono::steady_clock::duration>(ttl));
+  }
+
+  /// Release the permit & empty the lease. Returns false if it expired already, in which case nothing gets released.
+  bool release()
+  {
+    if (sem_ == nullptr)
+      return false;
+    auto sem = sem_;
+    sem_     = nullptr;
+    return sem->release_lease(id_);
+  }
+
+  /// Whether the lease still holds its permit.
+  BOOST_SAM_NODISCARD bool active() const { return sem_ != nullptr && sem_->has_lease(id_); }
+
+private:
+  template <class Executor>
+  friend struct basic_semaphore;
+
+  semaphore_lease(detail::semaphore_impl &sem, std::uint64_t id) : sem_(&sem), id_(id) {}
+
+  detail::semaphore_impl *sem_ = nullptr;
+  std::uint64_t           id_  = 0u;
+};
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_SEMAPHORE_LEASE_HPP
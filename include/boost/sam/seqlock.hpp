@@ -0,0 +1,22 @@
+//
+// Copyright (c) 2023 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_SAM_SEQLOCK_HPP
+#define BOOST_SAM_SEQLOCK_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/basic_seqlock.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/// basic_seqlock with default executor.
+template <typename T>
+using seqlock = basic_seqlock<T>;
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_SEQLOCK_HPP
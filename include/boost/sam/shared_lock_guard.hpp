@@ -10,6 +10,7 @@
 
 #include <boost/sam/detail/config.hpp>
 #include <boost/sam/detail/shared_mutex_impl.hpp>
+#include <boost/sam/lock_guard.hpp>
 #include <mutex>
 #include <utility>
 
@@ -67,20 +68,38 @@ private:
 template <typename Executor>
 shared_lock_guard lock_shared(basic_shared_mutex<Executor> &mtx)
 {
-  mtx.lock();
+  mtx.lock_shared();
   return shared_lock_guard(mtx, std::adopt_lock);
 }
 
 template <typename Executor>
 shared_lock_guard lock_shared(basic_shared_mutex<Executor> &mtx, error_code &ec)
 {
-  mtx.lock(ec);
+  mtx.lock_shared(ec);
   if (ec)
     return shared_lock_guard();
   else
     return shared_lock_guard(mtx, std::adopt_lock);
 }
 
+/** Turn an exclusive lock_guard into a shared_lock_guard, without unlocking in between.
+ *
+ * Pending shared locks are admitted along with it, while pending exclusive locks keep waiting.
+ *
+ * @param mtx The mutex `lock` holds.
+ * @param lock The exclusive lock, which is left empty.
+ *
+ * @returns The shared_lock_guard.
+ */
+template <typename Executor>
+shared_lock_guard downgrade(basic_shared_mutex<Executor> &mtx, lock_guard &&lock)
+{
+  BOOST_SAM_ASSERT(lock.mtx_ == &mtx.impl_);
+  lock.mtx_ = nullptr;
+  mtx.downgrade();
+  return shared_lock_guard(mtx, std::adopt_lock);
+}
+
 namespace detail
 {
 
@@ -13,12 +13,24 @@
 #error Do not compile SaM library source with BOOST_BEAST_HEADER_ONLY defined
 #endif
 
+#include <boost/sam/detail/impl/adaptive_limiter_impl.ipp>
 #include <boost/sam/detail/impl/barrier_impl.ipp>
+#include <boost/sam/detail/impl/biased_shared_mutex_impl.ipp>
 #include <boost/sam/detail/impl/condition_variable_impl.ipp>
+#include <boost/sam/detail/impl/distributed_semaphore_impl.ipp>
+#include <boost/sam/detail/impl/hierarchical_semaphore_impl.ipp>
+#include <boost/sam/detail/impl/lock_hierarchy_impl.ipp>
 #include <boost/sam/detail/impl/mutex_impl.ipp>
+#include <boost/sam/detail/impl/range_lock_impl.ipp>
+#include <boost/sam/detail/impl/rate_limiter_impl.ipp>
+#include <boost/sam/detail/impl/rcu_impl.ipp>
+#include <boost/sam/detail/impl/recursive_mutex_impl.ipp>
 #include <boost/sam/detail/impl/shared_mutex_impl.ipp>
 #include <boost/sam/detail/impl/semaphore_impl.ipp>
+#include <boost/sam/detail/impl/seqlock_impl.ipp>
 #include <boost/sam/detail/impl/service.ipp>
+#include <boost/sam/detail/impl/striped_mutex_impl.ipp>
+#include <boost/sam/detail/impl/timer_wheel.ipp>
 #include <boost/sam/detail/impl/exception.ipp>
 
 #endif // BOOST_SAM_SRC_HPP
@@ -0,0 +1,22 @@
+//
+// Copyright (c) 2023 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_SAM_STRIPED_MUTEX_HPP
+#define BOOST_SAM_STRIPED_MUTEX_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/basic_striped_mutex.hpp>
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+/// basic_striped_mutex with default executor.
+template <std::size_t Stripes>
+using striped_mutex = basic_striped_mutex<Stripes>;
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_STRIPED_MUTEX_HPP
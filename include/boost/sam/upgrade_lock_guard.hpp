@@ -0,0 +1,205 @@
+//
+// Copyright (c) 2023 Klemens Morgenstern (klemens.morgenstern@gmx.net)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_SAM_UPGRADE_LOCK_GUARD_HPP
+#define BOOST_SAM_UPGRADE_LOCK_GUARD_HPP
+
+#include <boost/sam/detail/config.hpp>
+#include <boost/sam/detail/shared_mutex_impl.hpp>
+#include <boost/sam/lock_guard.hpp>
+#include <mutex>
+#include <utility>
+
+#if defined(BOOST_SAM_STANDALONE)
+#include <asio/async_result.hpp>
+#include <asio/compose.hpp>
+
+#else
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/compose.hpp>
+#endif
+
+BOOST_SAM_BEGIN_NAMESPACE
+
+template <typename Executor>
+struct basic_shared_mutex;
+
+namespace detail
+{
+template <typename Mutex>
+struct async_upgrade_op;
+}
+
+/** A lock-guard used as an RAII object that automatically unlocks the upgrade lock on destruction
+ *
+ * To use with with async_lock_upgrade.
+ */
+struct upgrade_lock_guard
+{
+  /// Construct an empty upgrade_lock_guard.
+  upgrade_lock_guard()                          = default;
+  upgrade_lock_guard(const upgrade_lock_guard &) = delete;
+  upgrade_lock_guard(upgrade_lock_guard &&lhs) : mtx_(lhs.mtx_) { lhs.mtx_ = nullptr; }
+
+  upgrade_lock_guard &operator=(const upgrade_lock_guard &) = delete;
+  upgrade_lock_guard &operator=(upgrade_lock_guard &&lhs)
+  {
+    std::swap(lhs.mtx_, mtx_);
+    return *this;
+  }
+
+  /// Unlock the underlying mutex.
+  ~upgrade_lock_guard()
+  {
+    if (mtx_ != nullptr)
+      mtx_->unlock_upgrade();
+  }
+
+  template <typename Executor>
+  upgrade_lock_guard(basic_shared_mutex<Executor> &mtx, const std::adopt_lock_t &) : mtx_(&mtx.impl_)
+  {
+  }
+
+private:
+  template <typename>
+  friend struct detail::async_upgrade_op;
+
+  detail::shared_mutex_impl *mtx_ = nullptr;
+};
+
+/** Acquire an upgrade_lock_guard synchronously.
+ *
+ * @param mtx The mutex to lock.
+ *
+ * @returns The upgrade_lock_guard.
+ *
+ * @throws May throw a system_error if locking is not possible without a deadlock.
+ */
+template <typename Executor>
+upgrade_lock_guard lock_upgrade(basic_shared_mutex<Executor> &mtx)
+{
+  mtx.lock_upgrade();
+  return upgrade_lock_guard(mtx, std::adopt_lock);
+}
+
+/** Acquire an upgrade_lock_guard synchronously.
+ *
+ * @param mtx The mutex to lock.
+ *
+ * @returns The upgrade_lock_guard. It might be default constructed if locking  wasn't possible.
+ */
+template <typename Executor>
+upgrade_lock_guard lock_upgrade(basic_shared_mutex<Executor> &mtx, error_code &ec)
+{
+  mtx.lock_upgrade(ec);
+  if (ec)
+    return upgrade_lock_guard();
+  else
+    return upgrade_lock_guard(mtx, std::adopt_lock);
+}
+
+namespace detail
+{
+
+template<typename Mutex>
+struct async_lock_upgrade_op
+{
+  Mutex &mtx;
+
+  template<typename Self>
+  void operator()(Self && self)
+  {
+    mtx.async_lock_upgrade(std::move(self));
+  }
+
+  template<typename Self>
+  void operator()(Self && self, error_code ec)
+  {
+    if (ec)
+      self.complete(ec, upgrade_lock_guard{});
+    else
+      self.complete(ec, upgrade_lock_guard{mtx, std::adopt_lock});
+  }
+};
+
+template<typename Mutex>
+struct async_upgrade_op
+{
+  Mutex &mtx;
+  upgrade_lock_guard &guard;
+
+  template<typename Self>
+  void operator()(Self && self)
+  {
+    mtx.async_upgrade(std::move(self));
+  }
+
+  template<typename Self>
+  void operator()(Self && self, error_code ec)
+  {
+    if (ec)
+      self.complete(ec, lock_guard{});
+    else
+    {
+      // the upgrade lock became the exclusive one, so there's nothing left to unlock.
+      guard.mtx_ = nullptr;
+      self.complete(ec, lock_guard{mtx, std::adopt_lock});
+    }
+  }
+};
+
+}
+
+/** Acquire an upgrade_lock_guard asynchronously.
+ *
+ * @param mtx The mutex to lock.
+ * @param token The Completion Token.
+ *
+ * @returns The async_result deduced from the token.
+ */
+template <typename Executor,
+          BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code, upgrade_lock_guard))
+              CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(Executor)>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code, upgrade_lock_guard))
+async_lock_upgrade(basic_shared_mutex<Executor> &mtx, CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(Executor))
+{
+  return net::async_compose<
+      CompletionToken, void(error_code, upgrade_lock_guard)>
+      (
+          detail::async_lock_upgrade_op<basic_shared_mutex<Executor>>{mtx},
+          token, mtx
+      );
+}
+
+/** Turn an upgrade_lock_guard into a lock_guard asynchronously, once the readers have unlocked.
+ *
+ * On success the `guard` is left empty, otherwise it still holds the upgrade lock.
+ *
+ * @param mtx The mutex `guard` holds.
+ * @param guard The upgrade lock to turn into an exclusive one.
+ * @param token The Completion Token.
+ *
+ * @returns The async_result deduced from the token.
+ */
+template <typename Executor,
+          BOOST_SAM_COMPLETION_TOKEN_FOR(void(error_code, lock_guard))
+              CompletionToken BOOST_SAM_DEFAULT_COMPLETION_TOKEN_TYPE(Executor)>
+BOOST_SAM_INITFN_AUTO_RESULT_TYPE(CompletionToken, void(error_code, lock_guard))
+async_upgrade(basic_shared_mutex<Executor> &mtx, upgrade_lock_guard &guard,
+              CompletionToken &&token BOOST_SAM_DEFAULT_COMPLETION_TOKEN(Executor))
+{
+  return net::async_compose<
+      CompletionToken, void(error_code, lock_guard)>
+      (
+          detail::async_upgrade_op<basic_shared_mutex<Executor>>{mtx, guard},
+          token, mtx
+      );
+}
+
+BOOST_SAM_END_NAMESPACE
+
+#endif // BOOST_SAM_UPGRADE_LOCK_GUARD_HPP
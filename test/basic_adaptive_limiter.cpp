@@ -0,0 +1,162 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/adaptive_limiter.hpp>
+#include <chrono>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+// Hold as many permits as the limit allows.
+static int saturate(adaptive_limiter &al)
+{
+  int n = 0;
+  while (al.try_acquire())
+    n++;
+  return n;
+}
+
+TEST_SUITE_BEGIN("basic_adaptive_limiter");
+
+TEST_CASE("limit" * doctest::timeout(10.))
+{
+  io_context       ctx;
+  adaptive_limiter al{ctx, 4, 1, 10};
+
+  CHECK(al.limit() == 4);
+  CHECK(saturate(al) == 4);
+  CHECK(al.in_flight() == 4);
+
+  std::vector<error_code> ecs;
+  al.async_acquire([&](error_code ec) { ecs.push_back(ec); });
+  ctx.poll();
+  CHECK(ecs.empty());
+
+  al.release();
+  ctx.restart();
+  ctx.poll();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(!ecs[0]);
+  CHECK(al.limit() == 4);
+  CHECK(al.in_flight() == 4);
+}
+
+TEST_CASE("grow" * doctest::timeout(10.))
+{
+  io_context       ctx;
+  adaptive_limiter al{ctx, 4, 1, 20};
+
+  // a flat latency while the limit is what holds things back.
+  for (int i = 0; i < 200; i++)
+  {
+    saturate(al);
+    al.release(std::chrono::milliseconds(10));
+  }
+  CHECK(al.limit() == 20);
+  CHECK(al.in_flight() == 19);
+}
+
+TEST_CASE("app_limited" * doctest::timeout(10.))
+{
+  io_context       ctx;
+  adaptive_limiter al{ctx, 10, 1, 100};
+
+  for (int i = 0; i < 100; i++)
+  {
+    CHECK(al.try_acquire());
+    al.release(std::chrono::milliseconds(10));
+  }
+  CHECK(al.limit() == 10);
+  CHECK(al.in_flight() == 0);
+}
+
+TEST_CASE("latency" * doctest::timeout(10.))
+{
+  io_context       ctx;
+  adaptive_limiter al{ctx, 50, 5, 100};
+
+  for (int i = 0; i < 20; i++)
+  {
+    saturate(al);
+    al.release(std::chrono::milliseconds(10));
+  }
+  const auto peak = al.limit();
+  CHECK(peak > 50);
+
+  // the backend got ten times slower
+  for (int i = 0; i < 20; i++)
+  {
+    saturate(al);
+    al.release(std::chrono::milliseconds(100));
+  }
+  CHECK(al.limit() < peak / 2);
+}
+
+TEST_CASE("shrink" * doctest::timeout(10.))
+{
+  io_context       ctx;
+  adaptive_limiter al{ctx, 100, 80, 100};
+
+  CHECK(saturate(al) == 100);
+  // a failure backs off, but the permits held stay valid
+  al.release(std::chrono::milliseconds(10), true);
+  CHECK(al.limit() == 90);
+  CHECK(al.in_flight() == 99);
+  CHECK(!al.try_acquire());
+
+  for (int i = 0; i < 9; i++)
+    al.release();
+  CHECK(al.in_flight() == 90);
+  CHECK(!al.try_acquire());
+
+  // the permits get handed out again once enough got released
+  al.release();
+  CHECK(saturate(al) == 1);
+
+  // never below the minimum
+  for (int i = 0; i < 10; i++)
+    al.release(std::chrono::milliseconds(10), true);
+  CHECK(al.limit() == 80);
+  CHECK(al.in_flight() == 80);
+  CHECK(!al.try_acquire());
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context              ctx;
+  adaptive_limiter        al{ctx, 1, 1, 10};
+  cancellation_signal     sig;
+  std::vector<error_code> ecs;
+
+  CHECK(al.try_acquire());
+  al.async_acquire(bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  ctx.poll();
+  CHECK(ecs.empty());
+
+  sig.emit(cancellation_type::all);
+  ctx.restart();
+  ctx.poll();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::operation_aborted);
+  CHECK(al.in_flight() == 1);
+}
+
+TEST_SUITE_END();
@@ -18,6 +18,8 @@
 #include <chrono>
 #include <random>
 #include <thread>
+#include <memory>
+#include <vector>
 
 #if !defined(BOOST_SAM_STANDALONE)
 #include <boost/asio/bind_cancellation_slot.hpp>
@@ -203,4 +205,56 @@ TEST_CASE("mt_shutdown" * doctest::timeout(10.))
   CHECK(wp.expired());
 }
 
+TEST_CASE("arrive_for" * doctest::timeout(10.))
+{
+  io_context ctx;
+  barrier b{ctx, 2};
+  std::vector<error_code> ecs;
+
+  b.async_arrive_for(std::chrono::milliseconds(5), [&](error_code ec) { ecs.push_back(ec); });
+  ctx.run();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::timed_out);
+
+  // the timed out arrival got withdrawn, so it takes two more.
+  b.async_arrive_until(std::chrono::steady_clock::now() + std::chrono::seconds(5),
+                       [&](error_code ec) { ecs.push_back(ec); });
+  ctx.restart();
+  ctx.poll();
+  CHECK(ecs.size() == 1u);
+  b.async_arrive([&](error_code ec) { ecs.push_back(ec); });
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 3u);
+  CHECK(!ecs[1]);
+  CHECK(!ecs[2]);
+}
+
+TEST_CASE("move_arrive_for" * doctest::timeout(10.))
+{
+  io_context ctx;
+  std::vector<error_code> ecs;
+
+  std::unique_ptr<barrier> b{new barrier{ctx, 2}};
+  b->async_arrive_for(std::chrono::milliseconds(5), [&](error_code ec) { ecs.push_back(ec); });
+
+  // the arrival times out in the new barrier, so it's withdrawn from that one's count.
+  barrier moved{std::move(*b)};
+  b.reset();
+  ctx.run();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::timed_out);
+
+  moved.async_arrive([&](error_code ec) { ecs.push_back(ec); });
+  ctx.restart();
+  ctx.poll();
+  CHECK(ecs.size() == 1u);
+  moved.async_arrive([&](error_code ec) { ecs.push_back(ec); });
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 3u);
+  CHECK(!ecs[1]);
+  CHECK(!ecs[2]);
+}
+
 TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,171 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/biased_shared_mutex.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_biased_shared_mutex");
+
+TEST_CASE("shared" * doctest::timeout(10.))
+{
+  io_context ctx;
+  biased_shared_mutex mtx{ctx};
+  int cnt = 0;
+
+  for (int i = 0; i < 4; i++)
+    mtx.async_lock_shared([&](error_code ec) { CHECK(!ec); cnt++; });
+  ctx.run();
+  CHECK(cnt == 4);
+
+  CHECK(!mtx.try_lock());
+  for (int i = 0; i < 4; i++)
+    mtx.unlock_shared();
+  CHECK(mtx.try_lock());
+  CHECK(!mtx.try_lock_shared());
+  mtx.unlock();
+  CHECK(mtx.try_lock_shared());
+  mtx.unlock_shared();
+}
+
+TEST_CASE("drain" * doctest::timeout(10.))
+{
+  io_context ctx;
+  biased_shared_mutex mtx{ctx};
+  std::vector<int> order;
+
+  CHECK(mtx.try_lock_shared());
+  CHECK(mtx.try_lock_shared());
+  mtx.async_lock([&](error_code ec) { CHECK(!ec); order.push_back(0); });
+  // readers arriving while the writer drains queue up behind it.
+  mtx.async_lock_shared([&](error_code ec) { CHECK(!ec); order.push_back(1); mtx.unlock_shared(); });
+  ctx.poll();
+  CHECK(order.empty());
+
+  mtx.unlock_shared();
+  ctx.poll();
+  CHECK(order.empty());
+
+  mtx.unlock_shared();
+  ctx.poll();
+  CHECK(order == std::vector<int>{0});
+
+  mtx.unlock();
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{0, 1});
+  CHECK(mtx.try_lock());
+  mtx.unlock();
+}
+
+TEST_CASE("readers_first" * doctest::timeout(10.))
+{
+  io_context ctx;
+  biased_shared_mutex mtx{ctx};
+  std::vector<int> order;
+
+  CHECK(mtx.try_lock());
+  mtx.async_lock([&](error_code ec) { CHECK(!ec); order.push_back(2); mtx.unlock(); });
+  mtx.async_lock_shared([&](error_code ec) { CHECK(!ec); order.push_back(0); net::post(ctx, [&] { mtx.unlock_shared(); }); });
+  mtx.async_lock_shared([&](error_code ec) { CHECK(!ec); order.push_back(1); net::post(ctx, [&] { mtx.unlock_shared(); }); });
+  mtx.unlock();
+  ctx.run();
+
+  CHECK(order == std::vector<int>{0, 1, 2});
+  CHECK(mtx.try_lock_shared());
+  mtx.unlock_shared();
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context ctx;
+  biased_shared_mutex mtx{ctx};
+  std::vector<int> order;
+  cancellation_signal sig;
+
+  CHECK(mtx.try_lock_shared());
+  mtx.async_lock(bind_cancellation_slot(sig.slot(), [&](error_code ec)
+                                        {
+                                          CHECK(ec == error::operation_aborted);
+                                          order.push_back(0);
+                                        }));
+  mtx.async_lock_shared([&](error_code ec) { CHECK(!ec); order.push_back(1); mtx.unlock_shared(); });
+  ctx.poll();
+  CHECK(order.empty());
+
+  // cancelling the draining writer lets the queued reader in.
+  sig.emit(cancellation_type::all);
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{0, 1});
+
+  mtx.unlock_shared();
+  CHECK(mtx.try_lock());
+  mtx.unlock();
+}
+
+TEST_CASE("sync_lock_mt" * doctest::timeout(10.))
+{
+  io_context ctx;
+  biased_shared_mutex mtx{ctx};
+  std::atomic<int> readers{0};
+  int value = 0;
+  bool broken = false;
+
+  std::vector<std::thread> thrs;
+  for (int i = 0; i < 4; i++)
+    thrs.emplace_back(
+        [&]
+        {
+          for (int j = 0; j < 1000; j++)
+          {
+            if (j % 10 == 0)
+            {
+              mtx.lock();
+              if (readers.load() != 0)
+                broken = true;
+              value++;
+              mtx.unlock();
+            }
+            else
+            {
+              mtx.lock_shared();
+              readers++;
+              (void)value;
+              readers--;
+              mtx.unlock_shared();
+            }
+          }
+        });
+
+  for (auto &t : thrs)
+    t.join();
+
+  CHECK(!broken);
+  CHECK(value == 400);
+}
+
+TEST_SUITE_END();
@@ -21,6 +21,7 @@
 #include <chrono>
 #include <atomic>
 #include <random>
+#include <vector>
 
 #if defined(BOOST_SAM_STANDALONE)
 #include <asio/bind_cancellation_slot.hpp>
@@ -219,4 +220,49 @@ TEST_CASE_TEMPLATE("cancel_2" * doctest::timeout(10.), T, net::io_context, net::
   run_impl(ctx);
 }
 
+TEST_CASE("wait_for" * doctest::timeout(10.))
+{
+  net::io_context ctx;
+  auto cv = condition_variable(ctx.get_executor());
+  std::vector<error_code> ecs;
+
+  cv.async_wait_for(std::chrono::milliseconds(5), [&](error_code ec) { ecs.push_back(ec); });
+  cv.async_wait_until(std::chrono::steady_clock::now() + std::chrono::seconds(5),
+                      [&](error_code ec) { ecs.push_back(ec); });
+  ctx.run_for(std::chrono::milliseconds(50));
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == net::error::timed_out);
+
+  cv.notify_all();
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 2u);
+  CHECK(!ecs[1]);
+}
+
+TEST_CASE("wait_for_predicate" * doctest::timeout(10.))
+{
+  net::io_context ctx;
+  auto cv = condition_variable(ctx.get_executor());
+  std::vector<error_code> ecs;
+  bool ready = false;
+
+  cv.async_wait_for(std::chrono::milliseconds(20), [&] { return ready; },
+                    [&](error_code ec) { ecs.push_back(ec); });
+  cv.async_wait_until(std::chrono::system_clock::now() + std::chrono::seconds(5), [&] { return ready; },
+                      [&](error_code ec) { ecs.push_back(ec); });
+  // the predicate isn't satisfied yet, so this doesn't complete anything.
+  net::post(ctx, [&] { cv.notify_all(); });
+  ctx.run_for(std::chrono::milliseconds(100));
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == net::error::timed_out);
+
+  ready = true;
+  cv.notify_all();
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 2u);
+  CHECK(!ecs[1]);
+}
+
 TEST_SUITE_END();
\ No newline at end of file
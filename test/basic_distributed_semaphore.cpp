@@ -0,0 +1,174 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/distributed_semaphore.hpp>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_distributed_semaphore");
+
+TEST_CASE("exact_limit" * doctest::timeout(10.))
+{
+  io_context            ctx;
+  distributed_semaphore sem{ctx, 64};
+
+  for (int i = 0; i < 64; i++)
+    CHECK(sem.try_acquire());
+  CHECK(!sem.try_acquire());
+  CHECK(sem.value() == 0);
+
+  int done = 0;
+  sem.async_acquire([&](error_code ec) { CHECK(!ec); done++; });
+  ctx.poll();
+  CHECK(done == 0);
+  CHECK(sem.value() == -1);
+
+  sem.release();
+  ctx.restart();
+  ctx.poll();
+  CHECK(done == 1);
+
+  for (int i = 0; i < 64; i++)
+    sem.release();
+  CHECK(sem.value() == 64);
+}
+
+TEST_CASE("distribution" * doctest::timeout(10.))
+{
+  io_context            ctx;
+  distributed_semaphore sem{ctx, 64};
+
+  CHECK(sem.pooled() == 64);
+  CHECK(sem.try_acquire());
+  CHECK(sem.value() == 63);
+
+  // the acquire took a batch into the cache of this thread
+  auto dist = sem.distribution();
+  CHECK(!dist.empty());
+  CHECK(sem.pooled() + std::accumulate(dist.begin(), dist.end(), 0) == 63);
+
+  sem.release();
+  dist = sem.distribution();
+  CHECK(sem.pooled() + std::accumulate(dist.begin(), dist.end(), 0) == 64);
+}
+
+TEST_CASE("rebalance" * doctest::timeout(10.))
+{
+  io_context            ctx;
+  distributed_semaphore sem{ctx, 8};
+
+  // the permits end up cached by another thread
+  std::thread thr{[&]
+                  {
+                    for (int i = 0; i < 8; i++)
+                      CHECK(sem.try_acquire());
+                    for (int i = 0; i < 8; i++)
+                      sem.release();
+                  }};
+  thr.join();
+  CHECK(sem.value() == 8);
+
+  for (int i = 0; i < 8; i++)
+    CHECK(sem.try_acquire());
+  CHECK(!sem.try_acquire());
+  CHECK(sem.value() == 0);
+}
+
+TEST_CASE("release_elsewhere" * doctest::timeout(10.))
+{
+  io_context            ctx;
+  distributed_semaphore sem{ctx, 1};
+  int                   done = 0;
+
+  CHECK(sem.try_acquire());
+  sem.async_acquire([&](error_code ec) { CHECK(!ec); done++; });
+  ctx.poll();
+  CHECK(done == 0);
+
+  // the release lands in the cache of another thread, which must not keep it from the waiter
+  std::thread thr{[&] { sem.release(); }};
+  thr.join();
+  ctx.restart();
+  ctx.run();
+  CHECK(done == 1);
+  CHECK(sem.value() == 0);
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context              ctx;
+  distributed_semaphore   sem{ctx, 1};
+  cancellation_signal     sig;
+  std::vector<error_code> ecs;
+
+  CHECK(sem.try_acquire());
+  sem.async_acquire(bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  sem.async_acquire([&](error_code ec) { ecs.push_back(ec); });
+  ctx.poll();
+  CHECK(sem.value() == -2);
+
+  sig.emit(cancellation_type::all);
+  ctx.restart();
+  ctx.poll();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::operation_aborted);
+  CHECK(sem.value() == -1);
+
+  sem.release();
+  ctx.restart();
+  ctx.poll();
+  REQUIRE(ecs.size() == 2u);
+  CHECK(!ecs[1]);
+  CHECK(sem.value() == 0);
+}
+
+TEST_CASE("sync_acquire_mt" * doctest::timeout(10.))
+{
+  io_context            ctx;
+  distributed_semaphore sem{ctx, 3};
+  std::atomic<int>      active{0};
+  std::atomic<int>      done{0};
+
+  std::vector<std::thread> thrs;
+  for (int t = 0; t < 8; t++)
+    thrs.emplace_back(
+        [&]
+        {
+          for (int i = 0; i < 200; i++)
+          {
+            sem.acquire();
+            CHECK(++active <= 3);
+            active--;
+            sem.release();
+            done++;
+          }
+        });
+  for (auto &thr : thrs)
+    thr.join();
+  CHECK(done == 1600);
+  CHECK(sem.value() == 3);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,157 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/fair_semaphore.hpp>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_fair_semaphore");
+
+TEST_CASE("round_robin" * doctest::timeout(10.))
+{
+  io_context                  ctx;
+  fair_semaphore<std::string> sem{ctx, 0};
+  std::string                 order;
+
+  // the noisy tenant queues up first, but doesn't get more than its share
+  for (int i = 0; i < 10; i++)
+    sem.async_acquire("a", [&](error_code ec) { CHECK(!ec); order += 'a'; });
+  for (int i = 0; i < 2; i++)
+    sem.async_acquire("b", [&](error_code ec) { CHECK(!ec); order += 'b'; });
+  ctx.poll();
+  CHECK(order.empty());
+  CHECK(sem.tenants() == 2u);
+  CHECK(sem.value() == -12);
+
+  for (int i = 0; i < 6; i++)
+    sem.release();
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == "ababaa");
+  // the tenant without waiters is gone
+  CHECK(sem.tenants() == 1u);
+
+  for (int i = 0; i < 6; i++)
+    sem.release();
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == "ababaaaaaaaa");
+  CHECK(sem.tenants() == 0u);
+  CHECK(sem.value() == 0);
+  CHECK(!sem.try_acquire());
+}
+
+TEST_CASE("weights" * doctest::timeout(10.))
+{
+  io_context          ctx;
+  fair_semaphore<int> sem{ctx, 0};
+  std::vector<int>    order;
+
+  sem.set_weight(1, 3);
+  CHECK(sem.weight(1) == 3);
+  CHECK(sem.weight(2) == 1);
+  for (int i = 0; i < 6; i++)
+  {
+    sem.async_acquire(1, [&](error_code ec) { CHECK(!ec); order.push_back(1); });
+    sem.async_acquire(2, [&](error_code ec) { CHECK(!ec); order.push_back(2); });
+  }
+
+  for (int i = 0; i < 8; i++)
+    sem.release();
+  ctx.poll();
+  CHECK(order == std::vector<int>{1, 1, 1, 2, 1, 1, 1, 2});
+
+  // tenant 1 has no waiters left, but keeps its weight. Tenant 2's applies to its queued waiters, too.
+  CHECK(sem.tenants() == 1u);
+  for (int i = 0; i < 4; i++)
+    sem.async_acquire(1, [&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  sem.set_weight(2, 2);
+  for (int i = 0; i < 5; i++)
+    sem.release();
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == std::vector<int>{1, 1, 1, 2, 1, 1, 1, 2, 2, 2, 1, 1, 1});
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context              ctx;
+  fair_semaphore<int>     sem{ctx, 1};
+  cancellation_signal     sig;
+  std::vector<error_code> ecs;
+
+  CHECK(sem.try_acquire());
+  sem.async_acquire(1, bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  sem.async_acquire(2, [&](error_code ec) { ecs.push_back(ec); });
+  ctx.poll();
+  CHECK(ecs.empty());
+  CHECK(sem.tenants() == 2u);
+
+  sig.emit(cancellation_type::all);
+  ctx.restart();
+  ctx.poll();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::operation_aborted);
+  CHECK(sem.tenants() == 1u);
+
+  sem.release();
+  ctx.restart();
+  ctx.poll();
+  REQUIRE(ecs.size() == 2u);
+  CHECK(!ecs[1]);
+  CHECK(sem.tenants() == 0u);
+}
+
+TEST_CASE("sync_acquire_mt" * doctest::timeout(10.))
+{
+  io_context          ctx;
+  fair_semaphore<int> sem{ctx, 2};
+  std::atomic<int>    active{0};
+  std::atomic<int>    done{0};
+
+  std::vector<std::thread> thrs;
+  for (int t = 0; t < 4; t++)
+    thrs.emplace_back(
+        [&, t]
+        {
+          for (int i = 0; i < 100; i++)
+          {
+            sem.acquire(t % 2);
+            CHECK(++active <= 2);
+            active--;
+            sem.release();
+            done++;
+          }
+        });
+  for (auto &thr : thrs)
+    thr.join();
+  CHECK(done == 400);
+  CHECK(sem.value() == 2);
+  CHECK(sem.tenants() == 0u);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,163 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/hierarchical_semaphore.hpp>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_hierarchical_semaphore");
+
+TEST_CASE("nested_quotas" * doctest::timeout(10.))
+{
+  io_context             ctx;
+  hierarchical_semaphore sem{ctx, 3};
+  const auto             a = sem.add_node(sem.root(), 2);
+  const auto             b = sem.add_node(sem.root(), 2);
+  std::string            order;
+
+  CHECK(sem.try_acquire(a));
+  CHECK(sem.try_acquire(a));
+  CHECK(!sem.try_acquire(a));
+  CHECK(sem.value(sem.root()) == 1);
+
+  // a is at its own quota, so it doesn't hold the last global permit while waiting
+  sem.async_acquire(a, [&](error_code ec) { CHECK(!ec); order += 'a'; });
+  sem.async_acquire(b, [&](error_code ec) { CHECK(!ec); order += 'b'; });
+  sem.async_acquire(b, [&](error_code ec) { CHECK(!ec); order += 'B'; });
+  ctx.poll();
+  CHECK(order == "b");
+  CHECK(sem.value(sem.root()) == 0);
+  CHECK(sem.value(a) == 0);
+  CHECK(sem.value(b) == 1);
+
+  // the older waiter of a still can't go, so the permit goes to b
+  sem.release(b);
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == "bB");
+
+  sem.release(a);
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == "bBa");
+  CHECK(sem.value(sem.root()) == 0);
+  CHECK(sem.value(a) == 0);
+  CHECK(sem.value(b) == 1);
+}
+
+TEST_CASE("oldest_first" * doctest::timeout(10.))
+{
+  io_context             ctx;
+  hierarchical_semaphore sem{ctx, 1};
+  const auto             a  = sem.add_node(sem.root(), 1);
+  const auto             b  = sem.add_node(sem.root(), 1);
+  const auto             b1 = sem.add_node(b, 1);
+  std::string            order;
+
+  CHECK(sem.try_acquire(a));
+  sem.async_acquire(b1, [&](error_code ec) { CHECK(!ec); order += 'b'; });
+  sem.async_acquire(a, [&](error_code ec) { CHECK(!ec); order += 'a'; });
+  ctx.poll();
+  CHECK(order.empty());
+
+  // both can go, the older one does
+  sem.release(a);
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == "b");
+  CHECK(sem.value(b) == 0);
+  CHECK(sem.value(b1) == 0);
+
+  sem.release(b1);
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == "ba");
+  CHECK(sem.value(b) == 1);
+  CHECK(sem.value(b1) == 1);
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context              ctx;
+  hierarchical_semaphore  sem{ctx, 1};
+  const auto              a = sem.add_node(sem.root(), 1);
+  cancellation_signal     sig;
+  std::vector<error_code> ecs;
+
+  CHECK(sem.try_acquire(a));
+  sem.async_acquire(a, bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  sem.async_acquire(sem.root(), [&](error_code ec) { ecs.push_back(ec); });
+  ctx.poll();
+  CHECK(ecs.empty());
+
+  sig.emit(cancellation_type::all);
+  ctx.restart();
+  ctx.poll();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::operation_aborted);
+
+  sem.release(a);
+  ctx.restart();
+  ctx.poll();
+  REQUIRE(ecs.size() == 2u);
+  CHECK(!ecs[1]);
+  CHECK(sem.value(a) == 1);
+  CHECK(sem.value(sem.root()) == 0);
+}
+
+TEST_CASE("sync_acquire_mt" * doctest::timeout(10.))
+{
+  io_context             ctx;
+  hierarchical_semaphore sem{ctx, 3};
+  const std::size_t      tenants[2] = {sem.add_node(sem.root(), 2), sem.add_node(sem.root(), 2)};
+  std::atomic<int>       active{0};
+  std::atomic<int>       per_tenant[2] = {{0}, {0}};
+  std::atomic<int>       done{0};
+
+  std::vector<std::thread> thrs;
+  for (int t = 0; t < 6; t++)
+    thrs.emplace_back(
+        [&, t]
+        {
+          for (int i = 0; i < 100; i++)
+          {
+            sem.acquire(tenants[t % 2]);
+            CHECK(++active <= 3);
+            CHECK(++per_tenant[t % 2] <= 2);
+            per_tenant[t % 2]--;
+            active--;
+            sem.release(tenants[t % 2]);
+            done++;
+          }
+        });
+  for (auto &thr : thrs)
+    thr.join();
+  CHECK(done == 600);
+  CHECK(sem.value(sem.root()) == 3);
+  CHECK(sem.value(tenants[0]) == 2);
+  CHECK(sem.value(tenants[1]) == 2);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,145 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/keyed_mutex.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_keyed_mutex");
+
+TEST_CASE("keys" * doctest::timeout(10.))
+{
+  io_context               ctx;
+  keyed_mutex<std::string> km{ctx};
+  CHECK(km.size() == 0u);
+
+  CHECK(km.try_lock("foo"));
+  CHECK(km.try_lock("bar"));
+  CHECK(!km.try_lock("foo"));
+  CHECK(!km.try_lock_shared("bar"));
+  CHECK(km.try_lock_shared("baz"));
+  CHECK(km.try_lock_shared("baz"));
+  CHECK(!km.try_lock("baz"));
+  CHECK(km.size() == 3u);
+
+  // failing try_locks don't leave entries behind
+  CHECK(!km.try_lock("foo"));
+  CHECK(km.size() == 3u);
+
+  km.unlock("foo");
+  km.unlock("bar");
+  km.unlock_shared("baz");
+  CHECK(km.size() == 1u);
+  km.unlock_shared("baz");
+  CHECK(km.size() == 0u);
+}
+
+TEST_CASE("order" * doctest::timeout(10.))
+{
+  io_context       ctx;
+  keyed_mutex<int> km{ctx};
+  std::vector<int> order;
+
+  km.lock(1);
+  km.async_lock_shared(1, [&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  km.async_lock_shared(1, [&](error_code ec) { CHECK(!ec); order.push_back(2); km.unlock_shared(1); });
+  km.async_lock(1, [&](error_code ec) { CHECK(!ec); order.push_back(3); km.unlock(1); });
+  // queued behind the exclusive waiter
+  km.async_lock_shared(1, [&](error_code ec) { CHECK(!ec); order.push_back(4); km.unlock_shared(1); });
+  // a different key isn't blocked at all
+  km.async_lock(2, [&](error_code ec) { CHECK(!ec); order.push_back(5); km.unlock(2); });
+  ctx.poll();
+  CHECK(order == std::vector<int>{5});
+  CHECK(km.size() == 1u);
+
+  km.unlock(1);
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == std::vector<int>{5, 1, 2});
+
+  km.unlock_shared(1);
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{5, 1, 2, 3, 4});
+  CHECK(km.size() == 0u);
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context              ctx;
+  keyed_mutex<int>        km{ctx};
+  cancellation_signal     sig;
+  std::vector<error_code> ecs;
+
+  km.lock_shared(1);
+  km.async_lock(1, bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  // only blocked by the exclusive waiter
+  km.async_lock_shared(1, [&](error_code ec) { ecs.push_back(ec); });
+  ctx.poll();
+  CHECK(ecs.empty());
+
+  net::post(ctx, [&] { sig.emit(cancellation_type::all); });
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 2u);
+  CHECK(ecs[0] == error::operation_aborted);
+  CHECK(!ecs[1]);
+  km.unlock_shared(1);
+  km.unlock_shared(1);
+  CHECK(km.size() == 0u);
+}
+
+TEST_CASE("sync_lock_mt" * doctest::timeout(10.))
+{
+  io_context       ctx;
+  keyed_mutex<int> km{ctx};
+  std::vector<int> values(8, 0);
+
+  std::vector<std::thread> thrs;
+  for (int t = 0; t < 4; t++)
+    thrs.emplace_back(
+        [&, t]
+        {
+          for (int i = 0; i < 1000; i++)
+          {
+            const int key = (t + i) % 8;
+            km.lock(key);
+            values[key]++;
+            km.unlock(key);
+          }
+        });
+
+  for (auto &t : thrs)
+    t.join();
+
+  int sum = 0;
+  for (auto v : values)
+    sum += v;
+  CHECK(sum == 4 * 1000);
+  CHECK(km.size() == 0u);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,124 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/keyed_rate_limiter.hpp>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_keyed_rate_limiter");
+
+TEST_CASE("admission" * doctest::timeout(10.))
+{
+  io_context                      ctx;
+  keyed_rate_limiter<std::string> rl{ctx, 1, std::chrono::hours(1), 3};
+
+  CHECK(rl.try_acquire("alice"));
+  CHECK(rl.try_acquire("alice"));
+  CHECK(rl.try_acquire("alice"));
+  CHECK(!rl.try_acquire("alice"));
+  // keys don't share their budget
+  CHECK(rl.try_acquire("bob"));
+  CHECK(rl.size() == 2u);
+}
+
+TEST_CASE("eviction" * doctest::timeout(10.))
+{
+  io_context ctx;
+  // single threaded, so all keys share one shard.
+  keyed_rate_limiter<int> rl{ctx, 1, std::chrono::milliseconds(1), 1, BOOST_SAM_CONCURRENCY_HINT_1};
+
+  for (int i = 0; i < 100; i++)
+    CHECK(rl.try_acquire(i));
+  CHECK(rl.size() == 100u);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  // every call sweeps a few keys, so the idle ones go away while the table's in use
+  for (int i = 0; i < 100; i++)
+    rl.try_acquire(-1);
+  CHECK(rl.size() == 1u);
+}
+
+TEST_CASE("park" * doctest::timeout(10.))
+{
+  io_context              ctx;
+  // one request every 10ms
+  keyed_rate_limiter<int> rl{ctx, 100, std::chrono::seconds(1), 1};
+  std::vector<int>        order;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 4; i++)
+    rl.async_acquire(1, [&, i](error_code ec) { CHECK(!ec); order.push_back(i); });
+  rl.async_acquire(2, [&](error_code ec) { CHECK(!ec); order.push_back(10); });
+  ctx.poll();
+  CHECK(order == std::vector<int>{0, 10});
+
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{0, 10, 1, 2, 3});
+  CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(30));
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context              ctx;
+  keyed_rate_limiter<int> rl{ctx, 1, std::chrono::hours(1), 1};
+  cancellation_signal     sig;
+  std::vector<error_code> ecs;
+
+  CHECK(rl.try_acquire(1));
+  rl.async_acquire(1, bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  ctx.poll();
+  CHECK(ecs.empty());
+
+  net::post(ctx, [&] { sig.emit(cancellation_type::all); });
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::operation_aborted);
+}
+
+TEST_CASE("sync_acquire_mt" * doctest::timeout(10.))
+{
+  io_context              ctx;
+  keyed_rate_limiter<int> rl{ctx, 1, std::chrono::milliseconds(5), 1};
+
+  const auto               start = std::chrono::steady_clock::now();
+  std::vector<std::thread> thrs;
+  for (int t = 0; t < 4; t++)
+    thrs.emplace_back(
+        [&]
+        {
+          for (int i = 0; i < 2; i++)
+            rl.acquire(42);
+        });
+  for (auto &thr : thrs)
+    thr.join();
+  // eight requests of the same key, so the last one waits for seven intervals.
+  CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(35));
+}
+
+TEST_SUITE_END();
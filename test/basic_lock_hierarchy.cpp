@@ -0,0 +1,228 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/lock_hierarchy.hpp>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_lock_hierarchy");
+
+TEST_CASE("compatibility" * doctest::timeout(10.))
+{
+  io_context ctx;
+  lock_hierarchy h{ctx};
+  auto db     = h.root();
+  auto users  = h.add_node(db);
+  auto orders = h.add_node(db);
+  auto alice  = h.add_node(users);
+  auto bob    = h.add_node(users);
+  CHECK(h.size() == 5u);
+
+  // rows of the same table
+  CHECK(h.try_lock(alice, lock_mode::exclusive));
+  CHECK(h.try_lock(bob, lock_mode::exclusive));
+  CHECK(!h.try_lock(alice, lock_mode::shared));
+  // the table holds intention exclusive locks now
+  CHECK(!h.try_lock(users, lock_mode::shared));
+  CHECK(!h.try_lock(users, lock_mode::exclusive));
+  CHECK(h.try_lock(users, lock_mode::intention_shared));
+  CHECK(h.try_lock(orders, lock_mode::exclusive));
+  CHECK(!h.try_lock(db, lock_mode::shared));
+
+  h.unlock(alice, lock_mode::exclusive);
+  h.unlock(bob, lock_mode::exclusive);
+  h.unlock(users, lock_mode::intention_shared);
+  h.unlock(orders, lock_mode::exclusive);
+
+  // read the table, write single rows
+  CHECK(h.try_lock(users, lock_mode::shared_intention_exclusive));
+  CHECK(!h.try_lock(alice, lock_mode::exclusive));
+  CHECK(h.try_lock_within(users, alice, lock_mode::exclusive));
+  CHECK(!h.try_lock_within(users, alice, lock_mode::shared));
+  // other readers conflict on the rows only
+  CHECK(h.try_lock(bob, lock_mode::shared));
+  CHECK(!h.try_lock(alice, lock_mode::shared));
+  CHECK(!h.try_lock(users, lock_mode::intention_exclusive));
+  CHECK(!h.try_lock(users, lock_mode::shared));
+  h.unlock_within(users, alice, lock_mode::exclusive);
+  h.unlock(bob, lock_mode::shared);
+  h.unlock(users, lock_mode::shared_intention_exclusive);
+
+  CHECK(h.try_lock(db, lock_mode::exclusive));
+  CHECK(!h.try_lock(bob, lock_mode::intention_shared));
+  h.unlock(db, lock_mode::exclusive);
+  CHECK(h.try_lock(bob, lock_mode::intention_shared));
+}
+
+TEST_CASE("queue_per_node" * doctest::timeout(10.))
+{
+  io_context ctx;
+  lock_hierarchy h{ctx};
+  auto users  = h.add_node(h.root());
+  auto orders = h.add_node(h.root());
+  auto alice  = h.add_node(users);
+  auto bob    = h.add_node(users);
+  std::vector<int> order;
+
+  CHECK(h.try_lock(alice, lock_mode::exclusive));
+  // waits for alice at the table
+  h.async_lock(users, lock_mode::exclusive,
+               [&](error_code ec)
+               {
+                 CHECK(!ec);
+                 order.push_back(1);
+                 h.unlock(users, lock_mode::exclusive);
+               });
+  // queues up behind the table lock
+  h.async_lock(bob, lock_mode::shared,
+               [&](error_code ec)
+               {
+                 CHECK(!ec);
+                 order.push_back(2);
+                 h.unlock(bob, lock_mode::shared);
+               });
+  CHECK(!h.try_lock(bob, lock_mode::shared));
+  // another table isn't affected
+  h.async_lock(orders, lock_mode::exclusive,
+               [&](error_code ec)
+               {
+                 CHECK(!ec);
+                 order.push_back(3);
+                 h.unlock(orders, lock_mode::exclusive);
+               });
+  ctx.poll();
+  CHECK(order == std::vector<int>{3});
+
+  h.unlock(alice, lock_mode::exclusive);
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{3, 1, 2});
+}
+
+TEST_CASE("blocked_above" * doctest::timeout(10.))
+{
+  io_context ctx;
+  lock_hierarchy h{ctx};
+  auto users = h.add_node(h.root());
+  auto alice = h.add_node(users);
+  auto bob   = h.add_node(users);
+  std::vector<int> order;
+
+  h.lock(h.root(), lock_mode::shared);
+  h.lock(users, lock_mode::shared);
+  h.async_lock(alice, lock_mode::exclusive, [&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  h.async_lock(bob, lock_mode::shared, [&](error_code ec) { CHECK(!ec); order.push_back(2); });
+  ctx.poll();
+  CHECK(order == std::vector<int>{2});
+
+  // still blocked by the table
+  h.unlock(h.root(), lock_mode::shared);
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == std::vector<int>{2});
+
+  h.unlock(users, lock_mode::shared);
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == std::vector<int>{2, 1});
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context ctx;
+  lock_hierarchy h{ctx};
+  auto users = h.add_node(h.root());
+  auto alice = h.add_node(users);
+  cancellation_signal sig;
+  std::vector<error_code> ecs;
+
+  CHECK(h.try_lock(alice, lock_mode::shared));
+  h.async_lock(users, lock_mode::exclusive,
+               bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  // only blocked by the waiting exclusive lock
+  h.async_lock(alice, lock_mode::shared, [&](error_code ec) { ecs.push_back(ec); });
+  ctx.poll();
+  CHECK(ecs.empty());
+
+  net::post(ctx, [&] { sig.emit(cancellation_type::all); });
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 2u);
+  CHECK(ecs[0] == error::operation_aborted);
+  CHECK(!ecs[1]);
+
+  h.unlock(alice, lock_mode::shared);
+  h.unlock(alice, lock_mode::shared);
+  CHECK(h.try_lock(h.root(), lock_mode::exclusive));
+}
+
+TEST_CASE("sync_lock_mt" * doctest::timeout(10.))
+{
+  io_context ctx;
+  lock_hierarchy h{ctx};
+  std::vector<std::size_t> tables;
+  for (int i = 0; i < 2; i++)
+    tables.push_back(h.add_node(h.root()));
+  std::vector<std::size_t> rows;
+  for (int i = 0; i < 4; i++)
+    rows.push_back(h.add_node(tables[i % 2]));
+
+  std::vector<int> values(4, 0);
+  std::vector<std::thread> thrs;
+  for (int t = 0; t < 4; t++)
+    thrs.emplace_back(
+        [&, t]
+        {
+          for (int i = 0; i < 1000; i++)
+          {
+            if (i % 50 == 0)
+            {
+              // locks a whole table
+              auto tbl = tables[t % 2];
+              h.lock(tbl, lock_mode::exclusive);
+              for (std::size_t r = t % 2u; r < rows.size(); r += 2u)
+                values[r]++;
+              h.unlock(tbl, lock_mode::exclusive);
+            }
+            else
+            {
+              auto row = rows[(t + i) % rows.size()];
+              h.lock(row, lock_mode::exclusive);
+              values[(t + i) % rows.size()]++;
+              h.unlock(row, lock_mode::exclusive);
+            }
+          }
+        });
+
+  for (auto &t : thrs)
+    t.join();
+
+  int sum = 0;
+  for (auto v : values)
+    sum += v;
+  CHECK(sum == 4 * (980 + 20 * 2));
+}
+
+TEST_SUITE_END();
@@ -13,9 +13,12 @@
 #include <boost/sam/mutex.hpp>
 #include <algorithm>
 #include <chrono>
+#include <functional>
 #include <random>
 
 #include <thread>
+#include <memory>
+#include <vector>
 #include "doctest.h"
 
 
@@ -333,4 +336,144 @@ TEST_CASE("holds-work" * doctest::timeout(10.))
 
 
 
+TEST_CASE("yield" * doctest::timeout(10.))
+{
+  io_context ctx;
+  mutex mtx{ctx};
+  std::vector<int> order;
+
+  mtx.lock();
+  mtx.async_lock([&](error_code ec) { CHECK(!ec); order.push_back(1); mtx.unlock(); });
+  mtx.async_lock([&](error_code ec) { CHECK(!ec); order.push_back(2); mtx.unlock(); });
+  mtx.async_yield([&](error_code ec) { CHECK(!ec); order.push_back(3); mtx.unlock(); });
+  ctx.run();
+
+  CHECK(order == std::vector<int>{1, 2, 3});
+  CHECK(mtx.try_lock());
+}
+
+TEST_CASE("yield_no_waiters" * doctest::timeout(10.))
+{
+  io_context ctx;
+  mutex mtx{ctx};
+  bool done = false;
+
+  mtx.lock();
+  mtx.async_yield([&](error_code ec) { CHECK(!ec); done = true; });
+  ctx.run();
+
+  CHECK(done);
+  CHECK(!mtx.try_lock());
+}
+
+TEST_CASE("priority" * doctest::timeout(10.))
+{
+  io_context ctx;
+  mutex mtx{ctx};
+  std::vector<int> order;
+
+  mtx.lock();
+  mtx.async_lock([&](error_code ec) { CHECK(!ec); order.push_back(0); mtx.unlock(); });
+  mtx.async_lock(2u, [&](error_code ec) { CHECK(!ec); order.push_back(2); mtx.unlock(); });
+  mtx.async_lock(1u, [&](error_code ec) { CHECK(!ec); order.push_back(1); mtx.unlock(); });
+  mtx.async_lock(2u, [&](error_code ec) { CHECK(!ec); order.push_back(3); mtx.unlock(); });
+  mtx.unlock();
+  ctx.run();
+
+  CHECK(order == std::vector<int>{2, 3, 1, 0});
+  CHECK(mtx.try_lock());
+}
+
+TEST_CASE("priority_aging" * doctest::timeout(10.))
+{
+  io_context ctx;
+  mutex mtx{ctx};
+  std::vector<int> order;
+  int high = 0;
+
+  // every high priority waiter enqueues another one, so without aging the low one would run last.
+  std::function<void(error_code)> on_high =
+      [&](error_code ec)
+      {
+        CHECK(!ec);
+        order.push_back(1);
+        if (++high < 5)
+          mtx.async_lock(1u, on_high);
+        mtx.unlock();
+      };
+
+  mtx.set_aging(1u);
+  mtx.lock();
+  mtx.async_lock([&](error_code ec) { CHECK(!ec); order.push_back(0); mtx.unlock(); });
+  mtx.async_lock(1u, on_high);
+  mtx.async_lock(1u, on_high);
+  mtx.unlock();
+  ctx.run();
+
+  CHECK(order == std::vector<int>{1, 1, 0, 1, 1, 1, 1});
+}
+
+TEST_CASE("lock_for" * doctest::timeout(10.))
+{
+  io_context ctx;
+  mutex mtx{ctx};
+  std::vector<error_code> ecs;
+
+  mtx.async_lock_for(std::chrono::milliseconds(10), [&](error_code ec) { ecs.push_back(ec); });
+  mtx.async_lock_for(std::chrono::milliseconds(10), [&](error_code ec) { ecs.push_back(ec); });
+  const auto start = std::chrono::steady_clock::now();
+  ctx.run();
+
+  CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(10));
+  REQUIRE(ecs.size() == 2u);
+  CHECK(!ecs[0]);
+  CHECK(ecs[1] == error::timed_out);
+  // the timed out op doesn't hold the lock
+  mtx.unlock();
+  CHECK(mtx.try_lock());
+}
+
+TEST_CASE("move_timed" * doctest::timeout(10.))
+{
+  io_context ctx;
+  std::vector<error_code> ecs;
+
+  std::unique_ptr<mutex> mtx{new mutex{ctx}};
+  mtx->lock();
+  mtx->async_lock_for(std::chrono::milliseconds(10), [&](error_code ec) { ecs.push_back(ec); });
+
+  // the timed waiter moves along, so it times out in the new mutex.
+  mutex moved{std::move(*mtx)};
+  mtx.reset();
+  ctx.run();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::timed_out);
+  CHECK(!moved.try_lock());
+  moved.unlock();
+  CHECK(moved.try_lock());
+}
+
+TEST_CASE("lock_until" * doctest::timeout(10.))
+{
+  io_context ctx;
+  mutex mtx{ctx};
+  std::vector<int> order;
+
+  mtx.lock();
+  mtx.async_lock_until(std::chrono::steady_clock::now() + std::chrono::seconds(5),
+                       [&](error_code ec) { CHECK(!ec); order.push_back(2); mtx.unlock(); });
+  mtx.async_lock_until(std::chrono::system_clock::now() + std::chrono::milliseconds(5),
+                       [&](error_code ec) { CHECK(ec == error::timed_out); order.push_back(1); });
+  net::post(ctx, [&] { order.push_back(0); });
+  ctx.run_for(std::chrono::milliseconds(50));
+  CHECK(order == std::vector<int>{0, 1});
+
+  // the lock gets handed over before the deadline, so the context runs out of work.
+  mtx.unlock();
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{0, 1, 2});
+  CHECK(mtx.try_lock());
+}
+
 TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,179 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/range_lock.hpp>
+#include <boost/sam/range_lock_guard.hpp>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_range_lock");
+
+TEST_CASE("overlap" * doctest::timeout(10.))
+{
+  io_context ctx;
+  range_lock rl{ctx};
+
+  CHECK(rl.try_lock(0, 100));
+  CHECK(rl.try_lock(100, 100));
+  CHECK(!rl.try_lock(99, 2));
+  CHECK(!rl.try_lock_shared(150, 1));
+  CHECK(rl.try_lock_shared(300, 100));
+  CHECK(rl.try_lock_shared(350, 100));
+  CHECK(!rl.try_lock(440, 20));
+  CHECK(rl.try_lock(450, 20));
+  // empty ranges don't overlap anything
+  CHECK(rl.try_lock(50, 0));
+  rl.unlock(50, 0);
+
+  rl.unlock(0, 100);
+  CHECK(rl.try_lock(99, 1));
+  rl.unlock(99, 1);
+  rl.unlock(100, 100);
+  rl.unlock_shared(300, 100);
+  rl.unlock_shared(350, 100);
+  rl.unlock(450, 20);
+  CHECK(rl.try_lock(0, 1000));
+  rl.unlock(0, 1000);
+}
+
+TEST_CASE("wake_overlapping" * doctest::timeout(10.))
+{
+  io_context ctx;
+  range_lock rl{ctx};
+  std::vector<int> order;
+
+  rl.lock(0, 10);
+  rl.lock(20, 10);
+  rl.async_lock(5, 20, [&](error_code ec) { CHECK(!ec); order.push_back(1); rl.unlock(5, 20); });
+  // overlaps the waiter, so it queues behind it
+  rl.async_lock_shared(12, 2, [&](error_code ec) { CHECK(!ec); order.push_back(2); rl.unlock_shared(12, 2); });
+  rl.async_lock(40, 10, [&](error_code ec) { CHECK(!ec); order.push_back(3); });
+  ctx.poll();
+  CHECK(order == std::vector<int>{3});
+
+  rl.unlock(0, 10);
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == std::vector<int>{3});
+
+  rl.unlock(20, 10);
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{3, 1, 2});
+  CHECK(!rl.try_lock(45, 1));
+}
+
+TEST_CASE("timeout_cancel" * doctest::timeout(10.))
+{
+  io_context ctx;
+  range_lock rl{ctx};
+  cancellation_signal sig;
+  std::vector<error_code> ecs;
+
+  rl.lock_shared(0, 10);
+  rl.async_lock_for(0, 10, std::chrono::milliseconds(10), [&](error_code ec) { ecs.push_back(ec); });
+  rl.async_lock(5, 10, bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  // blocked by the exclusive waiters only
+  rl.async_lock_shared_for(8, 1, std::chrono::seconds(10), [&](error_code ec) { ecs.push_back(ec); });
+  ctx.run_for(std::chrono::milliseconds(50));
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::timed_out);
+
+  net::post(ctx, [&] { sig.emit(cancellation_type::all); });
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 3u);
+  CHECK(ecs[1] == error::operation_aborted);
+  CHECK(!ecs[2]);
+  rl.unlock_shared(8, 1);
+  rl.unlock_shared(0, 10);
+  CHECK(rl.try_lock(0, 20));
+}
+
+TEST_CASE("guard" * doctest::timeout(10.))
+{
+  io_context ctx;
+  range_lock rl{ctx};
+  std::vector<int> order;
+
+  {
+    auto g = lock(rl, 0, 10);
+    CHECK(g.offset() == 0u);
+    CHECK(g.length() == 10u);
+    CHECK(!g.shared());
+    CHECK(!rl.try_lock_shared(5, 1));
+
+    async_lock_shared(rl, 5, 1,
+                      [&](error_code ec, range_lock_guard g2)
+                      {
+                        CHECK(!ec);
+                        CHECK(g2.shared());
+                        order.push_back(1);
+                      });
+    ctx.poll();
+    CHECK(order.empty());
+  }
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{1});
+
+  auto g = lock_shared(rl, 0, 10);
+  CHECK(rl.try_lock_shared(0, 10));
+  rl.unlock_shared(0, 10);
+  g = range_lock_guard();
+  CHECK(rl.try_lock(0, 10));
+}
+
+TEST_CASE("sync_lock_mt" * doctest::timeout(10.))
+{
+  io_context ctx;
+  range_lock rl{ctx};
+  std::vector<int> values(16, 0);
+
+  std::vector<std::thread> thrs;
+  for (int t = 0; t < 4; t++)
+    thrs.emplace_back(
+        [&, t]
+        {
+          for (int i = 0; i < 1000; i++)
+          {
+            // overlapping windows of four
+            const std::size_t off = (t * 3 + i) % 13;
+            auto              g   = lock(rl, off, 4);
+            for (std::size_t j = off; j < off + 4; j++)
+              values[j]++;
+          }
+        });
+
+  for (auto &t : thrs)
+    t.join();
+
+  int sum = 0;
+  for (auto v : values)
+    sum += v;
+  CHECK(sum == 4 * 1000 * 4);
+}
+
+TEST_SUITE_END();
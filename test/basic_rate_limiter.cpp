@@ -0,0 +1,109 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/rate_limiter.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_rate_limiter");
+
+TEST_CASE("burst" * doctest::timeout(10.))
+{
+  io_context   ctx;
+  rate_limiter rl{ctx, 1, std::chrono::hours(1), 5};
+
+  CHECK(rl.available() == 5);
+  CHECK(rl.try_acquire(3));
+  CHECK(rl.try_acquire());
+  CHECK(!rl.try_acquire(2));
+  CHECK(rl.try_acquire());
+  CHECK(rl.available() == 0);
+
+  error_code ec;
+  rl.acquire(6, ec);
+  CHECK(ec == error::invalid_argument);
+}
+
+TEST_CASE("refill" * doctest::timeout(10.))
+{
+  io_context       ctx;
+  // a token every 10ms
+  rate_limiter     rl{ctx, 100, std::chrono::seconds(1), 2};
+  std::vector<int> order;
+
+  const auto start = std::chrono::steady_clock::now();
+  CHECK(rl.try_acquire(2));
+  rl.async_acquire(2, [&](error_code ec) { CHECK(!ec); order.push_back(2); });
+  // FIFO, so it waits behind the larger one
+  rl.async_acquire([&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  CHECK(!rl.try_acquire());
+  ctx.run();
+
+  CHECK(order == std::vector<int>{2, 1});
+  CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(30));
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context              ctx;
+  rate_limiter            rl{ctx, 1, std::chrono::milliseconds(20), 10};
+  cancellation_signal     sig;
+  std::vector<error_code> ecs;
+
+  CHECK(rl.try_acquire(9));
+  rl.async_acquire(10, bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  rl.async_acquire(1, [&](error_code ec) { ecs.push_back(ec); });
+  rl.async_acquire(11, [&](error_code ec) { ecs.push_back(ec); });
+  ctx.poll();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::invalid_argument);
+
+  // the waiter behind the cancelled one has its token already
+  net::post(ctx, [&] { sig.emit(cancellation_type::all); });
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 3u);
+  CHECK(ecs[1] == error::operation_aborted);
+  CHECK(!ecs[2]);
+}
+
+TEST_CASE("sync_acquire_mt" * doctest::timeout(10.))
+{
+  io_context   ctx;
+  rate_limiter rl{ctx, 1, std::chrono::milliseconds(5), 1};
+  auto         work = net::make_work_guard(ctx);
+  std::thread  thr{[&] { ctx.run(); }};
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 5; i++)
+    rl.acquire();
+  CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+
+  work.reset();
+  thr.join();
+}
+
+TEST_SUITE_END();
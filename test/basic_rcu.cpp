@@ -0,0 +1,206 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/rcu.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_rcu");
+
+TEST_CASE("read_publish" * doctest::timeout(10.))
+{
+  io_context ctx;
+  rcu<std::string> r{ctx, "first"};
+
+  auto g = r.read();
+  CHECK(*g == "first");
+  CHECK(g->size() == 5u);
+
+  r.publish("second");
+  CHECK(*g == "first");
+  CHECK(*r.read() == "second");
+
+  g = r.read();
+  CHECK(*g == "second");
+}
+
+TEST_CASE("synchronize" * doctest::timeout(10.))
+{
+  io_context ctx;
+  rcu<std::shared_ptr<int>> r{ctx, std::make_shared<int>(1)};
+  std::weak_ptr<int> old = *r.read();
+
+  r.publish(std::make_shared<int>(2));
+  // no reader, so the snapshot is gone right away.
+  CHECK(old.expired());
+
+  bool done = false;
+  r.async_synchronize([&](error_code ec) { CHECK(!ec); done = true; });
+  ctx.run();
+  CHECK(done);
+
+  r.synchronize();
+}
+
+TEST_CASE("wait_for_readers" * doctest::timeout(10.))
+{
+  io_context ctx;
+  rcu<std::shared_ptr<int>> r{ctx, std::make_shared<int>(1)};
+  std::vector<int> order;
+
+  auto g = r.read();
+  std::weak_ptr<int> old = *g;
+  r.async_synchronize([&](error_code ec) { CHECK(!ec); order.push_back(1); });
+
+  // a reader that starts after the grace period doesn't hold it up.
+  auto g2 = r.read();
+  CHECK(**g2 == 1);
+
+  // arrived during the grace period, so needs to wait for the next one, which g2 holds up.
+  r.publish(std::make_shared<int>(2));
+  r.async_synchronize([&](error_code ec) { CHECK(!ec); order.push_back(2); });
+  ctx.poll();
+  CHECK(order.empty());
+
+  g = rcu_read_guard<std::shared_ptr<int>>();
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == std::vector<int>{1});
+  // g2 might still see the old snapshot.
+  CHECK(!old.expired());
+
+  g2 = rcu_read_guard<std::shared_ptr<int>>();
+  CHECK(old.expired());
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{1, 2});
+}
+
+TEST_CASE("leave_during_grace" * doctest::timeout(10.))
+{
+  io_context ctx;
+  rcu<int> r{ctx, 1};
+  std::vector<int> order;
+
+  auto g = r.read();
+  r.async_synchronize([&](error_code ec) { CHECK(!ec); order.push_back(1); });
+
+  // the readers of the new epoch come & go without ending the grace period.
+  for (int i = 0; i < 3; i++)
+    CHECK(*r.read() == 1);
+  ctx.poll();
+  CHECK(order.empty());
+
+  // the last reader of the old epoch ends it.
+  g = rcu_read_guard<int>();
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{1});
+}
+
+TEST_CASE("publish_reclaims" * doctest::timeout(10.))
+{
+  io_context ctx;
+  rcu<std::shared_ptr<int>> r{ctx, std::make_shared<int>(1)};
+
+  std::weak_ptr<int> first, second;
+  {
+    auto g = r.read();
+    first  = *g;
+    r.publish(std::make_shared<int>(2));
+    second = *r.read();
+    // retired while the grace period started by the first publish runs.
+    r.publish(std::make_shared<int>(3));
+    CHECK(!first.expired());
+    CHECK(!second.expired());
+  }
+  // the last reader leaving ends the grace periods, without anyone synchronizing.
+  CHECK(first.expired());
+  CHECK(second.expired());
+  CHECK(**r.read() == 3);
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context ctx;
+  rcu<int> r{ctx};
+  cancellation_signal sig;
+  std::vector<error_code> ecs;
+
+  auto g = r.read();
+  r.async_synchronize(bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  net::post(ctx, [&] { sig.emit(cancellation_type::all); });
+  ctx.run();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::operation_aborted);
+
+  // the grace period still ends with the reader.
+  g = rcu_read_guard<int>();
+  r.async_synchronize([&](error_code ec) { ecs.push_back(ec); });
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 2u);
+  CHECK(!ecs[1]);
+}
+
+TEST_CASE("sync_mt" * doctest::timeout(10.))
+{
+  io_context ctx;
+  rcu<std::vector<int>> r{ctx, std::vector<int>(16, 0)};
+  std::atomic<bool> done{false};
+  std::atomic<bool> torn{false};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 3; i++)
+    readers.emplace_back(
+        [&]
+        {
+          while (!done)
+          {
+            auto g = r.read();
+            for (auto v : *g)
+              if (v != g->front())
+                torn = true;
+          }
+        });
+
+  for (int i = 1; i <= 1000; i++)
+  {
+    r.publish(std::vector<int>(16, i));
+    if (i % 10 == 0)
+      r.synchronize();
+  }
+  done = true;
+  for (auto &t : readers)
+    t.join();
+
+  CHECK(!torn);
+  CHECK(r.read()->front() == 1000);
+}
+
+TEST_SUITE_END();
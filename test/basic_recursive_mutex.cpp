@@ -0,0 +1,130 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/recursive_mutex.hpp>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_recursive_mutex");
+
+TEST_CASE("reenter" * doctest::timeout(10.))
+{
+  io_context ctx;
+  recursive_mutex mtx{ctx};
+  int a, b;
+  std::vector<int> order;
+
+  mtx.async_lock(&a, [&](error_code ec)
+                 {
+                   CHECK(!ec);
+                   order.push_back(0);
+                   // the owner gets back in right away, while the other one needs to wait for both unlocks.
+                   mtx.async_lock(&a, [&](error_code ec)
+                                  {
+                                    CHECK(!ec);
+                                    order.push_back(1);
+                                    mtx.unlock();
+                                    net::post(ctx, [&] { order.push_back(2); mtx.unlock(); });
+                                  });
+                 });
+  mtx.async_lock(&b, [&](error_code ec) { CHECK(!ec); order.push_back(3); mtx.unlock(); });
+  ctx.run();
+
+  CHECK(order == std::vector<int>{0, 1, 2, 3});
+  CHECK(mtx.try_lock(&b));
+  CHECK(!mtx.try_lock(&a));
+  mtx.unlock();
+}
+
+TEST_CASE("handover" * doctest::timeout(10.))
+{
+  io_context ctx;
+  recursive_mutex mtx{ctx};
+  int a, b;
+  std::vector<int> order;
+
+  CHECK(mtx.try_lock(&a));
+  CHECK(mtx.try_lock(&a));
+  mtx.async_lock(&b, [&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  mtx.unlock();
+  ctx.poll();
+  CHECK(order.empty());
+
+  mtx.unlock();
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{1});
+
+  // the lock was handed to b, so b can re-enter it.
+  CHECK(!mtx.try_lock(&a));
+  CHECK(mtx.try_lock(&b));
+  mtx.unlock();
+  mtx.unlock();
+  CHECK(mtx.try_lock(&a));
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context ctx;
+  recursive_mutex mtx{ctx};
+  int a, b, c;
+  std::vector<int> order;
+  cancellation_signal sig;
+
+  mtx.lock(&a);
+  mtx.async_lock(&b, bind_cancellation_slot(sig.slot(), [&](error_code ec)
+                                            {
+                                              CHECK(ec == error::operation_aborted);
+                                              order.push_back(0);
+                                            }));
+  mtx.async_lock(&c, [&](error_code ec) { CHECK(!ec); order.push_back(1); mtx.unlock(); });
+  sig.emit(cancellation_type::all);
+  mtx.unlock();
+  ctx.run();
+
+  CHECK(order == std::vector<int>{0, 1});
+  CHECK(mtx.try_lock(&b));
+}
+
+TEST_CASE("sync_lock_mt" * doctest::timeout(10.))
+{
+  io_context ctx;
+  recursive_mutex mtx{ctx};
+  int a, b;
+
+  mtx.lock(&a);
+  mtx.lock(&a);
+  std::thread thr{[&]
+                  {
+                    mtx.lock(&b);
+                    mtx.unlock();
+                  }};
+  mtx.unlock();
+  mtx.unlock();
+  thr.join();
+  CHECK(mtx.try_lock(&a));
+}
+
+TEST_SUITE_END();
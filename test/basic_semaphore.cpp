@@ -20,8 +20,10 @@
 #include <boost/sam/semaphore.hpp>
 #include <algorithm>
 #include <chrono>
+#include <memory>
 #include <random>
 #include <thread>
+#include <vector>
 
 #include "doctest.h"
 #include <iostream>
@@ -29,6 +31,7 @@
 #if defined(BOOST_SAM_STANDALONE)
 #include <asio/append.hpp>
 #include <asio/as_tuple.hpp>
+#include <asio/bind_cancellation_slot.hpp>
 #include <asio/coroutine.hpp>
 #include <asio/deferred.hpp>
 #include <asio/detached.hpp>
@@ -43,6 +46,7 @@
 #include <boost/asio/deferred.hpp>
 #include <boost/asio/detached.hpp>
 #include <boost/asio/as_tuple.hpp>
+#include <boost/asio/bind_cancellation_slot.hpp>
 #include <boost/asio/experimental/parallel_group.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/thread_pool.hpp>
@@ -234,6 +238,50 @@ TEST_CASE("sync_acquire_mt" * doctest::timeout(10.))
   thr.join();
 }
 
+TEST_CASE("weighted_mt" * doctest::timeout(10.))
+{
+  net::thread_pool  ctx{2};
+  semaphore         sem{ctx, 3};
+  std::atomic<int>  inside{0}, most{0}, async_done{0};
+
+  auto enter = [&](int n)
+  {
+    const int v = inside += n;
+    int       m = most.load();
+    while (v > m && !most.compare_exchange_weak(m, v))
+      ;
+    inside -= n;
+    sem.release(n);
+  };
+
+  // uncontended acquires never lock, so mix them with waiters
+  for (int i = 0; i < 200; i++)
+    sem.async_acquire_n(1 + i % 3, [&, i](error_code ec) { CHECK(!ec); enter(1 + i % 3); async_done++; });
+
+  std::vector<std::thread> thrs;
+  for (int t = 0; t < 2; t++)
+    thrs.emplace_back(
+        [&, t]
+        {
+          for (int i = 0; i < 500; i++)
+          {
+            const int n = 1 + (i + t) % 2;
+            if (!sem.try_acquire(n))
+              sem.acquire(n);
+            enter(n);
+          }
+        });
+
+  for (auto &t : thrs)
+    t.join();
+  while (async_done < 200)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ctx.join();
+
+  CHECK(most.load() <= 3);
+  CHECK(sem.value() == 3);
+}
+
 TEST_CASE_TEMPLATE("cancel_acquire" * doctest::timeout(10.), T, net::io_context, net::thread_pool)
 {
   io_context ctx{init<T>()};
@@ -306,4 +354,391 @@ TEST_CASE("mt_shutdown" * doctest::timeout(10.))
   CHECK(wp.expired());
 }
 
+TEST_CASE("priority_acquire" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 0};
+  std::vector<int> order;
+
+  sem.async_acquire([&](error_code ec) { CHECK(!ec); order.push_back(0); });
+  sem.async_acquire(3u, [&](error_code ec) { CHECK(!ec); order.push_back(3); });
+  sem.async_acquire(1u, [&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  // clamped to the highest priority
+  sem.async_acquire(100u, [&](error_code ec) { CHECK(!ec); order.push_back(7); });
+  CHECK(sem.value() == -4);
+
+  for (int i = 0; i < 4; i++)
+    sem.release();
+  ctx.run();
+
+  CHECK(order == std::vector<int>{7, 3, 1, 0});
+  CHECK(sem.value() == 0);
+}
+
+TEST_CASE("priority_aging" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 0};
+  std::vector<int> order;
+
+  sem.set_aging(2u);
+  sem.async_acquire([&](error_code ec) { CHECK(!ec); order.push_back(0); });
+  for (int i = 0; i < 3; i++)
+    sem.async_acquire(1u, [&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  // two get handed out at once, which counts as two wakeups & moves the low priority waiter up.
+  sem.release(2);
+  sem.async_acquire(1u, [&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  for (int i = 0; i < 3; i++)
+    sem.release();
+  ctx.run();
+
+  CHECK(order == std::vector<int>{1, 1, 1, 0, 1});
+}
+
+TEST_CASE("priority_cancel" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 0};
+  net::cancellation_signal csig;
+  std::vector<int> order;
+
+  sem.async_acquire(2u, net::bind_cancellation_slot(csig.slot(),
+                                                   [&](error_code ec)
+                                                   {
+                                                     CHECK(ec == net::error::operation_aborted);
+                                                     order.push_back(2);
+                                                   }));
+  sem.async_acquire(1u, [&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  csig.emit(net::cancellation_type::all);
+  sem.release();
+  ctx.run();
+
+  CHECK(order == std::vector<int>{2, 1});
+}
+
+TEST_CASE("acquire_for" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 1};
+  std::vector<error_code> ecs;
+
+  sem.async_acquire_for(std::chrono::milliseconds(10), [&](error_code ec) { ecs.push_back(ec); });
+  sem.async_acquire_for(std::chrono::milliseconds(10), [&](error_code ec) { ecs.push_back(ec); });
+  sem.async_acquire_until(std::chrono::steady_clock::now() + std::chrono::seconds(5),
+                          [&](error_code ec) { ecs.push_back(ec); });
+  net::post(ctx, [&] { ecs.push_back(error::in_progress); });
+  ctx.run_for(std::chrono::milliseconds(50));
+
+  REQUIRE(ecs.size() == 3u);
+  CHECK(!ecs[0]);
+  CHECK(ecs[1] == error::in_progress);
+  CHECK(ecs[2] == error::timed_out);
+  // only the last waiter still waits for a permit.
+  CHECK(sem.value() == -1);
+
+  // the timed out op didn't take a count, so this goes to the last waiter
+  sem.release();
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 4u);
+  CHECK(!ecs[3]);
+  CHECK(sem.value() == 0);
+}
+
+TEST_CASE("move_timed" * doctest::timeout(10.))
+{
+  io_context ctx;
+  std::vector<error_code> ecs;
+
+  std::unique_ptr<semaphore> sem{new semaphore{ctx, 0}};
+  sem->async_acquire_for(std::chrono::milliseconds(20), [&](error_code ec) { ecs.push_back(ec); });
+  sem->async_acquire_until(std::chrono::steady_clock::now() + std::chrono::seconds(5),
+                           [&](error_code ec) { ecs.push_back(ec); });
+
+  // the timed waiters move along, so they time out in the new semaphore.
+  semaphore moved{std::move(*sem)};
+  sem.reset();
+  ctx.run_for(std::chrono::milliseconds(50));
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::timed_out);
+  CHECK(moved.value() == -1);
+
+  // the waiters of the semaphore assigned to get swapped out & cancelled along with the old one.
+  std::unique_ptr<semaphore> src{new semaphore{ctx, 0}};
+  src->async_acquire_for(std::chrono::milliseconds(20), [&](error_code ec) { ecs.push_back(ec); });
+  moved = std::move(*src);
+  src.reset();
+  ctx.restart();
+  ctx.run_for(std::chrono::milliseconds(50));
+  REQUIRE(ecs.size() == 3u);
+  CHECK(ecs[1] == error::operation_aborted);
+  CHECK(ecs[2] == error::timed_out);
+  CHECK(moved.value() == 0);
+}
+
+TEST_CASE("weighted" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 10};
+  std::vector<int> order;
+
+  CHECK(sem.try_acquire(6));
+  CHECK(!sem.try_acquire(5));
+  sem.async_acquire_n(8, [&](error_code ec) { CHECK(!ec); order.push_back(8); });
+  sem.async_acquire_n(2, [&](error_code ec) { CHECK(!ec); order.push_back(2); });
+  sem.async_acquire_n(3, [&](error_code ec) { CHECK(!ec); order.push_back(3); });
+  ctx.poll();
+  // the 2 fit right away, the 3 doesn't
+  CHECK(order == std::vector<int>{2});
+  CHECK(sem.value() == 2 - 11);
+
+  // the 3 overtakes the 8, which doesn't fit yet
+  sem.release(3);
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == std::vector<int>{2, 3});
+  CHECK(sem.value() == 2 - 8);
+
+  sem.release(6);
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{2, 3, 8});
+  CHECK(sem.value() == 0);
+
+  // one pass wakes up every waiter that fits
+  sem.async_acquire_n(2, [&](error_code ec) { CHECK(!ec); order.push_back(2); });
+  sem.async_acquire_n(3, [&](error_code ec) { CHECK(!ec); order.push_back(3); });
+  sem.async_acquire([&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  sem.release(7);
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{2, 3, 8, 2, 3, 1});
+  CHECK(sem.value() == 1);
+}
+
+TEST_CASE("strict_fifo" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 4};
+  net::cancellation_signal csig;
+  std::vector<int> order;
+
+  sem.set_strict_fifo(true);
+  sem.async_acquire_n(6, net::bind_cancellation_slot(csig.slot(),
+                                                      [&](error_code ec)
+                                                      {
+                                                        CHECK(ec == net::error::operation_aborted);
+                                                        order.push_back(6);
+                                                      }));
+  sem.async_acquire_n(2, [&](error_code ec) { CHECK(!ec); order.push_back(2); });
+  sem.async_acquire([&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  CHECK(!sem.try_acquire());
+  ctx.poll();
+  CHECK(order.empty());
+
+  // the ones behind get in once the large waiter is gone
+  csig.emit(net::cancellation_type::all);
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{6, 2, 1});
+  CHECK(sem.value() == 1);
+}
+
+TEST_CASE("acquire_up_to" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 3};
+  std::vector<int> taken;
+
+  sem.async_acquire_up_to(5, [&](error_code ec, int n) { CHECK(!ec); taken.push_back(n); });
+  ctx.run();
+  CHECK(taken == std::vector<int>{3});
+
+  sem.async_acquire_up_to(5, [&](error_code ec, int n) { CHECK(!ec); taken.push_back(n); });
+  ctx.restart();
+  ctx.poll();
+  CHECK(taken.size() == 1u);
+
+  sem.release(2);
+  ctx.restart();
+  ctx.run();
+  CHECK(taken == std::vector<int>{3, 2});
+  CHECK(sem.value() == 0);
+}
+
+TEST_CASE("max_queue_length" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 1};
+  std::vector<error_code> ecs;
+
+  sem.set_max_queue_length(2u);
+  CHECK(sem.try_acquire());
+  for (int i = 0; i < 3; i++)
+    sem.async_acquire([&](error_code ec) { ecs.push_back(ec); });
+  ctx.poll();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::try_again);
+
+  sem.release();
+  sem.release();
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 3u);
+  CHECK(!ecs[1]);
+  CHECK(!ecs[2]);
+}
+
+TEST_CASE("queue_delay_target" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 1};
+  std::vector<std::pair<int, error_code>> res;
+
+  sem.set_queue_delay_target(std::chrono::milliseconds(1), std::chrono::milliseconds(5));
+  CHECK(sem.try_acquire());
+  for (int i = 0; i < 4; i++)
+    sem.async_acquire([&res, i](error_code ec) { res.emplace_back(i, ec); });
+
+  // above the target, but not for an interval yet
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  sem.release();
+  ctx.poll();
+  REQUIRE(res.size() == 1u);
+  CHECK(res[0] == std::make_pair(0, error_code()));
+
+  // now the head gets dropped & its permit goes to the next waiter
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  sem.release();
+  ctx.restart();
+  ctx.poll();
+  REQUIRE(res.size() == 3u);
+  CHECK(res[1] == std::make_pair(1, error_code(error::try_again)));
+  CHECK(res[2] == std::make_pair(2, error_code()));
+
+  // a deadline closer than the queue delay can't be met
+  sem.async_acquire_for(std::chrono::milliseconds(1), [&](error_code ec) { res.emplace_back(4, ec); });
+  sem.async_acquire_for(std::chrono::seconds(5), [&](error_code ec) { res.emplace_back(5, ec); });
+  ctx.restart();
+  ctx.poll();
+  REQUIRE(res.size() == 4u);
+  CHECK(res[3] == std::make_pair(4, error_code(error::try_again)));
+
+  sem.release();
+  sem.release();
+  ctx.restart();
+  ctx.run();
+  REQUIRE(res.size() == 6u);
+  CHECK(res[4].first == 3);
+  CHECK(res[5].first == 5);
+}
+
+TEST_CASE("queue_delay_deadline" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 1};
+  std::vector<std::pair<int, error_code>> res;
+
+  sem.set_queue_delay_target(std::chrono::milliseconds(1), std::chrono::seconds(1));
+  CHECK(sem.try_acquire());
+  sem.async_acquire([&](error_code ec) { res.emplace_back(0, ec); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // there's no queue delay known yet, so both get enqueued.
+  sem.async_acquire_for(std::chrono::milliseconds(20), [&](error_code ec) { res.emplace_back(1, ec); });
+  sem.async_acquire_for(std::chrono::seconds(5), [&](error_code ec) { res.emplace_back(2, ec); });
+  CHECK(sem.value() == -3);
+
+  // the first waiter waited for 50ms, which the second one can't make anymore.
+  sem.release();
+  ctx.poll();
+  REQUIRE(res.size() == 2u);
+  CHECK(res[0] == std::make_pair(0, error_code()));
+  CHECK(res[1] == std::make_pair(1, error_code(error::try_again)));
+  CHECK(sem.value() == -1);
+
+  sem.release();
+  ctx.restart();
+  ctx.run();
+  REQUIRE(res.size() == 3u);
+  CHECK(res[2] == std::make_pair(2, error_code()));
+}
+
+TEST_CASE("lease_expiry" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 1};
+  semaphore_lease lease;
+  std::vector<error_code> ecs;
+
+  sem.async_acquire_lease(std::chrono::milliseconds(10),
+                          [&](error_code ec, semaphore_lease l)
+                          {
+                            ecs.push_back(ec);
+                            lease = std::move(l);
+                          });
+  sem.async_acquire([&](error_code ec) { ecs.push_back(ec); });
+  ctx.poll();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(!ecs[0]);
+  CHECK(lease.active());
+  CHECK(sem.leases() == 1u);
+
+  // the holder got stuck, so the permit goes to the waiter
+  ctx.restart();
+  ctx.run_for(std::chrono::milliseconds(50));
+  REQUIRE(ecs.size() == 2u);
+  CHECK(!ecs[1]);
+  CHECK(!lease.active());
+  CHECK(sem.leases() == 0u);
+
+  // the late release gets ignored
+  CHECK(!lease.release());
+  CHECK(sem.value() == 0);
+  sem.release();
+  CHECK(sem.value() == 1);
+}
+
+TEST_CASE("lease_renew" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 1};
+  int done = 0;
+
+  auto lease = sem.acquire_lease(std::chrono::milliseconds(200));
+  CHECK(sem.value() == 0);
+  sem.async_acquire([&](error_code ec) { CHECK(!ec); done++; });
+
+  for (int i = 0; i < 3; i++)
+  {
+    ctx.run_for(std::chrono::milliseconds(100));
+    CHECK(lease.renew(std::chrono::milliseconds(200)));
+  }
+  CHECK(done == 0);
+
+  CHECK(lease.release());
+  CHECK(!lease.active());
+  ctx.restart();
+  ctx.run();
+  CHECK(done == 1);
+  CHECK(sem.leases() == 0u);
+}
+
+TEST_CASE("lease_destroy" * doctest::timeout(10.))
+{
+  io_context ctx;
+  semaphore sem{ctx, 2};
+
+  {
+    auto l1 = sem.acquire_lease(std::chrono::seconds(10));
+    auto l2 = sem.acquire_lease(std::chrono::seconds(20));
+    CHECK(sem.value() == 0);
+    CHECK(sem.leases() == 2u);
+  }
+  CHECK(sem.value() == 2);
+  CHECK(sem.leases() == 0u);
+  // no timer keeps the context busy
+  ctx.run();
+}
+
 TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,182 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/lock_guard.hpp>
+#include <boost/sam/seqlock.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+namespace
+{
+struct route
+{
+  int  id;
+  char name[13];
+  long hops;
+};
+}
+
+TEST_SUITE_BEGIN("basic_seqlock");
+
+TEST_CASE("load_store" * doctest::timeout(10.))
+{
+  io_context ctx;
+  seqlock<route> sl{ctx, route{1, "first", 2}};
+
+  std::uint64_t version = 42u;
+  auto r = sl.load(version);
+  CHECK(version == 0u);
+  CHECK(r.id == 1);
+  CHECK(std::string(r.name) == "first");
+  CHECK(r.hops == 2);
+
+  CHECK(sl.try_lock());
+  CHECK(!sl.try_lock());
+  sl.store(route{2, "second", 3});
+  sl.unlock();
+
+  r = sl.load(version);
+  CHECK(version == 1u);
+  CHECK(sl.version() == 1u);
+  CHECK(r.id == 2);
+  CHECK(std::string(r.name) == "second");
+}
+
+TEST_CASE("async_lock" * doctest::timeout(10.))
+{
+  io_context ctx;
+  seqlock<int> sl{ctx};
+  std::vector<int> order;
+
+  auto l = lock(sl);
+  async_lock(sl,
+             [&](error_code ec, lock_guard l)
+             {
+               CHECK(!ec);
+               sl.store(sl.load() + 1);
+               order.push_back(1);
+             });
+  sl.async_lock(
+      [&](error_code ec)
+      {
+        CHECK(!ec);
+        sl.store(sl.load() * 10);
+        order.push_back(2);
+        sl.unlock();
+      });
+  ctx.poll();
+  CHECK(order.empty());
+
+  sl.store(4);
+  l = lock_guard();
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{1, 2});
+  CHECK(sl.load() == 50);
+  CHECK(sl.version() == 3u);
+}
+
+TEST_CASE("wait_for_version" * doctest::timeout(10.))
+{
+  io_context ctx;
+  seqlock<int> sl{ctx, 1};
+  std::vector<int> seen;
+
+  std::uint64_t v;
+  sl.load(v);
+  sl.async_wait_for_version(v, [&](error_code ec) { CHECK(!ec); seen.push_back(sl.load()); });
+  sl.async_wait_for_version(v + 1u, [&](error_code ec) { CHECK(!ec); seen.push_back(sl.load() * 10); });
+  ctx.poll();
+  CHECK(seen.empty());
+
+  sl.lock();
+  sl.store(2);
+  ctx.restart();
+  ctx.poll();
+  CHECK(seen == std::vector<int>{2});
+
+  sl.store(3);
+  sl.unlock();
+  ctx.restart();
+  ctx.run();
+  CHECK(seen == std::vector<int>{2, 30});
+
+  // an older version completes right away.
+  sl.async_wait_for_version(v, [&](error_code ec) { CHECK(!ec); seen.push_back(0); });
+  ctx.restart();
+  ctx.run();
+  CHECK(seen == std::vector<int>{2, 30, 0});
+}
+
+TEST_CASE("cancel_wait" * doctest::timeout(10.))
+{
+  io_context ctx;
+  seqlock<int> sl{ctx};
+  cancellation_signal sig;
+  std::vector<error_code> ecs;
+
+  sl.async_wait_for_version(0u, bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  net::post(ctx, [&] { sig.emit(cancellation_type::all); });
+  ctx.run();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::operation_aborted);
+}
+
+TEST_CASE("sync_mt" * doctest::timeout(10.))
+{
+  io_context ctx;
+  seqlock<route> sl{ctx};
+  std::atomic<bool> done{false};
+  bool torn = false;
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 3; i++)
+    readers.emplace_back(
+        [&]
+        {
+          while (!done)
+          {
+            auto r = sl.load();
+            if (r.id != r.hops)
+              torn = true;
+          }
+        });
+
+  for (int i = 0; i < 10000; i++)
+  {
+    sl.lock();
+    sl.store(route{i, "", i});
+    sl.unlock();
+  }
+  done = true;
+  for (auto &t : readers)
+    t.join();
+
+  CHECK(!torn);
+  CHECK(sl.version() == 10000u);
+}
+
+TEST_SUITE_END();
@@ -10,7 +10,9 @@
 #endif
 
 #include <boost/sam/lock_guard.hpp>
+#include <boost/sam/shared_lock_guard.hpp>
 #include <boost/sam/shared_mutex.hpp>
+#include <boost/sam/upgrade_lock_guard.hpp>
 #include <algorithm>
 #include <chrono>
 #include <random>
@@ -555,4 +557,234 @@ TEST_CASE_TEMPLATE("cancel_shared" * doctest::timeout(10.), T, io_context, threa
   CHECK(7u == std::count(ecs.begin(), ecs.end(), error::operation_aborted));
 }
 
+TEST_CASE("yield_to_shared" * doctest::timeout(10.))
+{
+  io_context ctx;
+  shared_mutex mtx{ctx};
+  std::vector<int> order;
+
+  mtx.lock();
+  mtx.async_lock_shared([&](error_code ec) { CHECK(!ec); order.push_back(1); mtx.unlock_shared(); });
+  mtx.async_lock_shared([&](error_code ec) { CHECK(!ec); order.push_back(2); mtx.unlock_shared(); });
+  mtx.async_yield([&](error_code ec) { CHECK(!ec); order.push_back(3); mtx.unlock(); });
+  ctx.run();
+
+  CHECK(order == std::vector<int>{1, 2, 3});
+  CHECK(mtx.try_lock());
+}
+
+TEST_CASE("relock_shared" * doctest::timeout(10.))
+{
+  io_context ctx;
+  shared_mutex mtx{ctx};
+  std::vector<int> order;
+
+  mtx.lock_shared();
+  mtx.async_relock_shared([&](error_code ec) { CHECK(!ec); order.push_back(0); mtx.unlock_shared(); });
+  mtx.async_lock([&](error_code ec) { CHECK(!ec); order.push_back(1); mtx.unlock(); });
+  mtx.async_relock_shared([&](error_code ec) { CHECK(!ec); order.push_back(2); mtx.unlock_shared(); });
+  ctx.run();
+
+  CHECK(order == std::vector<int>{0, 1, 2});
+  CHECK(mtx.try_lock());
+}
+
+TEST_CASE("relock_shared_cancel_writer" * doctest::timeout(10.))
+{
+  io_context ctx;
+  shared_mutex mtx{ctx};
+  net::cancellation_signal csig;
+  std::vector<error_code> ecs;
+
+  mtx.lock_shared();
+  mtx.lock_shared();
+  mtx.async_lock(net::bind_cancellation_slot(csig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  mtx.async_relock_shared([&](error_code ec) { ecs.push_back(ec); mtx.unlock_shared(); });
+  net::post(ctx, [&] { csig.emit(net::cancellation_type::all); });
+  ctx.run();
+
+  REQUIRE(ecs.size() == 2u);
+  CHECK(ecs[0] == net::error::operation_aborted);
+  CHECK(!ecs[1]);
+  mtx.unlock_shared();
+  CHECK(mtx.try_lock());
+}
+
+TEST_CASE("lock_for" * doctest::timeout(10.))
+{
+  io_context ctx;
+  shared_mutex mtx{ctx};
+  std::vector<int> order;
+
+  mtx.lock();
+  mtx.async_lock_for(std::chrono::milliseconds(5),
+                     [&](error_code ec) { CHECK(ec == error::timed_out); order.push_back(0); });
+  mtx.async_lock_shared_for(std::chrono::seconds(5), [&](error_code ec) { CHECK(!ec); order.push_back(1); });
+  ctx.run_for(std::chrono::milliseconds(50));
+  CHECK(order == std::vector<int>{0});
+
+  // the timed out writer doesn't get the lock handed over.
+  mtx.unlock();
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{0, 1});
+  mtx.unlock_shared();
+  CHECK(mtx.try_lock());
+}
+
+TEST_CASE("lock_shared_until" * doctest::timeout(10.))
+{
+  io_context ctx;
+  shared_mutex mtx{ctx};
+  std::vector<error_code> ecs;
+
+  mtx.lock();
+  mtx.async_lock_shared_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(5),
+                              [&](error_code ec) { ecs.push_back(ec); });
+  mtx.async_lock_until(std::chrono::steady_clock::now() + std::chrono::seconds(5),
+                       [&](error_code ec) { ecs.push_back(ec); });
+  ctx.run_for(std::chrono::milliseconds(50));
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::timed_out);
+
+  mtx.unlock();
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 2u);
+  CHECK(!ecs[1]);
+  mtx.unlock();
+  CHECK(mtx.try_lock_shared());
+}
+
+TEST_CASE("policy" * doctest::timeout(10.))
+{
+  auto run = [](shared_mutex_policy policy)
+  {
+    io_context ctx;
+    shared_mutex mtx{ctx, policy};
+    std::vector<int> order;
+
+    mtx.lock_shared();
+    mtx.async_lock([&](error_code ec) { CHECK(!ec); order.push_back(1); mtx.unlock(); });
+    mtx.async_lock_shared([&](error_code ec) { CHECK(!ec); order.push_back(2); mtx.unlock_shared(); });
+    mtx.async_lock([&](error_code ec) { CHECK(!ec); order.push_back(3); mtx.unlock(); });
+    net::post(ctx, [&] { order.push_back(0); mtx.unlock_shared(); });
+    ctx.run();
+    CHECK(mtx.try_lock());
+    return order;
+  };
+
+  // the reader overtakes both writers.
+  CHECK(run(shared_mutex_policy::reader_preferring) == std::vector<int>{2, 0, 1, 3});
+  // the reader waits for all writers.
+  CHECK(run(shared_mutex_policy::writer_preferring) == std::vector<int>{0, 1, 3, 2});
+  // the reader waits for the first writer, but goes before the second one.
+  CHECK(run(shared_mutex_policy::phase_fair) == std::vector<int>{0, 1, 2, 3});
+}
+
+TEST_CASE("upgrade" * doctest::timeout(10.))
+{
+  io_context ctx;
+  shared_mutex mtx{ctx};
+  std::vector<int> order;
+
+  mtx.lock_shared();
+  CHECK(mtx.try_lock_upgrade());
+  // readers coexist with the upgrader, while other upgraders & writers wait.
+  CHECK(mtx.try_lock_shared());
+  CHECK(!mtx.try_lock_upgrade());
+  CHECK(!mtx.try_lock());
+  mtx.unlock_shared();
+
+  mtx.async_lock_upgrade([&](error_code ec) { CHECK(!ec); order.push_back(3); mtx.unlock_upgrade(); });
+  mtx.async_upgrade([&](error_code ec) { CHECK(!ec); order.push_back(1); mtx.unlock(); });
+  // the pending upgrade holds back new readers.
+  mtx.async_lock_shared([&](error_code ec) { CHECK(!ec); order.push_back(2); mtx.unlock_shared(); });
+  CHECK(!mtx.try_lock_shared());
+  net::post(ctx, [&] { order.push_back(0); mtx.unlock_shared(); });
+  ctx.run();
+
+  CHECK(order == std::vector<int>{0, 1, 2, 3});
+  CHECK(mtx.try_lock());
+}
+
+TEST_CASE("upgrade_cancel" * doctest::timeout(10.))
+{
+  io_context ctx;
+  shared_mutex mtx{ctx};
+  net::cancellation_signal csig;
+  std::vector<error_code> ecs;
+
+  mtx.lock_shared();
+  mtx.lock_upgrade();
+  mtx.async_upgrade(net::bind_cancellation_slot(csig.slot(), [&](error_code ec) { ecs.push_back(ec); }));
+  mtx.async_lock_shared([&](error_code ec) { ecs.push_back(ec); mtx.unlock_shared(); });
+  net::post(ctx, [&] { csig.emit(net::cancellation_type::all); });
+  ctx.run();
+
+  // the upgrade lock is still held, so the reader gets in, but no writer.
+  REQUIRE(ecs.size() == 2u);
+  CHECK(ecs[0] == net::error::operation_aborted);
+  CHECK(!ecs[1]);
+  mtx.unlock_shared();
+  CHECK(!mtx.try_lock());
+  CHECK(mtx.try_upgrade());
+  mtx.unlock();
+  CHECK(mtx.try_lock_upgrade());
+}
+
+TEST_CASE("upgrade_lock_guard" * doctest::timeout(10.))
+{
+  io_context ctx;
+  shared_mutex mtx{ctx};
+  bool done = false;
+
+  auto g = lock_upgrade(mtx);
+  mtx.lock_shared();
+  async_upgrade(mtx, g,
+                [&](error_code ec, lock_guard l)
+                {
+                  CHECK(!ec);
+                  CHECK(!mtx.try_lock_upgrade());
+                  done = true;
+                });
+  ctx.poll();
+  CHECK(!done);
+  mtx.unlock_shared();
+  ctx.restart();
+  ctx.run();
+  CHECK(done);
+  CHECK(mtx.try_lock_upgrade());
+  mtx.unlock_upgrade();
+
+  async_lock_upgrade(mtx, [&](error_code ec, upgrade_lock_guard l) { CHECK(!ec); CHECK(mtx.try_lock_shared()); mtx.unlock_shared(); });
+  ctx.restart();
+  ctx.run();
+  CHECK(mtx.try_lock());
+}
+
+TEST_CASE("downgrade" * doctest::timeout(10.))
+{
+  io_context ctx;
+  shared_mutex mtx{ctx, shared_mutex_policy::writer_preferring};
+  std::vector<int> order;
+
+  auto l = lock(mtx);
+  mtx.async_lock([&](error_code ec) { CHECK(!ec); order.push_back(2); mtx.unlock(); });
+  mtx.async_lock_shared([&](error_code ec) { CHECK(!ec); order.push_back(0); mtx.unlock_shared(); });
+  {
+    // the queued reader gets in despite the waiting writer, which waits for both.
+    auto sl = downgrade(mtx, std::move(l));
+    ctx.poll();
+    CHECK(order == std::vector<int>{0});
+    CHECK(!mtx.try_lock());
+    order.push_back(1);
+  }
+  ctx.restart();
+  ctx.run();
+
+  CHECK(order == std::vector<int>{0, 1, 2});
+  CHECK(mtx.try_lock());
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,151 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/striped_mutex.hpp>
+#include <thread>
+#include <vector>
+#include "doctest.h"
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#endif
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+TEST_SUITE_BEGIN("basic_striped_mutex");
+
+// a hash that maps to the given stripe.
+template <std::size_t N>
+std::size_t hash_for(std::size_t stripe)
+{
+  std::size_t h = 0u;
+  while (striped_mutex<N>::stripe_of(h) != stripe)
+    h++;
+  return h;
+}
+
+TEST_CASE("stripes" * doctest::timeout(10.))
+{
+  io_context        ctx;
+  striped_mutex<16> sm{ctx};
+
+  const auto a = hash_for<16>(3u), b = hash_for<16>(7u);
+  CHECK(sm.try_lock(a));
+  CHECK(!sm.try_lock(a));
+  CHECK(sm.try_lock(b));
+
+  std::vector<int> order;
+  sm.async_lock(a, [&](error_code ec) { CHECK(!ec); order.push_back(1); sm.unlock(a); });
+  sm.async_lock(a, [&](error_code ec) { CHECK(!ec); order.push_back(2); sm.unlock(a); });
+  ctx.poll();
+  CHECK(order.empty());
+
+  sm.unlock(a);
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{1, 2});
+  CHECK(!sm.try_lock(b));
+  sm.unlock(b);
+  CHECK(sm.try_lock(a));
+  sm.unlock(a);
+}
+
+TEST_CASE("lock_all" * doctest::timeout(10.))
+{
+  io_context       ctx;
+  striped_mutex<8> sm{ctx};
+
+  const auto a = hash_for<8>(1u), b = hash_for<8>(2u), c = hash_for<8>(5u);
+  std::vector<int> order;
+
+  sm.lock(b);
+  // holds a, waits for b. The duplicate stripe only gets locked once
+  sm.async_lock_all([&](error_code ec) { CHECK(!ec); order.push_back(1); }, c, a, b, a);
+  sm.async_lock(a, [&](error_code ec) { CHECK(!ec); order.push_back(2); sm.unlock(a); });
+  ctx.poll();
+  CHECK(order.empty());
+
+  sm.unlock(b);
+  ctx.restart();
+  ctx.poll();
+  CHECK(order == std::vector<int>{1});
+  CHECK(!sm.try_lock(c));
+
+  sm.unlock_all(a, b, c, a);
+  ctx.restart();
+  ctx.run();
+  CHECK(order == std::vector<int>{1, 2});
+  CHECK(sm.try_lock(b));
+  CHECK(sm.try_lock(c));
+}
+
+TEST_CASE("cancel" * doctest::timeout(10.))
+{
+  io_context              ctx;
+  striped_mutex<8>        sm{ctx};
+  cancellation_signal     sig;
+  std::vector<error_code> ecs;
+
+  const auto a = hash_for<8>(1u), b = hash_for<8>(2u);
+  sm.lock(b);
+  sm.async_lock_all(bind_cancellation_slot(sig.slot(), [&](error_code ec) { ecs.push_back(ec); }), b, a);
+  ctx.poll();
+  CHECK(ecs.empty());
+  CHECK(!sm.try_lock(a));
+
+  sig.emit(cancellation_type::all);
+  ctx.restart();
+  ctx.run();
+  REQUIRE(ecs.size() == 1u);
+  CHECK(ecs[0] == error::operation_aborted);
+  // nothing is held after an error
+  CHECK(sm.try_lock(a));
+  sm.unlock(a);
+  sm.unlock(b);
+}
+
+TEST_CASE("sync_lock_mt" * doctest::timeout(10.))
+{
+  io_context       ctx;
+  striped_mutex<4> sm{ctx};
+  std::vector<int> values(32, 0);
+
+  std::vector<std::thread> thrs;
+  for (int t = 0; t < 4; t++)
+    thrs.emplace_back(
+        [&, t]
+        {
+          for (int i = 0; i < 1000; i++)
+          {
+            const std::size_t key = (t * 7 + i) % 32;
+            sm.lock(key);
+            values[key]++;
+            sm.unlock(key);
+          }
+        });
+
+  for (auto &t : thrs)
+    t.join();
+
+  int sum = 0;
+  for (auto v : values)
+    sum += v;
+  CHECK(sum == 4 * 1000);
+}
+
+TEST_SUITE_END();
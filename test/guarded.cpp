@@ -9,6 +9,7 @@
 #define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
 #endif
 
+#include <boost/sam/adaptive_limiter.hpp>
 #include <boost/sam/guarded.hpp>
 #include <boost/sam/mutex.hpp>
 #include <boost/sam/semaphore.hpp>
@@ -123,6 +124,17 @@ TEST_CASE_TEMPLATE("guarded_semaphore_test" * doctest::timeout(10.), T, net::io_
   run_impl(ctx);
 }
 
+TEST_CASE_TEMPLATE("guarded_adaptive_limiter_test" * doctest::timeout(10.), T, net::io_context, net::thread_pool)
+{
+  T                ctx;
+  adaptive_limiter al{ctx.get_executor(), 3, 1, 3};
+  cmp = 3;
+  std::vector<int> order;
+  test_sync<adaptive_limiter>(al, order);
+  run_impl(ctx);
+  CHECK(al.in_flight() == 0);
+}
+
 TEST_CASE_TEMPLATE("guarded_mutex_test" * doctest::timeout(10.), T, net::io_context, net::thread_pool)
 {
   T                ctx;
@@ -0,0 +1,151 @@
+// Copyright (c) 2023 Klemens D. Morgenstern
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(BOOST_SAM_STANDALONE)
+#define ASIO_DISABLE_BOOST_DATE_TIME 1
+#else
+#define BOOST_ASIO_DISABLE_BOOST_DATE_TIME 1
+#endif
+
+#include <boost/sam/lock_all.hpp>
+#include <boost/sam/mutex.hpp>
+#include <boost/sam/semaphore.hpp>
+#include <boost/sam/shared_mutex.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#if !defined(BOOST_SAM_STANDALONE)
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#else
+#include <asio/bind_cancellation_slot.hpp>
+#include <asio/post.hpp>
+#include <asio/thread_pool.hpp>
+#endif
+
+#include "doctest.h"
+
+using namespace BOOST_SAM_NAMESPACE;
+using namespace net;
+
+inline void run_impl(io_context &ctx) { ctx.run(); }
+inline void run_impl(thread_pool &ctx) { ctx.join(); }
+
+TEST_SUITE_BEGIN("lock_all");
+
+TEST_CASE("lock_all_free" * doctest::timeout(10.))
+{
+  io_context ctx;
+  mutex m1{ctx}, m2{ctx};
+  shared_mutex sm{ctx};
+  semaphore sem{ctx, 2};
+  bool done = false;
+
+  async_lock_all([&](error_code ec) { CHECK(!ec); done = true; }, m1, m2, sm, sem);
+  ctx.run();
+
+  CHECK(done);
+  CHECK(!m1.try_lock());
+  CHECK(!m2.try_lock());
+  CHECK(!sm.try_lock_shared());
+  CHECK(sem.value() == 1);
+}
+
+TEST_CASE("lock_all_wait" * doctest::timeout(10.))
+{
+  io_context ctx;
+  mutex m1{ctx}, m2{ctx};
+  semaphore sem{ctx, 1};
+  bool done = false;
+
+  m2.lock();
+  async_lock_all([&](error_code ec) { CHECK(!ec); done = true; }, m1, m2, sem);
+  ctx.run_for(std::chrono::milliseconds(10));
+
+  // nothing is held while waiting
+  CHECK(!done);
+  CHECK(m1.try_lock());
+  m1.unlock();
+  CHECK(sem.value() == 1);
+
+  m2.unlock();
+  ctx.restart();
+  ctx.run();
+  CHECK(done);
+  CHECK(!m1.try_lock());
+  CHECK(!m2.try_lock());
+  CHECK(!sem.try_acquire());
+}
+
+TEST_CASE("lock_all_cancel" * doctest::timeout(10.))
+{
+  io_context ctx;
+  mutex m1{ctx}, m2{ctx};
+  cancellation_signal csig;
+  error_code res;
+
+  m1.lock();
+  async_lock_all(bind_cancellation_slot(csig.slot(), [&](error_code ec) { res = ec; }), m1, m2);
+  post(ctx, [&] { csig.emit(cancellation_type::all); });
+  ctx.run();
+
+  CHECK(res == error::operation_aborted);
+  CHECK(m2.try_lock());
+}
+
+TEST_CASE("guard_all" * doctest::timeout(10.))
+{
+  io_context ctx;
+  mutex m1{ctx};
+  semaphore sem{ctx, 1};
+  bool done = false;
+
+  async_guard_all(
+      [&](error_code ec, multi_lock_guard<mutex, semaphore> guard)
+      {
+        CHECK(!ec);
+        CHECK(!m1.try_lock());
+        CHECK(sem.value() == 0);
+        done = true;
+      },
+      m1, sem);
+  ctx.run();
+
+  CHECK(done);
+  CHECK(m1.try_lock());
+  CHECK(sem.value() == 1);
+}
+
+TEST_CASE_TEMPLATE("lock_all_opposite_order" * doctest::timeout(10.), T, io_context, thread_pool)
+{
+  T ctx;
+  mutex a{ctx}, b{ctx};
+  std::atomic<int> done{0};
+  std::atomic<bool> held{false};
+
+  for (int i = 0; i < 100; i++)
+  {
+    auto res = [&](error_code ec)
+    {
+      CHECK(!ec);
+      CHECK(!held.exchange(true));
+      held = false;
+      done++;
+      a.unlock();
+      b.unlock();
+    };
+    if (i % 2)
+      async_lock_all(res, a, b);
+    else
+      async_lock_all(res, b, a);
+  }
+  run_impl(ctx);
+  CHECK(done == 100);
+}
+
+TEST_SUITE_END();